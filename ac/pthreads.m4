@@ -0,0 +1,40 @@
+dnl
+dnl Check how to compile and link programs that use std::thread
+dnl
+
+AC_CACHE_CHECK([for the compiler flag for POSIX threads], [ax_cv_pthread_flag],[
+  ax_cv_pthread_flag=none
+
+  CXXFLAGS_SAVED=$CXXFLAGS
+  LDFLAGS_SAVED=$LDFLAGS
+
+  AC_LANG_PUSH(C++)
+  for flag in -pthread -pthreads ; do
+    CXXFLAGS="$CXXFLAGS_SAVED $STD_CXX0X $flag"
+    LDFLAGS="$LDFLAGS_SAVED $flag"
+    export CXXFLAGS LDFLAGS
+
+    AC_TRY_LINK(
+      [#include <thread>],
+      [std::thread thread([]() {}); thread.join();],
+      [ax_cv_pthread_flag=$flag])
+
+    if test x"$ax_cv_pthread_flag" != xnone; then
+      break
+    fi
+  done
+  AC_LANG_POP
+
+  CXXFLAGS="$CXXFLAGS_SAVED"
+  LDFLAGS="$LDFLAGS_SAVED"
+])
+
+PTHREAD_CFLAGS=""
+PTHREAD_LIBS=""
+if test x"$ax_cv_pthread_flag" != xnone; then
+  PTHREAD_CFLAGS="$ax_cv_pthread_flag"
+  PTHREAD_LIBS="$ax_cv_pthread_flag"
+fi
+
+AC_SUBST(PTHREAD_CFLAGS)
+AC_SUBST(PTHREAD_LIBS)
@@ -1,6 +1,6 @@
 #!/usr/bin/env ruby
 
-gtest_apps = %w{common propedit}
+gtest_apps = %w{common merge propedit}
 
 namespace :tests do
   desc "Build the unit tests"
@@ -21,6 +21,7 @@ $build_system_modules[:gtest] = {
   :define_tasks => lambda do
     gtest_libs = {
       'common'   => [],
+      'merge'    => [ :mtxmerge, :mtxinput, :mtxoutput, :mtxmerge, :avi, :rmff, :mpegparser, :flac, :vorbis, :ogg ],
       'propedit' => [ :mtxpropedit ],
     }
 
@@ -18,8 +18,10 @@
 
 #include "common/bit_cursor.h"
 #include "common/aac.h"
+#include "common/endian.h"
 #include "common/matroska.h"
 #include "common/strings/formatting.h"
+#include "common/sync_word.h"
 
 const int g_aac_sampling_freq[16] = {96000, 88200, 64000, 48000, 44100, 32000,
                                      24000, 22050, 16000, 12000, 11025,  8000,
@@ -337,6 +339,12 @@ find_aac_header(const unsigned char *buf,
   try {
     int bpos = 0;
     while (bpos < size) {
+      // Sync word 0xfff followed by the two layer bits which must be 0
+      int candidate = mtx::sync_word::find_16(buf + bpos, size - bpos, 0xfff0, 0xfff6);
+      if (0 > candidate)
+        break;
+
+      bpos += candidate;
       if (is_adts_header(buf + bpos, size - bpos, aac_header, emphasis_present))
         return bpos;
       bpos++;
@@ -457,7 +465,8 @@ find_consecutive_aac_headers(const unsigned char *buf,
     int offset = aac_header.bytes;
     int i;
     for (i = 0; (num - 1) > i; ++i) {
-      if ((size - base - offset) < 2)
+      if (   ((size - base - offset) < 2)
+          || ((get_uint16_be(&buf[base + offset]) & 0xfff6) != 0xfff0))
         break;
 
       pos = find_aac_header(&buf[base + offset], size - base - offset, &new_header, false);
@@ -21,6 +21,7 @@
 #include "common/byte_buffer.h"
 #include "common/checksums.h"
 #include "common/endian.h"
+#include "common/sync_word.h"
 
 ac3::frame_c::frame_c() {
   init();
@@ -196,9 +197,18 @@ ac3::frame_c::find_in(memory_cptr const &buffer) {
 int
 ac3::frame_c::find_in(unsigned char const *buffer,
                       size_t buffer_size) {
-  for (size_t offset = 0; offset < buffer_size; ++offset)
+  size_t offset = 0;
+  while (offset < buffer_size) {
+    int candidate = mtx::sync_word::find_16(&buffer[offset], buffer_size - offset, AC3_SYNC_WORD);
+    if (0 > candidate)
+      break;
+
+    offset += candidate;
     if (decode_header(&buffer[offset], buffer_size - offset))
       return offset;
+    ++offset;
+  }
+
   return -1;
 }
 
@@ -302,8 +312,11 @@ ac3::parser_c::parse(bool end_of_stream) {
     ac3::frame_c frame;
 
     if (!frame.decode_header(&buffer[position], buffer_size - position)) {
-      ++position;
-      ++m_garbage_size;
+      int candidate  = mtx::sync_word::find_16(&buffer[position + 1], buffer_size - position - 1, AC3_SYNC_WORD);
+      size_t skipped = 0 > candidate ? buffer_size - position - 1 : candidate + 1;
+
+      position       += skipped;
+      m_garbage_size += skipped;
       continue;
     }
 
@@ -349,8 +362,9 @@ ac3::parser_c::find_consecutive_frames(unsigned char const *buffer,
     size_t position = base;
 
     ac3::frame_c first_frame;
-    while (((position + 8) < buffer_size) && !first_frame.decode_header(&buffer[position], buffer_size - position))
-      ++position;
+    int candidate = first_frame.find_in(&buffer[base], buffer_size - base);
+    if (0 <= candidate)
+      position += candidate;
 
     mxdebug_if(debug, boost::format("First frame at %1% valid %2%\n") % position % first_frame.m_valid);
 
@@ -18,6 +18,16 @@
 
 #include "common/memory.h"
 
+// A FIFO of bytes whose content is always available as one contiguous
+// block (get_buffer()).
+//
+// Removing data from the front only advances an offset. The remaining
+// data is moved to the front of the allocation only when new data
+// doesn't fit behind it anymore. The allocation always grows to at
+// least twice the amount of data needed afterwards. Therefore each
+// byte is moved a constant number of times on average, no matter how
+// much data is buffered or how small the pieces are in which it is
+// removed.
 class byte_buffer_c {
 private:
   unsigned char *m_data;
@@ -41,31 +51,12 @@ public:
   }
 
   void trim() {
-    if (m_offset == 0)
-      return;
-
-    memmove(m_data, &m_data[m_offset], m_filled);
-
-    m_offset        = 0;
-    size_t new_size = (m_filled / m_chunk_size + 1) * m_chunk_size;
-
-    if (new_size != m_size) {
-      m_data = saferealloc(m_data, new_size);
-      m_size = new_size;
-
-      count_alloc(new_size);
-    }
+    compact(0);
   }
 
   void add(const unsigned char *new_data, int new_size) {
-    if ((m_offset != 0) && ((m_offset + m_filled + new_size) >= m_chunk_size))
-      trim();
-
-    if ((m_offset + m_filled + new_size) > m_size) {
-      m_size = ((m_offset + m_filled + new_size) / m_chunk_size + 1) * m_chunk_size;
-      m_data = saferealloc(m_data, m_size);
-      count_alloc(m_size);
-    }
+    if ((m_offset + m_filled + new_size) > m_size)
+      compact(new_size);
 
     memcpy(&m_data[m_offset + m_filled], new_data, new_size);
     m_filled += new_size;
@@ -75,19 +66,37 @@ public:
     add(new_buffer->get_buffer(), new_buffer->get_size());
   }
 
+  // Returns room for up to 'num' bytes behind the filled part so that
+  // data can be read into the buffer directly. The bytes actually
+  // written there become part of the content with commit().
+  unsigned char *reserve(size_t num) {
+    if ((m_offset + m_filled + num) > m_size)
+      compact(num);
+
+    return &m_data[m_offset + m_filled];
+  }
+
+  void commit(size_t num) {
+    if ((m_offset + m_filled + num) > m_size)
+      mxerror("byte_buffer_c: commit() beyond reserved space. Should not have happened. Please file a bug report.\n");
+
+    m_filled += num;
+  }
+
   void remove(size_t num) {
     if (num > m_filled)
       mxerror("byte_buffer_c: num > m_filled. Should not have happened. Please file a bug report.\n");
+
     m_offset += num;
     m_filled -= num;
 
-    if (m_filled >= m_chunk_size)
-      trim();
+    if (!m_filled)
+      m_offset = 0;
   }
 
   void clear() {
-    if (m_filled)
-      remove(m_filled);
+    m_filled = 0;
+    m_offset = 0;
   }
 
   unsigned char *get_buffer() {
@@ -104,6 +113,27 @@ public:
   }
 
 private:
+  // Moves the filled part to the start of the allocation and resizes
+  // the allocation so that at least 'additional' more bytes fit.
+  void compact(size_t additional) {
+    if (m_offset) {
+      memmove(m_data, &m_data[m_offset], m_filled);
+      m_offset = 0;
+    }
+
+    size_t needed   = m_filled + additional;
+    size_t new_size = m_size;
+
+    if (((2 * needed) > m_size) || ((4 * needed) < m_size))
+      new_size = (2 * needed / m_chunk_size + 1) * m_chunk_size;
+
+    if (new_size != m_size) {
+      m_data = saferealloc(m_data, new_size);
+      m_size = new_size;
+
+      count_alloc(new_size);
+    }
+  }
 
   void count_alloc(size_t filled) {
     ++m_num_reallocs;
@@ -18,8 +18,13 @@
 
 #include "common/bswap.h"
 #include "common/checksums.h"
+#include "common/cpu_kernels.h"
 #include "common/endian.h"
 
+#if defined(MTX_CPU_X86)
+# include <emmintrin.h>
+#endif
+
 #define BASE 65521
 #define A0 check += *buffer++; sum2 += check;
 #define A1 A0 A0
@@ -29,11 +34,13 @@
 #define A5 A4 A4
 #define A6 A5 A5
 
-uint32_t
-calc_adler32(const unsigned char *buffer,
-             int size) {
+namespace mtx { namespace checksums {
+
+static uint32_t
+adler32_scalar(unsigned char const *buffer,
+               size_t size) {
   register uint32_t sum2, check;
-  register int k;
+  register size_t k;
 
   check = 1;
   k = size;
@@ -56,6 +63,82 @@ calc_adler32(const unsigned char *buffer,
   return check;
 }
 
+#if defined(MTX_CPU_X86)
+
+static inline MTX_TARGET("sse2") uint32_t
+sum_epi32(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+// Processes 16 bytes per iteration. Like the scalar version the two
+// sums are only reduced modulo BASE at the very end and wrap around at
+// 2^32 before that, so both produce identical results for any size.
+//
+// For a block of 16 bytes b0..b15 starting with the running sums
+// (check, sum2):
+//   check' = check + (b0 + ... + b15)
+//   sum2'  = sum2  + 16 * check + (16 * b0 + 15 * b1 + ... + 1 * b15)
+static MTX_TARGET("sse2") uint32_t
+adler32_sse2(unsigned char const *buffer,
+             size_t size) {
+  uint32_t check      = 1, sum2 = 0;
+  size_t num_blocks   = size / 16;
+
+  if (num_blocks) {
+    __m128i const zero       = _mm_setzero_si128();
+    __m128i const weights_lo = _mm_set_epi16( 9, 10, 11, 12, 13, 14, 15, 16);
+    __m128i const weights_hi = _mm_set_epi16( 1,  2,  3,  4,  5,  6,  7,  8);
+    __m128i v_check          = zero; // sum of all bytes so far
+    __m128i v_prefix         = zero; // sum of v_check at the start of each block
+    __m128i v_sum2           = zero; // sum of the weighted bytes of each block
+
+    for (size_t idx = 0; idx < num_blocks; ++idx) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(buffer));
+
+      v_prefix = _mm_add_epi32(v_prefix, v_check);
+      v_check  = _mm_add_epi32(v_check,  _mm_sad_epu8(bytes, zero));
+      v_sum2   = _mm_add_epi32(v_sum2,   _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weights_lo));
+      v_sum2   = _mm_add_epi32(v_sum2,   _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weights_hi));
+
+      buffer  += 16;
+    }
+
+    sum2  += static_cast<uint32_t>(num_blocks * 16) * check + 16 * sum_epi32(v_prefix) + sum_epi32(v_sum2);
+    check += sum_epi32(v_check);
+  }
+
+  for (size_t idx = size % 16; 0 < idx; --idx) {
+    check += *buffer++;
+    sum2  += check;
+  }
+
+  return (check % BASE) | ((sum2 % BASE) << 16);
+}
+
+#endif  // MTX_CPU_X86
+
+mtx::cpu::kernel_c<adler32_fn> const &
+adler32_kernel() {
+  static mtx::cpu::kernel_c<adler32_fn> s_kernel{"adler32", {
+    { "scalar", mtx::cpu::FEATURE_NONE, adler32_scalar },
+#if defined(MTX_CPU_X86)
+    { "sse2",   mtx::cpu::FEATURE_SSE2, adler32_sse2   },
+#endif
+  }};
+
+  return s_kernel;
+}
+
+}}
+
+uint32_t
+calc_adler32(const unsigned char *buffer,
+             int size) {
+  return mtx::checksums::adler32_kernel()(buffer, static_cast<size_t>(std::max(size, 0)));
+}
+
 /*
    The following code was taken from the ffmpeg project, files
    "libavutil/crc.h" and "libavutil/crc.c".
@@ -75,6 +158,10 @@ static struct {
   { 1, 32, 0xEDB88320 },
 };
 static uint32_t s_crc_table[CRC_MAX][257];
+
+// Tables for slicing-by-8: s_crc_slices[id][k][i] is the CRC of the byte
+// i followed by k zero bytes.
+static uint32_t s_crc_slices[CRC_MAX][8][256];
 #ifdef COMP_MSC
 #pragma warning(disable:4146)	//unary minus operator applied to unsigned type, result still unsigned
 #endif
@@ -119,18 +206,28 @@ crc_init(uint32_t *ctx,
 
 const uint32_t *
 crc_get_table(crc_type_e crc_id){
-  if (!s_crc_table[crc_id][256])
+  if (!s_crc_table[crc_id][256]) {
     if (crc_init(s_crc_table[crc_id], s_crc_table_params[crc_id].le, s_crc_table_params[crc_id].bits, s_crc_table_params[crc_id].poly, sizeof(s_crc_table[crc_id])) < 0)
       return nullptr;
 
+    auto &slices = s_crc_slices[crc_id];
+    std::copy(&s_crc_table[crc_id][0], &s_crc_table[crc_id][256], &slices[0][0]);
+
+    for (int k = 1; k < 8; ++k)
+      for (int i = 0; i < 256; ++i)
+        slices[k][i] = (slices[k - 1][i] >> 8) ^ slices[0][slices[k - 1][i] & 0xff];
+  }
+
   return s_crc_table[crc_id];
 }
 
+namespace mtx { namespace checksums {
+
 uint32_t
-crc_calc(const uint32_t *ctx,
-         uint32_t crc,
-         const unsigned char *buffer,
-         size_t length) {
+crc_bytewise(const uint32_t *ctx,
+             uint32_t crc,
+             const unsigned char *buffer,
+             size_t length) {
   const uint8_t *end = buffer + length;
 
   if (!ctx[256])
@@ -149,61 +246,53 @@ crc_calc(const uint32_t *ctx,
   return crc;
 }
 
-static const uint32_t crc_mpeg2_table[256] = {
-  0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
-  0x1a864db2, 0x1e475005, 0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
-  0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd, 0x4c11db70, 0x48d0c6c7,
-  0x4593e01e, 0x4152fda9, 0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
-  0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011, 0x791d4014, 0x7ddc5da3,
-  0x709f7b7a, 0x745e66cd, 0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
-  0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5, 0xbe2b5b58, 0xbaea46ef,
-  0xb7a96036, 0xb3687d81, 0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
-  0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49, 0xc7361b4c, 0xc3f706fb,
-  0xceb42022, 0xca753d95, 0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
-  0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d, 0x34867077, 0x30476dc0,
-  0x3d044b19, 0x39c556ae, 0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
-  0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16, 0x018aeb13, 0x054bf6a4,
-  0x0808d07d, 0x0cc9cdca, 0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
-  0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02, 0x5e9f46bf, 0x5a5e5b08,
-  0x571d7dd1, 0x53dc6066, 0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
-  0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e, 0xbfa1b04b, 0xbb60adfc,
-  0xb6238b25, 0xb2e29692, 0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
-  0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a, 0xe0b41de7, 0xe4750050,
-  0xe9362689, 0xedf73b3e, 0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
-  0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686, 0xd5b88683, 0xd1799b34,
-  0xdc3abded, 0xd8fba05a, 0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
-  0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb, 0x4f040d56, 0x4bc510e1,
-  0x46863638, 0x42472b8f, 0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
-  0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47, 0x36194d42, 0x32d850f5,
-  0x3f9b762c, 0x3b5a6b9b, 0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
-  0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623, 0xf12f560e, 0xf5ee4bb9,
-  0xf8ad6d60, 0xfc6c70d7, 0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
-  0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f, 0xc423cd6a, 0xc0e2d0dd,
-  0xcda1f604, 0xc960ebb3, 0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
-  0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b, 0x9b3660c6, 0x9ff77d71,
-  0x92b45ba8, 0x9675461f, 0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
-  0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640, 0x4e8ee645, 0x4a4ffbf2,
-  0x470cdd2b, 0x43cdc09c, 0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
-  0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24, 0x119b4be9, 0x155a565e,
-  0x18197087, 0x1cd86d30, 0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
-  0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088, 0x2497d08d, 0x2056cd3a,
-  0x2d15ebe3, 0x29d4f654, 0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
-  0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c, 0xe3a1cbc1, 0xe760d676,
-  0xea23f0af, 0xeee2ed18, 0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
-  0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0, 0x9abc8bd5, 0x9e7d9662,
-  0x933eb0bb, 0x97ffad0c, 0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
-  0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
-};
-
+// All tables (including the big endian ones, which are stored byte
+// swapped) use the same update step, so one kernel covers all CRC types.
 uint32_t
-crc_calc_mpeg2(unsigned char *data,
-               int len) {
-  register int i;
-  uint32_t crc = 0xffffffff;
+crc_slicing_by_8(crc_type_e crc_id,
+                 uint32_t crc,
+                 const unsigned char *buffer,
+                 size_t length) {
+  crc_get_table(crc_id);
+
+  auto const &t = s_crc_slices[crc_id];
 
-  for (i = 0; i < len; i++)
-    crc = (crc << 8) ^ crc_mpeg2_table[((crc >> 24) ^ *data++) & 0xff];
+  while (8 <= length) {
+    uint32_t one = get_uint32_le(buffer) ^ crc;
+    uint32_t two = get_uint32_le(buffer + 4);
+
+    crc =   t[7][ one        & 0xff] ^ t[6][(one >>  8) & 0xff]
+          ^ t[5][(one >> 16) & 0xff] ^ t[4][ one >> 24        ]
+          ^ t[3][ two        & 0xff] ^ t[2][(two >>  8) & 0xff]
+          ^ t[1][(two >> 16) & 0xff] ^ t[0][ two >> 24        ];
+
+    buffer += 8;
+    length -= 8;
+  }
+
+  while (length--)
+    crc = t[0][static_cast<uint8_t>(crc) ^ *buffer++] ^ (crc >> 8);
 
   return crc;
 }
 
+}}
+
+uint32_t
+crc_calc(const uint32_t *ctx,
+         uint32_t crc,
+         const unsigned char *buffer,
+         size_t length) {
+  for (int crc_id = 0; crc_id < CRC_MAX; ++crc_id)
+    if (ctx == s_crc_table[crc_id])
+      return mtx::checksums::crc_slicing_by_8(static_cast<crc_type_e>(crc_id), crc, buffer, length);
+
+  return mtx::checksums::crc_bytewise(ctx, crc, buffer, length);
+}
+
+// CRC-32/MPEG-2 is the big endian CRC_32_IEEE without a final XOR.
+uint32_t
+crc_calc_mpeg2(unsigned char *data,
+               int len) {
+  return bswap_32(crc_calc(crc_get_table(CRC_32_IEEE), 0xffffffff, data, std::max(len, 0)));
+}
@@ -32,4 +32,13 @@ const uint32_t * crc_get_table(crc_type_e crc_id);
 uint32_t crc_calc(const uint32_t *ctx, uint32_t start_crc, const unsigned char *buffer, size_t length);
 uint32_t crc_calc_mpeg2(unsigned char *data, int len);
 
+// The individual implementations behind calc_adler32() and crc_calc().
+// They're only exported for the unit tests and benchmarks.
+namespace mtx { namespace checksums {
+
+uint32_t crc_bytewise(uint32_t const *ctx, uint32_t crc, unsigned char const *buffer, size_t length);
+uint32_t crc_slicing_by_8(crc_type_e crc_id, uint32_t crc, unsigned char const *buffer, size_t length);
+
+}}
+
 #endif // MTX_COMMON_CHECKSUMS_H
@@ -76,6 +76,7 @@ cli_parser_c::option_t::format_text() {
 
 cli_parser_c::cli_parser_c(const std::vector<std::string> &args)
   : m_args(args)
+  , m_current_arg_idx(0)
 {
   m_hooks[cli_parser_c::ht_common_options_parsed] = std::vector<cli_parser_cb_t>();
   m_hooks[cli_parser_c::ht_unknown_option]        = std::vector<cli_parser_cb_t>();
@@ -91,9 +92,10 @@ cli_parser_c::parse_args() {
 
   std::vector<std::string>::const_iterator sit;
   mxforeach(sit, m_args) {
-    bool no_next_arg = (sit + 1) == m_args.end();
-    m_current_arg    = *sit;
-    m_next_arg       = no_next_arg ? "" : *(sit + 1);
+    bool no_next_arg  = (sit + 1) == m_args.end();
+    m_current_arg     = *sit;
+    m_next_arg        = no_next_arg ? "" : *(sit + 1);
+    m_current_arg_idx = sit - m_args.begin();
 
     std::map<std::string, cli_parser_c::option_t>::iterator option_it(m_option_map.find(m_current_arg));
     if (option_it != m_option_map.end()) {
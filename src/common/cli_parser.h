@@ -54,6 +54,7 @@ protected:
   std::vector<std::string> m_args;
 
   std::string m_current_arg, m_next_arg;
+  size_t m_current_arg_idx;
 
   std::map<hook_type_e, std::vector<cli_parser_cb_t>> m_hooks;
 
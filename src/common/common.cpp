@@ -147,6 +147,7 @@ static void
 mtx_common_cleanup() {
   random_c::cleanup();
   mm_file_io_c::cleanup();
+  show_memory_prepend_statistics();
 }
 
 void
@@ -29,6 +29,13 @@ header_removal_compressor_c::do_decompress(memory_cptr const &buffer) {
   if (!m_bytes || (0 == m_bytes->get_size()))
     return buffer;
 
+  // Nobody else references the buffer. If the headers were stripped
+  // by moving its offset then prepend() puts them back in place.
+  if (1 == buffer.use_count()) {
+    buffer->prepend(m_bytes);
+    return buffer;
+  }
+
   memory_cptr new_buffer = memory_c::alloc(buffer->get_size() + m_bytes->get_size());
 
   memcpy(new_buffer->get_buffer(),                       m_bytes->get_buffer(), m_bytes->get_size());
@@ -62,6 +69,13 @@ header_removal_compressor_c::do_compress(memory_cptr const &buffer) {
                                              "Wanted bytes:%1%; found:%2%.")) % b_bytes % b_buffer);
   }
 
+  // Nobody else references the buffer: strip the headers by moving its
+  // offset instead of copying the rest of the data.
+  if ((1 == buffer.use_count()) && buffer->is_unique()) {
+    buffer->set_offset(buffer->get_offset() + size);
+    return buffer;
+  }
+
   return memory_c::clone(buffer->get_buffer() + size, buffer->get_size() - size);
 }
 
@@ -69,30 +69,28 @@ zlib_compressor_c::do_compress(memory_cptr const &buffer) {
   c_stream.opaque = (voidpf)0;
   int result      = deflateInit(&c_stream, 9);
 
+  // This runs on mkvmerge's compression worker threads. Errors are
+  // therefore reported by throwing, and nothing is logged here.
   if (Z_OK != result)
-    mxerror(boost::format(Y("deflateInit() failed. Result: %1%\n")) % result);
+    throw mtx::compression_x(boost::format(Y("deflateInit() failed. Result: %1%\n")) % result);
+
+  // deflateBound() is large enough for deflate() to finish in a single
+  // call. This avoids growing the output buffer in small steps.
+  memory_cptr dst    = memory_c::alloc(deflateBound(&c_stream, buffer->get_size()));
 
   c_stream.next_in   = (Bytef *)buffer->get_buffer();
   c_stream.avail_in  = buffer->get_size();
-  int n              = 0;
-  memory_cptr dst    = memory_c::alloc(0);
-
-  do {
-    n++;
-    dst->resize(n * 4000);
-    c_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer() + (n - 1) * 4000);
-    c_stream.avail_out = 4000;
-    result             = deflate(&c_stream, Z_FINISH);
+  c_stream.next_out  = reinterpret_cast<Bytef *>(dst->get_buffer());
+  c_stream.avail_out = dst->get_size();
+  result             = deflate(&c_stream, Z_FINISH);
 
-    if ((Z_OK != result) && (Z_STREAM_END != result))
-      mxerror(boost::format(Y("Zlib decompression failed. Result: %1%\n")) % result);
-
-  } while ((c_stream.avail_out == 0) && (result != Z_STREAM_END));
+  if (Z_STREAM_END != result) {
+    deflateEnd(&c_stream);
+    throw mtx::compression_x(boost::format(Y("Zlib compression failed. Result: %1%\n")) % result);
+  }
 
   dst->resize(c_stream.total_out);
   deflateEnd(&c_stream);
 
-  mxverb(3, boost::format("zlib_compressor_c: Compression from %1% to %2%, %3%%%\n") % buffer->get_size() % dst->get_size() % (dst->get_size() * 100 / buffer->get_size()));
-
   return dst;
 }
@@ -0,0 +1,158 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time CPU feature detection and kernel dispatching
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <mutex>
+
+#include "common/cpu_features.h"
+#include "common/strings/editing.h"
+
+#if defined(MTX_CPU_X86)
+# include <cpuid.h>
+#endif
+
+namespace mtx { namespace cpu {
+
+static std::atomic<bool> s_scalar_forced{false};
+
+static std::mutex &
+registry_mutex() {
+  static std::mutex s_mutex;
+  return s_mutex;
+}
+
+static std::vector<kernel_base_c *> &
+registry() {
+  static std::vector<kernel_base_c *> s_kernels;
+  return s_kernels;
+}
+
+#if defined(MTX_CPU_X86)
+
+// The AVX registers are only usable if the operating system saves and
+// restores them on context switches. That's what the XCR0 register
+// tells us.
+static uint64_t
+read_xcr0() {
+  uint32_t eax, edx;
+  __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0)); // xgetbv
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+static unsigned int
+detect_features() {
+  unsigned int eax, ebx, ecx, edx, features = FEATURE_NONE;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return features;
+
+  if (edx & bit_SSE2)
+    features |= FEATURE_SSE2;
+  if (ecx & bit_SSSE3)
+    features |= FEATURE_SSSE3;
+  if (ecx & bit_SSE4_1)
+    features |= FEATURE_SSE4_1;
+
+  auto avx_enabled = (ecx & bit_OSXSAVE) && (ecx & bit_AVX) && (0x6 == (read_xcr0() & 0x6));
+  if (!avx_enabled || (7 > __get_cpuid_max(0, nullptr)))
+    return features;
+
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  if (ebx & bit_AVX2)
+    features |= FEATURE_AVX2;
+
+  return features;
+}
+
+#else  // MTX_CPU_X86
+
+static unsigned int
+detect_features() {
+  return FEATURE_NONE;
+}
+
+#endif  // MTX_CPU_X86
+
+unsigned int
+get_detected_features() {
+  static unsigned int s_features = detect_features();
+  return s_features;
+}
+
+unsigned int
+get_usable_features() {
+  return is_scalar_forced() ? static_cast<unsigned int>(FEATURE_NONE) : get_detected_features();
+}
+
+bool
+has(feature_e feature) {
+  return (get_usable_features() & feature) == static_cast<unsigned int>(feature);
+}
+
+std::string
+format_features(unsigned int features) {
+  static std::vector<std::pair<feature_e, std::string>> s_names{
+    { FEATURE_SSE2,   "sse2"   },
+    { FEATURE_SSSE3,  "ssse3"  },
+    { FEATURE_SSE4_1, "sse4.1" },
+    { FEATURE_AVX2,   "avx2"   },
+  };
+
+  std::vector<std::string> names;
+  for (auto &name : s_names)
+    if (features & name.first)
+      names.push_back(name.second);
+
+  return names.empty() ? std::string{"none"} : join(" ", names);
+}
+
+bool
+is_scalar_forced() {
+  return s_scalar_forced.load();
+}
+
+void
+force_scalar(bool forced) {
+  s_scalar_forced = forced;
+
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  for (auto kernel : registry())
+    kernel->select();
+}
+
+kernel_base_c::kernel_base_c(std::string const &name)
+  : m_name{name}
+{
+}
+
+kernel_base_c::~kernel_base_c() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  boost::remove_erase(registry(), this);
+}
+
+void
+kernel_base_c::add_to_registry() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  registry().push_back(this);
+}
+
+void
+kernel_base_c::log_selection(std::string const &implementation)
+  const {
+  static debugging_option_c s_debug{"cpu_features"};
+  mxdebug_if(s_debug, boost::format("kernel '%1%': using '%2%' (CPU features: %3%%4%)\n")
+             % m_name % implementation % format_features(get_detected_features()) % (is_scalar_forced() ? ", scalar forced" : ""));
+}
+
+}}
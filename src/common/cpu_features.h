@@ -0,0 +1,150 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time CPU feature detection and kernel dispatching
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_CPU_FEATURES_H
+#define MTX_COMMON_CPU_FEATURES_H
+
+#include "common/common_pch.h"
+
+#include <atomic>
+
+// Kernels for specific instruction sets are compiled with GCC's/clang's
+// target attribute instead of global -m flags. That way the rest of the
+// program keeps the baseline instruction set, and the same binary runs
+// on old and new x86 CPUs alike.
+// GCC only allows intrinsics in such functions from version 4.9 on.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+# define MTX_CPU_X86
+# define MTX_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace mtx { namespace cpu {
+
+enum feature_e {
+  FEATURE_NONE   = 0,
+  FEATURE_SSE2   = 1 << 0,
+  FEATURE_SSSE3  = 1 << 1,
+  FEATURE_SSE4_1 = 1 << 2,
+  FEATURE_AVX2   = 1 << 3,
+};
+
+// The features the CPU and the operating system support.
+unsigned int get_detected_features();
+// The features kernels may use: the detected ones unless only scalar
+// kernels are allowed.
+unsigned int get_usable_features();
+bool has(feature_e feature);
+std::string format_features(unsigned int features);
+
+// Restricts all kernels to their scalar reference implementations.
+// request_debugging() calls it whenever the debug options change, so
+// 'force_scalar_kernels' works both via the environment variable
+// MKVTOOLNIX_DEBUG and via '--debug'. Kernels that have already made
+// their choice select again.
+void force_scalar(bool forced);
+bool is_scalar_forced();
+
+class kernel_base_c {
+protected:
+  std::string m_name;
+
+public:
+  kernel_base_c(std::string const &name);
+  virtual ~kernel_base_c();
+
+  std::string const &get_name() const {
+    return m_name;
+  }
+
+  virtual void select() = 0;
+
+protected:
+  // Called by derived classes once they're fully constructed so that
+  // force_scalar() can reach them.
+  void add_to_registry();
+  void log_selection(std::string const &implementation) const;
+};
+
+// A kernel is a function with one scalar reference implementation and
+// any number of alternatives that require certain CPU features. The
+// best usable implementation is selected once when the kernel is
+// constructed. Alternatives must be added in order of preference, best
+// one last.
+//
+// Kernels are meant to be function-local statics in the module that
+// implements them:
+//
+//   static mtx::cpu::kernel_c<uint32_t(unsigned char const *, size_t)> s_kernel{"adler32", {
+//     { "scalar", mtx::cpu::FEATURE_NONE, adler32_scalar },
+//     { "sse2",   mtx::cpu::FEATURE_SSE2, adler32_sse2   },
+//   }};
+template<typename Tfunction>
+class kernel_c: public kernel_base_c {
+public:
+  struct implementation_t {
+    std::string name;
+    unsigned int required_features;
+    Tfunction *function;
+
+    bool is_usable() const {
+      return (get_usable_features() & required_features) == required_features;
+    }
+  };
+
+protected:
+  std::vector<implementation_t> m_implementations;
+  std::atomic<implementation_t const *> m_selected;
+
+public:
+  kernel_c(std::string const &name,
+           std::vector<implementation_t> const &implementations)
+    : kernel_base_c{name}
+    , m_implementations{implementations}
+    , m_selected{nullptr}
+  {
+    assert(!m_implementations.empty() && (FEATURE_NONE == m_implementations.front().required_features));
+    select();
+    add_to_registry();
+  }
+
+  virtual void select() override {
+    auto selected = &m_implementations.front();
+    for (auto &implementation : m_implementations)
+      if (implementation.is_usable())
+        selected = &implementation;
+
+    m_selected.store(selected, std::memory_order_relaxed);
+    log_selection(selected->name);
+  }
+
+  std::vector<implementation_t> const &get_implementations() const {
+    return m_implementations;
+  }
+
+  implementation_t const &get_reference() const {
+    return m_implementations.front();
+  }
+
+  implementation_t const &get_selected() const {
+    return *m_selected.load(std::memory_order_relaxed);
+  }
+
+  template<typename... Targs>
+  auto operator ()(Targs &&... args) const -> decltype(std::declval<Tfunction *>()(std::forward<Targs>(args)...)) {
+    return m_selected.load(std::memory_order_relaxed)->function(std::forward<Targs>(args)...);
+  }
+};
+
+}}
+
+#endif  // MTX_COMMON_CPU_FEATURES_H
@@ -0,0 +1,51 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   accessors for the kernels behind calc_adler32(), swap_16bit_words()
+   and mpeg4::p10::nalu_to_rbsp()
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_CPU_KERNELS_H
+#define MTX_COMMON_CPU_KERNELS_H
+
+#include "common/common_pch.h"
+
+#include "common/cpu_features.h"
+
+// Only the modules implementing the kernels and the unit tests include
+// this file. Everyone else calls the plain functions declared in
+// checksums.h, endian.h and mpeg4_p10.h.
+
+namespace mtx { namespace checksums {
+
+typedef uint32_t adler32_fn(unsigned char const *buffer, size_t size);
+mtx::cpu::kernel_c<adler32_fn> const &adler32_kernel();
+
+}}
+
+namespace mtx { namespace endian {
+
+typedef void swap_16bit_words_fn(void *buf, size_t num_bytes);
+mtx::cpu::kernel_c<swap_16bit_words_fn> const &swap_16bit_words_kernel();
+
+}}
+
+namespace mpeg4 { namespace p10 {
+
+// Copies 'size' bytes from 'src' to 'dst' leaving out the emulation
+// prevention bytes. Returns the number of bytes written. 'dst' must
+// hold at least 'size' bytes and must not overlap 'src'. HEVC uses the
+// same emulation prevention scheme.
+typedef size_t nalu_to_rbsp_fn(unsigned char const *src, size_t size, unsigned char *dst);
+mtx::cpu::kernel_c<nalu_to_rbsp_fn> const &nalu_to_rbsp_kernel();
+
+}}
+
+#endif  // MTX_COMMON_CPU_KERNELS_H
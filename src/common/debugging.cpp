@@ -13,6 +13,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/cpu_features.h"
 #include "common/strings/editing.h"
 
 static std::map<std::string, std::string> s_debugging_options;
@@ -52,6 +53,8 @@ request_debugging(const std::string &options) {
     else
       s_debugging_options[parts[0]] = 1 == parts.size() ? std::string("") : parts[1];
   }
+
+  mtx::cpu::force_scalar(debugging_requested("force_scalar_kernels"));
 }
 
 void
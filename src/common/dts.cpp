@@ -19,6 +19,7 @@
 #include "common/bit_cursor.h"
 #include "common/dts.h"
 #include "common/endian.h"
+#include "common/sync_word.h"
 
 // ---------------------------------------------------------------------------
 
@@ -80,22 +81,7 @@ enum source_pcm_resolution {
 int
 find_dts_sync_word(const unsigned char *buf,
                    unsigned int size) {
-  if (4 > size)
-    // not enough data for one header
-    return -1;
-
-  unsigned int offset = 0;
-  uint32_t sync_word  = get_uint32_be(buf);
-  while ((DTS_HEADER_MAGIC != sync_word) && ((offset + 4) < size)) {
-    sync_word = (sync_word << 8) | buf[offset + 4];
-    ++offset;
-  }
-
-  if (DTS_HEADER_MAGIC != sync_word)
-    // no header found
-    return -1;
-
-  return offset;
+  return mtx::sync_word::find_32(buf, size, DTS_HEADER_MAGIC);
 }
 
 int
@@ -245,18 +231,39 @@ find_dts_header(const unsigned char *buf,
   }
 }
 
+// Returns the position of the first sync word at or after 'base' whose
+// header can be decoded or -1 if there's none. A header that cannot be
+// decoded only skips its sync word so that the scan resumes right after
+// it instead of giving up.
+static int
+find_next_dts_header(const unsigned char *buf,
+                     unsigned int size,
+                     unsigned int base,
+                     dts_header_s &header) {
+  while (base < size) {
+    int pos = find_dts_sync_word(&buf[base], size - base);
+    if (0 > pos)
+      return -1;
+
+    base += pos;
+    if (0 == find_dts_header(&buf[base], size - base, &header, false))
+      return base;
+
+    ++base;
+  }
+
+  return -1;
+}
+
 int
 find_consecutive_dts_headers(const unsigned char *buf,
                              unsigned int size,
                              unsigned int num) {
   dts_header_s dts_header, new_header;
 
-  int pos = find_dts_header(buf, size, &dts_header, false);
-
-  if (0 > pos)
-    return -1;
+  int pos = find_next_dts_header(buf, size, 0, dts_header);
 
-  if (1 == num)
+  if ((0 > pos) || (1 == num))
     return pos;
 
   unsigned int base = pos;
@@ -268,7 +275,10 @@ find_consecutive_dts_headers(const unsigned char *buf,
     int offset = dts_header.frame_byte_size;
     unsigned int i;
     for (i = 0; (num - 1) > i; ++i) {
-      if (size < (2 + base + offset))
+      // Only decode if the next frame starts exactly here. Otherwise
+      // find_dts_header() would scan the rest of the buffer each time.
+      if (   (size < (4 + base + offset))
+          || (get_uint32_be(&buf[base + offset]) != DTS_HEADER_MAGIC))
         break;
 
       pos = find_dts_header(&buf[base + offset], size - base - offset, &new_header, false);
@@ -286,14 +296,12 @@ find_consecutive_dts_headers(const unsigned char *buf,
     if (i == (num - 1))
       return base;
 
-    ++base;
-    offset = 0;
-    pos    = find_dts_header(&buf[base], size - base, &dts_header, false);
-
-    if (-1 == pos)
+    // Resume right after the header the chain started with.
+    pos = find_next_dts_header(buf, size, base + 1, dts_header);
+    if (0 > pos)
       return -1;
 
-    base += pos;
+    base = pos;
   } while (base < (size - 5));
 
   return -1;
@@ -408,91 +416,124 @@ void
 dts_14_to_dts_16(const unsigned short *src,
                  unsigned long srcwords,
                  unsigned short *dst) {
-  // srcwords has to be a multiple of 8!
-  // you will get (srcbytes >> 3)*7 destination words!
-
-  const unsigned long l = srcwords >> 3;
-
-  for (unsigned long b = 0; b < l; b++) {
-    unsigned short src_0 = (src[0] >>  8) | (src[0] << 8);
-    unsigned short src_1 = (src[1] >>  8) | (src[1] << 8);
-    // 14 + 2
-    unsigned short dst_0 = (src_0  <<  2) | ((src_1 & 0x3fff) >> 12);
-    dst[0]               = (dst_0  >>  8) | (dst_0            <<  8);
-    // 12 + 4
-    unsigned short src_2 = (src[2] >>  8) | (src[2]           <<  8);
-    unsigned short dst_1 = (src_1  <<  4) | ((src_2 & 0x3fff) >> 10);
-    dst[1]               = (dst_1  >>  8) | (dst_1            <<  8);
-    // 10 + 6
-    unsigned short src_3 = (src[3] >>  8) | (src[3]           <<  8);
-    unsigned short dst_2 = (src_2  <<  6) | ((src_3 & 0x3fff) >>  8);
-    dst[2]               = (dst_2  >>  8) | (dst_2            <<  8);
-    // 8  + 8
-    unsigned short src_4 = (src[4] >>  8) | (src[4]           <<  8);
-    unsigned short dst_3 = (src_3  <<  8) | ((src_4 & 0x3fff) >>  6);
-    dst[3]               = (dst_3  >>  8) | (dst_3            <<  8);
-    // 6  + 10
-    unsigned short src_5 = (src[5] >>  8) | (src[5]           <<  8);
-    unsigned short dst_4 = (src_4  << 10) | ((src_5 & 0x3fff) >>  4);
-    dst[4]               = (dst_4  >>  8) | (dst_4            <<  8);
-    // 4  + 12
-    unsigned short src_6 = (src[6] >>  8) | (src[6]           <<  8);
-    unsigned short dst_5 = (src_5  << 12) | ((src_6 & 0x3fff) >>  2);
-    dst[5]               = (dst_5  >>  8) | (dst_5            <<  8);
-    // 2  + 14
-    unsigned short src_7 = (src[7] >>  8) | (src[7]           <<  8);
-    unsigned short dst_6 = (src_6  << 14) | (src_7 & 0x3fff);
-    dst[6]               = (dst_6  >>  8) | (dst_6            <<  8);
-
-    dst                 += 7;
-    src                 += 8;
+  // srcwords has to be a multiple of 4!
+  // you will get (srcwords >> 2)*7 destination bytes!
+  // src and dst may be the same buffer.
+
+  // The source words are big endian and carry 14 bits each. Four of
+  // them are collected in a 64-bit register and written out as seven
+  // bytes which avoids handling each word's bit offset separately.
+  auto in                 = reinterpret_cast<const unsigned char *>(src);
+  auto out                = reinterpret_cast<unsigned char *>(dst);
+  const unsigned long num = srcwords >> 2;
+
+  for (unsigned long b = 0; b < num; ++b) {
+    uint64_t bits = 0;
+    for (int idx = 0; 4 > idx; ++idx, in += 2)
+      bits = (bits << 14) | (((in[0] << 8) | in[1]) & 0x3fff);
+
+    for (int shift = 48; 0 <= shift; shift -= 8)
+      *out++ = bits >> shift;
   }
 }
 
+// Checks whether or not a valid DTS header starts at 'buf' once it
+// has been converted. Only the bytes required for the header check are
+// converted: a small head for the frame size and then the frame itself
+// plus the space for a possible DTS-HD header.
+static bool
+is_converted_dts_header(const unsigned char *buf,
+                        size_t size,
+                        bool dts14_to_16,
+                        bool swap_bytes) {
+  dts_header_t dtsheader;
+
+  if (!dts14_to_16 && !swap_bytes)
+    return 0 == find_dts_header(buf, size, &dtsheader);
+
+  auto alignment = dts14_to_16 ? 8u : 2u;
+  auto convert   = [=](size_t raw_size) -> memory_cptr {
+    raw_size &= ~static_cast<size_t>(alignment - 1);
+    auto mem  = memory_c::clone(buf, raw_size);
+
+    if (swap_bytes)
+      swap_16bit_words(mem->get_buffer(), raw_size);
+
+    if (dts14_to_16) {
+      auto words = reinterpret_cast<unsigned short *>(mem->get_buffer());
+      dts_14_to_dts_16(words, raw_size / 2, words);
+      mem->set_size(raw_size * 7 / 8);
+    }
+
+    return mem;
+  };
+
+  auto head = convert(std::min<size_t>(size, 32));
+  if (0 != find_dts_header(head->get_buffer(), head->get_size(), &dtsheader, true))
+    return false;
+
+  size_t needed = dtsheader.frame_byte_size + 9;
+  if (dts14_to_16)
+    needed = (needed * 8 + 6) / 7;
+  needed = (needed + alignment - 1) & ~static_cast<size_t>(alignment - 1);
+
+  if (needed > size)
+    return false;
+
+  auto frame = convert(needed);
+  return 0 == find_dts_header(frame->get_buffer(), frame->get_size(), &dtsheader);
+}
+
 bool
 detect_dts(const void *src_buf,
            int len,
            bool &dts14_to_16,
            bool &swap_bytes) {
-  dts_header_t dtsheader;
-  int dts_swap_bytes     = 0;
-  int dts_14_16          = 0;
-  bool is_dts            = false;
-  len                   &= ~0xf;
-  int cur_buf            = 0;
-  memory_cptr af_buf[2]  = { memory_c::alloc(len),                                        memory_c::alloc(len)                                        };
-  unsigned short *buf[2] = { reinterpret_cast<unsigned short *>(af_buf[0]->get_buffer()), reinterpret_cast<unsigned short *>(af_buf[1]->get_buffer()) };
-
-  for (dts_swap_bytes = 0; 2 > dts_swap_bytes; ++dts_swap_bytes) {
-    memcpy(buf[cur_buf], src_buf, len);
-
-    if (dts_swap_bytes) {
-      swab((char *)buf[cur_buf], (char *)buf[cur_buf^1], len);
-      cur_buf ^= 1;
-    }
+  // The DTS sync word as it appears in the unconverted data for each
+  // combination of byte swapping and 14-bit packing, in the order
+  // they're tried in.
+  static const struct {
+    uint32_t sync_word;
+    bool swap_bytes, dts14_to_16;
+  } s_variants[] = {
+    { 0x7ffe8001, false, false },
+    { 0x1fffe800, false, true  },
+    { 0xfe7f0180, true,  false },
+    { 0xff1f00e8, true,  true  },
+  };
+
+  auto buf  = static_cast<const unsigned char *>(src_buf);
+  len      &= ~0xf;
+
+  for (auto const &variant : s_variants) {
+    // Only the first sync word found is checked. Converted data must
+    // start at a 16-bit word boundary.
+    int pos = 0;
+    while (pos < len) {
+      int offset = mtx::sync_word::find_32(&buf[pos], len - pos, variant.sync_word);
+      if (0 > offset)
+        break;
 
-    for (dts_14_16 = 0; 2 > dts_14_16; ++dts_14_16) {
-      if (dts_14_16) {
-        dts_14_to_dts_16(buf[cur_buf], len / 2, buf[cur_buf^1]);
-        cur_buf ^= 1;
+      pos += offset;
+      if ((variant.swap_bytes || variant.dts14_to_16) && (pos & 1)) {
+        ++pos;
+        continue;
       }
 
-      int dst_buf_len = dts_14_16 ? (len * 7 / 8) : len;
-
-      if (find_dts_header(af_buf[cur_buf]->get_buffer(), dst_buf_len, &dtsheader) >= 0) {
-        is_dts = true;
+      if (!is_converted_dts_header(&buf[pos], len - pos, variant.dts14_to_16, variant.swap_bytes))
         break;
-      }
-    }
 
-    if (is_dts)
-      break;
+      dts14_to_16 = variant.dts14_to_16;
+      swap_bytes  = variant.swap_bytes;
+
+      return true;
+    }
   }
 
-  dts14_to_16 = dts_14_16      != 0;
-  swap_bytes  = dts_swap_bytes != 0;
+  dts14_to_16 = false;
+  swap_bytes  = false;
 
-  return is_dts;
+  return false;
 }
 
 bool
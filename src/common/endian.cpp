@@ -15,8 +15,13 @@
 
 #include <algorithm>
 
+#include "common/cpu_kernels.h"
 #include "common/endian.h"
 
+#if defined(MTX_CPU_X86)
+# include <immintrin.h>
+#endif
+
 uint16_t
 get_uint16_le(const void *buf) {
   return get_uint_le(buf, 2);
@@ -188,3 +193,80 @@ put_uint64_be(void *buf,
   tmp[1] = (value >>= 8) & 0xff;
   tmp[0] = (value >>= 8) & 0xff;
 }
+
+namespace mtx { namespace endian {
+
+static void
+swap_16bit_words_scalar(void *buf,
+                        size_t num_bytes) {
+  auto ptr = static_cast<unsigned char *>(buf);
+  auto end = ptr + (num_bytes & ~static_cast<size_t>(7));
+
+  // Eight bytes at a time. This is independent of the host's byte
+  // order, and compilers turn the loop into SIMD shuffles.
+  for (; ptr < end; ptr += 8) {
+    uint64_t value;
+    memcpy(&value, ptr, 8);
+    value = ((value & 0x00ff00ff00ff00ffull) << 8) | ((value >> 8) & 0x00ff00ff00ff00ffull);
+    memcpy(ptr, &value, 8);
+  }
+
+  end = static_cast<unsigned char *>(buf) + (num_bytes & ~static_cast<size_t>(1));
+  for (; ptr < end; ptr += 2)
+    std::swap(ptr[0], ptr[1]);
+}
+
+#if defined(MTX_CPU_X86)
+
+static MTX_TARGET("ssse3") void
+swap_16bit_words_ssse3(void *buf,
+                       size_t num_bytes) {
+  auto ptr           = static_cast<unsigned char *>(buf);
+  auto const shuffle = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+
+  for (; 16 <= num_bytes; ptr += 16, num_bytes -= 16) {
+    auto words = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), _mm_shuffle_epi8(words, shuffle));
+  }
+
+  swap_16bit_words_scalar(ptr, num_bytes);
+}
+
+static MTX_TARGET("avx2") void
+swap_16bit_words_avx2(void *buf,
+                      size_t num_bytes) {
+  auto ptr           = static_cast<unsigned char *>(buf);
+  auto const shuffle = _mm256_broadcastsi128_si256(_mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+
+  for (; 32 <= num_bytes; ptr += 32, num_bytes -= 32) {
+    auto words = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ptr));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), _mm256_shuffle_epi8(words, shuffle));
+  }
+
+  swap_16bit_words_scalar(ptr, num_bytes);
+}
+
+#endif  // MTX_CPU_X86
+
+mtx::cpu::kernel_c<swap_16bit_words_fn> const &
+swap_16bit_words_kernel() {
+  static mtx::cpu::kernel_c<swap_16bit_words_fn> s_kernel{"swap_16bit_words", {
+    { "scalar", mtx::cpu::FEATURE_NONE,  swap_16bit_words_scalar },
+#if defined(MTX_CPU_X86)
+    { "ssse3",  mtx::cpu::FEATURE_SSSE3, swap_16bit_words_ssse3  },
+    { "avx2",   mtx::cpu::FEATURE_AVX2,  swap_16bit_words_avx2   },
+#endif
+  }};
+
+  return s_kernel;
+}
+
+}}
+
+// Swaps the bytes of each 16-bit word in 'buf' in place. A trailing
+// odd byte is left alone.
+void
+swap_16bit_words(void *buf,
+                 size_t num_bytes) {
+  mtx::endian::swap_16bit_words_kernel()(buf, num_bytes);
+}
@@ -36,4 +36,6 @@ void put_uint24_be(void *buf, uint32_t value);
 void put_uint32_be(void *buf, uint32_t value);
 void put_uint64_be(void *buf, uint64_t value);
 
+void swap_16bit_words(void *buf, size_t num_bytes);
+
 #endif  // MTX_COMMON_ENDIAN_H
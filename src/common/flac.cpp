@@ -22,6 +22,7 @@
 #include <FLAC/stream_decoder.h>
 
 #include "common/bit_cursor.h"
+#include "common/checksums.h"
 #include "common/flac.h"
 
 static bool
@@ -127,6 +128,90 @@ flac_get_num_samples(unsigned char *mem,
   }
 }
 
+// Checks whether or not 'mem' starts with a valid frame header
+// including a matching CRC-8. Returns the header's size including
+// the CRC-8 byte if it does and 0 otherwise.
+size_t
+flac_get_frame_header_size(unsigned char const *mem,
+                           size_t size) {
+  // Sync code (14 bits) and reserved bit (must be 0)
+  if ((6 > size) || (0xff != mem[0]) || (0xf8 != (mem[1] & 0xfe)))
+    return 0;
+
+  unsigned int block_size_code  = mem[2] >> 4;
+  unsigned int sample_rate_code = mem[2] & 0x0f;
+  unsigned int channels_code    = mem[3] >> 4;
+  unsigned int sample_size_code = (mem[3] >> 1) & 0x07;
+
+  if (   (0x0 == block_size_code)
+      || (0xf == sample_rate_code)
+      || (0xa <  channels_code)
+      || (0x3 == sample_size_code)
+      || (0x7 == sample_size_code)
+      || (mem[3] & 0x01))
+    return 0;
+
+  // Frame/sample number coded like UTF-8 with up to seven bytes
+  size_t pos                 = 4;
+  unsigned int value         = mem[pos];
+  unsigned int num_following = !(value & 0x80)          ? 0
+                             : (0xc0 == (value & 0xe0)) ? 1
+                             : (0xe0 == (value & 0xf0)) ? 2
+                             : (0xf0 == (value & 0xf8)) ? 3
+                             : (0xf8 == (value & 0xfc)) ? 4
+                             : (0xfc == (value & 0xfe)) ? 5
+                             : (0xfe == value)          ? 6
+                             :                            7;
+
+  if (7 == num_following)
+    return 0;
+
+  ++pos;
+  for (auto idx = 0u; idx < num_following; ++idx, ++pos)
+    if ((pos >= size) || (0x80 != (mem[pos] & 0xc0)))
+      return 0;
+
+  pos += 6 == block_size_code  ? 1 : 7 == block_size_code ? 2 : 0;
+  pos += 12 == sample_rate_code ? 1 : (13 == sample_rate_code) || (14 == sample_rate_code) ? 2 : 0;
+
+  // CRC-8 over the whole header including the CRC byte itself results in 0.
+  if ((pos >= size) || (0 != crc_calc(crc_get_table(CRC_8_ATM), 0, mem, pos + 1)))
+    return 0;
+
+  return pos + 1;
+}
+
+// Checks whether or not the CRC-16 at the end of a complete frame
+// matches the frame's content.
+bool
+flac_is_frame_crc_valid(unsigned char const *mem,
+                        size_t size) {
+  return (2 < size) && (0 == crc_calc(crc_get_table(CRC_16_ANSI), 0, mem, size));
+}
+
+// Returns the size of the longest prefix of 'mem' that is a complete
+// frame with a matching CRC-16 or 0 if there is none. Used for
+// separating the last frame from trailing data that isn't a frame.
+// Zero bytes following a matching CRC don't change it; such padding
+// isn't counted as part of the frame.
+size_t
+flac_find_longest_valid_frame(unsigned char const *mem,
+                              size_t size) {
+  auto table        = crc_get_table(CRC_16_ANSI);
+  uint32_t crc      = 0;
+  size_t frame_size = 0;
+
+  for (size_t pos = 0; pos < size; ++pos) {
+    auto previous_crc = crc;
+    crc               = crc_calc(table, crc, &mem[pos], 1);
+
+    if (!crc && previous_crc && (2 < (pos + 1)))
+      frame_size = pos + 1;
+  }
+
+  return frame_size;
+}
+
 #define FPFX "flac_decode_headers: "
 
 typedef struct {
@@ -26,7 +26,12 @@
 #define FLAC_HEADER_APPLICATION      8
 #define FLAC_HEADER_SEEKTABLE       16
 
+#define FLAC_MAX_FRAME_HEADER_SIZE  16
+
 int flac_get_num_samples(unsigned char *buf, int size, FLAC__StreamMetadata_StreamInfo &stream_info);
+size_t flac_get_frame_header_size(unsigned char const *mem, size_t size);
+bool flac_is_frame_crc_valid(unsigned char const *mem, size_t size);
+size_t flac_find_longest_valid_frame(unsigned char const *mem, size_t size);
 int flac_decode_headers(unsigned char *mem, int size, int num_elements, ...);
 
 #endif /* HAVE_FLAC_FORMAT_H */
@@ -51,6 +51,11 @@ get_current_time_millis() {
   return (int64_t)tb.time * 1000 + tb.millitm;
 }
 
+void
+sleep_millis(int64_t millis) {
+  Sleep(millis);
+}
+
 bool
 get_registry_key_value(const std::string &key,
                        const std::string &value_name,
@@ -147,10 +152,40 @@ get_application_data_folder() {
   return "";
 }
 
+/** \brief Identifies the current version of a file
+
+   \c file_id is set to the file's index on its volume and \c
+   modification_time to its last write time in units of 100
+   nanoseconds.
+*/
+bool
+get_file_identity(std::string const &file_name,
+                  uint64_t &file_id,
+                  uint64_t &modification_time) {
+  HANDLE file = CreateFileUtf8(file_name.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (INVALID_HANDLE_VALUE == file)
+    return false;
+
+  BY_HANDLE_FILE_INFORMATION info;
+  bool ok = GetFileInformationByHandle(file, &info);
+  CloseHandle(file);
+
+  if (!ok)
+    return false;
+
+  file_id           = (static_cast<uint64_t>(info.nFileIndexHigh)                 << 32) | info.nFileIndexLow;
+  modification_time = (static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime;
+
+  return true;
+}
+
 #else // SYS_WINDOWS
 
+# include <errno.h>
 # include <stdlib.h>
+# include <sys/stat.h>
 # include <sys/time.h>
+# include <time.h>
 
 int64_t
 get_current_time_millis() {
@@ -161,6 +196,16 @@ get_current_time_millis() {
   return (int64_t)tv.tv_sec * 1000 + (int64_t)tv.tv_usec / 1000;
 }
 
+void
+sleep_millis(int64_t millis) {
+  struct timespec ts;
+  ts.tv_sec  = millis / 1000;
+  ts.tv_nsec = (millis % 1000) * 1000000;
+
+  while ((0 != nanosleep(&ts, &ts)) && (EINTR == errno))
+    ;
+}
+
 std::string
 get_application_data_folder() {
   const char *home = getenv("HOME");
@@ -187,6 +232,31 @@ get_installation_path() {
   return "";
 }
 
+/** \brief Identifies the current version of a file
+
+   \c file_id is set to the file's inode and \c modification_time to
+   its last write time in nanoseconds.
+*/
+bool
+get_file_identity(std::string const &file_name,
+                  uint64_t &file_id,
+                  uint64_t &modification_time) {
+  struct stat st;
+  if (0 != stat(file_name.c_str(), &st))
+    return false;
+
+# if defined(SYS_APPLE)
+  auto const &mtime = st.st_mtimespec;
+# else
+  auto const &mtime = st.st_mtim;
+# endif
+
+  file_id           = st.st_ino;
+  modification_time = static_cast<uint64_t>(mtime.tv_sec) * 1000000000ull + mtime.tv_nsec;
+
+  return true;
+}
+
 #endif // SYS_WINDOWS
 
 namespace mtx {
@@ -16,8 +16,10 @@
 #include "common/common_pch.h"
 
 int64_t get_current_time_millis();
+void sleep_millis(int64_t millis);
 std::string get_application_data_folder();
 std::string get_installation_path();
+bool get_file_identity(std::string const &file_name, uint64_t &file_id, uint64_t &modification_time);
 
 #if defined(SYS_WINDOWS)
 
@@ -38,7 +38,8 @@
 #define ENGAGE_VOBSUB_SUBPIC_STOP_CMDS      17
 #define ENGAGE_NO_CUE_DURATION              18
 #define ENGAGE_NO_CUE_RELATIVE_POSITION     19
-#define ENGAGE_MAX_IDX                      19
+#define ENGAGE_NO_DIRECT_CLUSTER_RENDERING  20
+#define ENGAGE_MAX_IDX                      20
 
 void engage_hacks(const std::string &hacks);
 void engage_hack(unsigned int id);
@@ -28,6 +28,7 @@
 #include "common/math.h"
 #include "common/mm_io.h"
 #include "common/hevc.h"
+#include "common/mpeg4_p10.h"
 #include "common/strings/formatting.h"
 
 namespace hevc {
@@ -696,26 +697,10 @@ hevc::slice_info_t::dump()
          % pps);
 }
 
+// HEVC uses the same emulation prevention scheme as AVC.
 void
 hevc::nalu_to_rbsp(memory_cptr &buffer) {
-  int pos, size = buffer->get_size();
-  mm_mem_io_c d(nullptr, size, 100);
-  unsigned char *b = buffer->get_buffer();
-
-  for (pos = 0; pos < size; ++pos) {
-    if (   ((pos + 2) < size)
-        && (0 == b[pos])
-        && (0 == b[pos + 1])
-        && (3 == b[pos + 2])) {
-      d.write_uint8(0);
-      d.write_uint8(0);
-      pos += 2;
-
-    } else
-      d.write_uint8(b[pos]);
-  }
-
-  buffer = memory_cptr(new memory_c(d.get_and_lock_buffer(), d.getFilePointer(), true));
+  mpeg4::p10::nalu_to_rbsp(buffer);
 }
 
 void
@@ -1169,7 +1154,7 @@ hevc::hevc_es_parser_c::add_bytes(unsigned char *buffer,
       if (0 != marker_size) {
         if (-1 != previous_pos) {
           int new_size = cursor.get_position() - marker_size - previous_pos - previous_marker_size;
-          memory_cptr nalu(new memory_c(safemalloc(new_size), new_size, true));
+          auto nalu = memory_c::alloc(new_size, m_nalu_size_length + NALU_EXTRA_DATA_HEADROOM);
           cursor.copy(nalu->get_buffer(), previous_pos + previous_marker_size, new_size);
           m_parsed_position = previous_parsed_pos + previous_pos;
           handle_nalu(nalu);
@@ -1207,7 +1192,10 @@ hevc::hevc_es_parser_c::flush() {
   if (m_unparsed_buffer && (5 <= m_unparsed_buffer->get_size())) {
     m_parsed_position += m_unparsed_buffer->get_size();
     int marker_size = get_uint32_be(m_unparsed_buffer->get_buffer()) == NALU_START_CODE ? 4 : 3;
-    handle_nalu(memory_c::clone(m_unparsed_buffer->get_buffer() + marker_size, m_unparsed_buffer->get_size() - marker_size));
+    auto nalu_size  = m_unparsed_buffer->get_size() - marker_size;
+    auto nalu       = memory_c::alloc(nalu_size, m_nalu_size_length + NALU_EXTRA_DATA_HEADROOM);
+    memcpy(nalu->get_buffer(), m_unparsed_buffer->get_buffer() + marker_size, nalu_size);
+    handle_nalu(nalu);
   }
 
   m_unparsed_buffer.reset();
@@ -1809,28 +1797,37 @@ hevc::hevc_es_parser_c::cleanup() {
 memory_cptr
 hevc::hevc_es_parser_c::create_nalu_with_size(const memory_cptr &src,
                                               bool add_extra_data) {
-  int final_size = m_nalu_size_length + src->get_size(), offset = 0, size;
-  unsigned char *buffer;
-
   if (add_extra_data) {
+    // A frame's first slice is prefixed with the parameter sets and
+    // SEIs preceding it and with its own size field. Slices are
+    // allocated with room for them so that prepend() can usually put
+    // them in place without copying the slice.
+    size_t prefix_size = m_nalu_size_length;
     for (auto &mem : m_extra_data)
-      final_size += mem->get_size();
-    buffer = (unsigned char *)safemalloc(final_size);
+      prefix_size += mem->get_size();
+
+    auto prefix   = memory_c::alloc(prefix_size);
+    size_t offset = 0;
 
     for (auto &mem : m_extra_data) {
-      memcpy(buffer + offset, mem->get_buffer(), mem->get_size());
+      memcpy(prefix->get_buffer() + offset, mem->get_buffer(), mem->get_size());
       offset += mem->get_size();
     }
 
+    write_nalu_size(prefix->get_buffer() + offset, src->get_size());
+    src->prepend(prefix);
     m_extra_data.clear();
-  } else
-    buffer = (unsigned char *)safemalloc(final_size);
 
-  size = src->get_size();
-  write_nalu_size(buffer + offset, size);
-  memcpy(buffer + offset + m_nalu_size_length, src->get_buffer(), size);
+    return src;
+  }
+
+  int size    = src->get_size();
+  auto buffer = memory_c::alloc(m_nalu_size_length + size);
+
+  write_nalu_size(buffer->get_buffer(), size);
+  memcpy(buffer->get_buffer() + m_nalu_size_length, src->get_buffer(), size);
 
-  return memory_cptr(new memory_c(buffer, final_size, true));
+  return buffer;
 }
 
 memory_cptr
@@ -19,15 +19,19 @@
 #include <ebml/EbmlStream.h>
 #include <ebml/EbmlVoid.h>
 #include <matroska/KaxCluster.h>
+#include <matroska/KaxInfo.h>
+#include <matroska/KaxInfoData.h>
 #include <matroska/KaxSeekHead.h>
 #include <matroska/KaxSegment.h>
 #include <matroska/KaxTags.h>
 
 #include "common/ebml.h"
 #include "common/error.h"
+#include "common/fs_sys_helpers.h"
 #include "common/kax_analyzer.h"
 #include "common/mm_io_x.h"
 #include "common/strings/editing.h"
+#include "common/vint.h"
 
 using namespace libebml;
 using namespace libmatroska;
@@ -36,6 +40,10 @@ using namespace libmatroska;
 
 #define CONSOLE_PERCENTAGE_WIDTH 25
 
+#define INDEX_CACHE_MAGIC         "MTXKAXIX"
+#define INDEX_CACHE_VERSION       2
+#define INDEX_CACHE_NUM_SPOT_CHECKS 8
+
 bool
 operator <(const kax_analyzer_data_cptr &d1,
            const kax_analyzer_data_cptr &d2) {
@@ -67,6 +75,7 @@ kax_analyzer_c::kax_analyzer_c(std::string file_name)
   , m_close_file(true)
   , m_stream(nullptr)
   , m_debugging_requested(debugging_requested("kax_analyzer"))
+  , m_parsed_fully(false)
 {
 }
 
@@ -76,11 +85,15 @@ kax_analyzer_c::kax_analyzer_c(mm_file_io_c *file)
   , m_close_file(false)
   , m_stream(nullptr)
   , m_debugging_requested(debugging_requested("kax_analyzer"))
+  , m_parsed_fully(false)
 {
 }
 
 kax_analyzer_c::~kax_analyzer_c() {
   close_file();
+
+  // Files opened by the caller are not closed, but the stream is ours.
+  delete m_stream;
 }
 
 void
@@ -216,13 +229,21 @@ kax_analyzer_c::process(kax_analyzer_c::parse_mode_e parse_mode,
   }
 
   int64_t file_size = m_file->get_size();
+
+  // The file may have been opened by the caller in which case there's
+  // no stream yet.
+  if (!m_stream)
+    m_stream = new EbmlStream(*m_file);
+
+  if (!m_index_cache_file_name.empty() && load_index_cache(parse_mode))
+    return true;
+
   show_progress_start(file_size);
 
   m_segment.reset();
   m_data.clear();
 
   m_file->setFilePointer(0);
-  m_stream = new EbmlStream(*m_file);
 
   // Find the EbmlHead element. Must be the first one.
   EbmlElement *l0 = m_stream->FindNextID(EBML_INFO(EbmlHead), 0xFFFFFFFFL);
@@ -284,9 +305,214 @@ kax_analyzer_c::process(kax_analyzer_c::parse_mode_e parse_mode,
     if (parse_mode_full != parse_mode)
       fix_element_sizes(file_size);
 
+    m_parsed_fully = parse_fully;
+
+    if (!m_index_cache_file_name.empty())
+      save_index_cache();
+
+    return true;
+  }
+
+  m_segment.reset();
+  m_data.clear();
+
+  return false;
+}
+
+/** \brief Enables the on-disk cache of the level 1 element index
+
+   If \c cache_file_name is empty then a sidecar file named after the
+   Matroska file with the extension ".mtxidx" appended is used.
+*/
+void
+kax_analyzer_c::enable_index_cache(std::string const &cache_file_name) {
+  m_index_cache_file_name = cache_file_name.empty() ? m_file_name + ".mtxidx" : cache_file_name;
+}
+
+std::string
+kax_analyzer_c::read_segment_uid() {
+  int info_idx = find(EBML_ID(KaxInfo));
+  if (-1 == info_idx)
+    return "";
+
+  auto info = read_element(info_idx);
+  auto uid  = info ? FindChild<KaxSegmentUID>(*info) : nullptr;
+
+  return uid ? std::string(reinterpret_cast<char const *>(uid->GetBuffer()), uid->GetSize()) : std::string{};
+}
+
+/** \brief Writes the current level 1 element index to the cache file
+
+   The index is keyed by the file's size, its inode, its modification
+   time in the highest resolution available and the segment UID. It
+   must only be called when \c m_data reflects the file's current
+   content, e.g. after \c process() or after all changes have been
+   written and the file has been closed.
+
+   Failing to write the cache isn't an error; the file is simply
+   scanned again next time. The reason is output in verbose mode.
+*/
+bool
+kax_analyzer_c::save_index_cache() {
+  if (m_index_cache_file_name.empty() || !m_segment)
+    return false;
+
+  try {
+    uint64_t file_id, file_mtime;
+    if (!get_file_identity(m_file_name, file_id, file_mtime)) {
+      mxverb(2, boost::format(Y("The index cache '%1%' was not written: the modification time of '%2%' could not be determined.\n")) % m_index_cache_file_name % m_file_name);
+      return false;
+    }
+
+    auto segment_uid = read_segment_uid();
+    auto file_size   = boost::filesystem::file_size(m_file_name);
+
+    mm_file_io_c out(m_index_cache_file_name, MODE_CREATE);
+
+    out.write(INDEX_CACHE_MAGIC, 8);
+    out.write_uint32_be(INDEX_CACHE_VERSION);
+    out.write_uint64_be(file_size);
+    out.write_uint64_be(file_id);
+    out.write_uint64_be(file_mtime);
+    out.write_uint8(m_parsed_fully ? 1 : 0);
+    out.write_uint8(segment_uid.length());
+    out.write(segment_uid);
+    out.write_uint64_be(m_segment->GetElementPosition());
+    out.write_uint32_be(m_data.size());
+
+    for (auto &data : m_data) {
+      out.write_uint32_be(EBML_ID_VALUE(data->m_id));
+      out.write_uint8(EBML_ID_LENGTH(data->m_id));
+      out.write_uint64_be(data->m_pos);
+      out.write_uint64_be(data->m_size);
+    }
+
+    if (analyzer_debugging_requested("index_cache"))
+      log_debug_message(boost::format("kax_analyzer_index_cache: wrote %1% entries to %2%\n") % m_data.size() % m_index_cache_file_name);
+
+    return true;
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxverb(2, boost::format(Y("Writing the index cache '%1%' failed: %2%\n")) % m_index_cache_file_name % ex);
+
+  } catch (std::exception &ex) {
+    mxverb(2, boost::format(Y("Writing the index cache '%1%' failed: %2%\n")) % m_index_cache_file_name % ex.what());
+
+  } catch (...) {
+    mxverb(2, boost::format(Y("Writing the index cache '%1%' failed.\n")) % m_index_cache_file_name);
+  }
+
+  // Don't leave a truncated cache file behind.
+  boost::system::error_code ec;
+  boost::filesystem::remove(m_index_cache_file_name, ec);
+
+  return false;
+}
+
+bool
+kax_analyzer_c::verify_index_cache_entries() {
+  size_t num_entries = m_data.size();
+  size_t step        = std::max<size_t>(1, num_entries / INDEX_CACHE_NUM_SPOT_CHECKS);
+  std::vector<size_t> indexes;
+
+  for (size_t idx = 0; idx < num_entries; idx += step)
+    indexes.push_back(idx);
+  if (num_entries)
+    indexes.push_back(num_entries - 1);
+
+  for (auto idx : indexes) {
+    auto &data = *m_data[idx];
+
+    m_file->setFilePointer(data.m_pos);
+    auto id   = vint_c::read_ebml_id(m_file);
+    auto size = vint_c::read(m_file);
+
+    if (!id.is_valid() || !size.is_valid() || (EbmlId(id) != data.m_id))
+      return false;
+
+    if (!size.is_unknown() && (-1 != data.m_size) && (static_cast<int64_t>(m_file->getFilePointer() - data.m_pos + size.m_value) != data.m_size))
+      return false;
+  }
+
+  return true;
+}
+
+/** \brief Replaces the scan in \c process() with the cached index
+
+   Returns \c false if the cache does not exist or doesn't match the
+   file in which case the file must be scanned normally.
+*/
+bool
+kax_analyzer_c::load_index_cache(parse_mode_e parse_mode) {
+  bool debug = analyzer_debugging_requested("index_cache");
+
+  try {
+    uint64_t file_id, file_mtime;
+    if (   !boost::filesystem::exists(m_index_cache_file_name)
+        || !get_file_identity(m_file_name, file_id, file_mtime))
+      return false;
+
+    mm_file_io_c in(m_index_cache_file_name, MODE_READ);
+
+    std::string magic;
+    if (   (8                   != in.read(magic, 8))
+        || (INDEX_CACHE_MAGIC   != magic)
+        || (INDEX_CACHE_VERSION != in.read_uint32_be())
+        || (m_file->get_size()  != static_cast<int64_t>(in.read_uint64_be()))
+        || (file_id             != in.read_uint64_be())
+        || (file_mtime          != in.read_uint64_be()))
+      throw false;
+
+    bool parsed_fully = 1 == in.read_uint8();
+    if ((parse_mode_full == parse_mode) && !parsed_fully)
+      throw false;
+
+    std::string segment_uid;
+    size_t segment_uid_length = in.read_uint8();
+    if (segment_uid_length != in.read(segment_uid, segment_uid_length))
+      throw false;
+
+    uint64_t segment_pos = in.read_uint64_be();
+    size_t num_entries   = in.read_uint32_be();
+
+    m_segment.reset();
+    m_data.clear();
+
+    for (size_t idx = 0; idx < num_entries; ++idx) {
+      uint32_t id_value  = in.read_uint32_be();
+      int id_length      = in.read_uint8();
+      uint64_t pos       = in.read_uint64_be();
+      int64_t size       = in.read_uint64_be();
+
+      m_data.push_back(kax_analyzer_data_c::create(EbmlId(id_value, id_length), pos, size));
+    }
+
+    // Re-create the segment from its header only.
+    m_file->setFilePointer(segment_pos);
+    EbmlElement *l0 = m_stream->FindNextID(EBML_INFO(KaxSegment), 0xFFFFFFFFFFFFFFFFLL);
+    if (!l0 || (EbmlId(*l0) != EBML_ID(KaxSegment)) || (l0->GetElementPosition() != segment_pos)) {
+      delete l0;
+      throw false;
+    }
+
+    m_segment = std::shared_ptr<KaxSegment>(static_cast<KaxSegment *>(l0));
+
+    if (!verify_index_cache_entries() || (read_segment_uid() != segment_uid))
+      throw false;
+
+    m_parsed_fully = parsed_fully;
+
+    if (debug)
+      log_debug_message(boost::format("kax_analyzer_index_cache: using %1% entries from %2%\n") % m_data.size() % m_index_cache_file_name);
+
     return true;
+
+  } catch (...) {
   }
 
+  if (debug)
+    log_debug_message(boost::format("kax_analyzer_index_cache: %1% is missing or outdated\n") % m_index_cache_file_name);
+
   m_segment.reset();
   m_data.clear();
 
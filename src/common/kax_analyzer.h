@@ -99,6 +99,8 @@ private:
   std::map<int64_t, bool> m_meta_seeks_by_position;
   EbmlStream *m_stream;
   bool m_debugging_requested;
+  std::string m_index_cache_file_name;
+  bool m_parsed_fully;
 
 public:                         // Static functions
   static bool probe(std::string file_name);
@@ -156,6 +158,9 @@ public:
   virtual void close_file();
   virtual void reopen_file(const open_mode = MODE_WRITE);
 
+  virtual void enable_index_cache(std::string const &cache_file_name = "");
+  virtual bool save_index_cache();
+
   static placement_strategy_e get_placement_strategy_for(EbmlElement *e);
   static placement_strategy_e get_placement_strategy_for(ebml_element_cptr e) {
     return get_placement_strategy_for(e.get());
@@ -179,6 +184,10 @@ protected:
   virtual void validate_data_structures(const std::string &hook_name);
   virtual void verify_data_structures_against_file(const std::string &hook_name);
 
+  virtual bool load_index_cache(parse_mode_e parse_mode);
+  virtual bool verify_index_cache_entries();
+  virtual std::string read_segment_uid();
+
   virtual void read_all_meta_seeks();
   virtual void read_meta_seek(uint64_t pos, std::map<int64_t, bool> &positions_found);
   virtual void fix_element_sizes(uint64_t file_size);
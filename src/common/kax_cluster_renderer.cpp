@@ -0,0 +1,284 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   serializing simple clusters without libmatroska
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxBlockData.h>
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+
+#include "common/kax_cluster_renderer.h"
+
+using namespace libmatroska;
+
+// Maximum size of an element head: four bytes for the ID and eight
+// bytes for the coded size.
+#define MAX_ELEMENT_HEAD_SIZE 12
+
+static uint64_t
+element_head_size(EbmlId const &id,
+                  uint64_t content_size) {
+  return EBML_ID_LENGTH(id) + CodedSizeLength(content_size, 0);
+}
+
+static void
+put_element_head(std::vector<unsigned char> &buffer,
+                 EbmlId const &id,
+                 uint64_t content_size) {
+  unsigned char head[MAX_ELEMENT_HEAD_SIZE];
+  int id_size    = EBML_ID_LENGTH(id);
+  int coded_size = CodedSizeLength(content_size, 0);
+
+  id.Fill(head);
+  CodedValueLength(content_size, coded_size, &head[id_size]);
+
+  buffer.insert(buffer.end(), &head[0], &head[id_size + coded_size]);
+}
+
+static int
+uint_size(uint64_t value) {
+  int num_bytes = 1;
+  while ((8 > num_bytes) && (value >= (1ull << (num_bytes * 8))))
+    ++num_bytes;
+
+  return num_bytes;
+}
+
+static int
+sint_size(int64_t value) {
+  int num_bytes = 1;
+  while ((8 > num_bytes) && ((value < -(1ll << (num_bytes * 8 - 1))) || (value >= (1ll << (num_bytes * 8 - 1)))))
+    ++num_bytes;
+
+  return num_bytes;
+}
+
+static void
+put_uint_element(std::vector<unsigned char> &buffer,
+                 EbmlId const &id,
+                 uint64_t value) {
+  auto num_bytes = uint_size(value);
+
+  put_element_head(buffer, id, num_bytes);
+  for (auto idx = num_bytes; 0 < idx; --idx)
+    buffer.push_back(value >> ((idx - 1) * 8));
+}
+
+static void
+put_sint_element(std::vector<unsigned char> &buffer,
+                 EbmlId const &id,
+                 int64_t value) {
+  auto num_bytes = sint_size(value);
+
+  put_element_head(buffer, id, num_bytes);
+  for (auto idx = num_bytes; 0 < idx; --idx)
+    buffer.push_back(static_cast<uint64_t>(value) >> ((idx - 1) * 8));
+}
+
+// The lacing KaxInternalBlock::GetBestLacingType() chooses for
+// LACING_AUTO.
+static LacingType
+best_lacing_type(kax_cluster_renderer_c::frames_t const &frames) {
+  if (2 > frames.size())
+    return LACING_NONE;
+
+  auto same_size = true;
+  int xiph_size  = 1, ebml_size = 1;
+
+  for (auto idx = 0u; frames.size() - 1 > idx; ++idx) {
+    if (frames[idx]->get_size() != frames[idx + 1]->get_size())
+      same_size = false;
+    xiph_size += frames[idx]->get_size() / 0xff + 1;
+  }
+
+  ebml_size += CodedSizeLength(frames[0]->get_size(), 0);
+  for (auto idx = 1u; frames.size() - 1 > idx; ++idx)
+    ebml_size += CodedSizeLengthSigned(static_cast<int64_t>(frames[idx]->get_size()) - static_cast<int64_t>(frames[idx - 1]->get_size()), 0);
+
+  return same_size ? LACING_FIXED : xiph_size < ebml_size ? LACING_XIPH : LACING_EBML;
+}
+
+// The number of laced frames and their sizes following the block's
+// flags. Empty for a single frame.
+static std::vector<unsigned char>
+make_lace_head(LacingType lacing,
+               kax_cluster_renderer_c::frames_t const &frames) {
+  std::vector<unsigned char> head;
+
+  if (LACING_NONE == lacing)
+    return head;
+
+  head.push_back(frames.size() - 1);
+
+  if (LACING_XIPH == lacing) {
+    for (auto idx = 0u; frames.size() - 1 > idx; ++idx) {
+      auto size = frames[idx]->get_size();
+      for (; 0xff <= size; size -= 0xff)
+        head.push_back(0xff);
+      head.push_back(size);
+    }
+
+  } else if (LACING_EBML == lacing) {
+    unsigned char coded[8];
+    int coded_size = CodedSizeLength(frames[0]->get_size(), 0);
+
+    CodedValueLength(frames[0]->get_size(), coded_size, coded);
+    head.insert(head.end(), &coded[0], &coded[coded_size]);
+
+    for (auto idx = 1u; frames.size() - 1 > idx; ++idx) {
+      auto difference = static_cast<int64_t>(frames[idx]->get_size()) - static_cast<int64_t>(frames[idx - 1]->get_size());
+      coded_size      = CodedSizeLengthSigned(difference, 0);
+
+      CodedValueLengthSigned(difference, coded_size, coded);
+      head.insert(head.end(), &coded[0], &coded[coded_size]);
+    }
+  }
+
+  return head;
+}
+
+static unsigned char
+lacing_flags(LacingType lacing) {
+  return LACING_XIPH  == lacing ? 0x02
+       : LACING_FIXED == lacing ? 0x04
+       : LACING_EBML  == lacing ? 0x06
+       :                          0x00;
+}
+
+static uint64_t
+block_content_size(unsigned int track_num,
+                   std::vector<unsigned char> const &lace_head,
+                   kax_cluster_renderer_c::frames_t const &frames) {
+  auto size = (0x80 > track_num ? 1 : 2) + 3 + lace_head.size();
+  for (auto frame : frames)
+    size += frame->get_size();
+
+  return size;
+}
+
+// Block header as rendered by KaxInternalBlock: track number, 16bit
+// timecode relative to the cluster's timecode, flags and the lace
+// head followed by the frames.
+static void
+put_block(std::vector<unsigned char> &buffer,
+          EbmlId const &id,
+          unsigned int track_num,
+          int16_t relative_timecode,
+          unsigned char flags,
+          kax_cluster_renderer_c::frames_t const &frames) {
+  auto lacing    = best_lacing_type(frames);
+  auto lace_head = make_lace_head(lacing, frames);
+
+  put_element_head(buffer, id, block_content_size(track_num, lace_head, frames));
+
+  if (0x80 > track_num)
+    buffer.push_back(0x80 | track_num);
+  else {
+    buffer.push_back(0x40 | (track_num >> 8));
+    buffer.push_back(track_num & 0xff);
+  }
+
+  buffer.push_back(static_cast<uint16_t>(relative_timecode) >> 8);
+  buffer.push_back(static_cast<uint16_t>(relative_timecode) & 0xff);
+  buffer.push_back(flags | lacing_flags(lacing));
+  buffer.insert(buffer.end(), lace_head.begin(), lace_head.end());
+
+  for (auto frame : frames)
+    buffer.insert(buffer.end(), frame->get_buffer(), frame->get_buffer() + frame->get_size());
+}
+
+bool
+kax_cluster_renderer_c::is_relative_timecode_valid(int64_t relative_timecode) {
+  return (std::numeric_limits<int16_t>::min() <= relative_timecode) && (std::numeric_limits<int16_t>::max() >= relative_timecode);
+}
+
+void
+kax_cluster_renderer_c::start(uint64_t cluster_timecode) {
+  m_buffer.resize(MAX_ELEMENT_HEAD_SIZE);
+  put_uint_element(m_buffer, EBML_ID(KaxClusterTimecode), cluster_timecode);
+}
+
+uint64_t
+kax_cluster_renderer_c::add_simple_block(unsigned int track_num,
+                                         int16_t relative_timecode,
+                                         bool key_frame,
+                                         bool discardable,
+                                         memory_c const &data) {
+  return add_simple_block(track_num, relative_timecode, key_frame, discardable, frames_t{ &data });
+}
+
+uint64_t
+kax_cluster_renderer_c::add_simple_block(unsigned int track_num,
+                                         int16_t relative_timecode,
+                                         bool key_frame,
+                                         bool discardable,
+                                         frames_t const &frames) {
+  auto position = m_buffer.size() - MAX_ELEMENT_HEAD_SIZE;
+  put_block(m_buffer, EBML_ID(KaxSimpleBlock), track_num, relative_timecode, (key_frame ? 0x80 : 0x00) | (discardable ? 0x01 : 0x00), frames);
+
+  return position;
+}
+
+uint64_t
+kax_cluster_renderer_c::add_block_group(unsigned int track_num,
+                                        int16_t relative_timecode,
+                                        memory_c const &data,
+                                        std::vector<int64_t> const &references,
+                                        int64_t duration) {
+  return add_block_group(track_num, relative_timecode, frames_t{ &data }, references, duration);
+}
+
+uint64_t
+kax_cluster_renderer_c::add_block_group(unsigned int track_num,
+                                        int16_t relative_timecode,
+                                        frames_t const &frames,
+                                        std::vector<int64_t> const &references,
+                                        int64_t duration) {
+  // Calculate the group's size first so that its head can be written
+  // in front of its children right away.
+  auto block_size = block_content_size(track_num, make_lace_head(best_lacing_type(frames), frames), frames);
+  auto group_size = element_head_size(EBML_ID(KaxBlock), block_size) + block_size;
+
+  for (auto reference : references)
+    group_size += element_head_size(EBML_ID(KaxReferenceBlock), sint_size(reference)) + sint_size(reference);
+
+  if (-1 != duration)
+    group_size += element_head_size(EBML_ID(KaxBlockDuration), uint_size(duration)) + uint_size(duration);
+
+  put_element_head(m_buffer, EBML_ID(KaxBlockGroup), group_size);
+
+  // Cues refer to the Block inside the group, not to the group itself.
+  auto position = m_buffer.size() - MAX_ELEMENT_HEAD_SIZE;
+
+  put_block(m_buffer, EBML_ID(KaxBlock), track_num, relative_timecode, 0, frames);
+
+  for (auto reference : references)
+    put_sint_element(m_buffer, EBML_ID(KaxReferenceBlock), reference);
+
+  if (-1 != duration)
+    put_uint_element(m_buffer, EBML_ID(KaxBlockDuration), duration);
+
+  return position;
+}
+
+uint64_t
+kax_cluster_renderer_c::finish(mm_io_c &out) {
+  std::vector<unsigned char> cluster_head;
+  put_element_head(cluster_head, EBML_ID(KaxCluster), m_buffer.size() - MAX_ELEMENT_HEAD_SIZE);
+
+  auto head_start = MAX_ELEMENT_HEAD_SIZE - cluster_head.size();
+  std::copy(cluster_head.begin(), cluster_head.end(), m_buffer.begin() + head_start);
+
+  return out.write(&m_buffer[head_start], m_buffer.size() - head_start);
+}
@@ -0,0 +1,54 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for serializing simple clusters without libmatroska
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_CLUSTER_RENDERER_H
+#define MTX_COMMON_KAX_CLUSTER_RENDERER_H
+
+#include "common/common_pch.h"
+
+// Serializes a cluster consisting of SimpleBlocks and of BlockGroups
+// containing nothing but a Block, ReferenceBlocks and a BlockDuration
+// into one buffer. Several frames in one block are laced the way
+// libmatroska laces them with LACING_AUTO. The result is byte for byte
+// what libmatroska renders for the same elements.
+class kax_cluster_renderer_c {
+protected:
+  // The cluster's head is written in front of its content once the
+  // content's size is known. The buffer starts with enough room for
+  // it.
+  std::vector<unsigned char> m_buffer;
+
+public:
+  typedef std::vector<memory_c const *> frames_t;
+
+public:
+  // Blocks store their timecode relative to the cluster's timecode as
+  // a signed 16bit integer in units of the timecode scale.
+  static bool is_relative_timecode_valid(int64_t relative_timecode);
+
+  void start(uint64_t cluster_timecode);
+
+  // All of them return the position of the SimpleBlock or of the
+  // group's Block relative to the start of the cluster's content as
+  // required for CueRelativePosition.
+  uint64_t add_simple_block(unsigned int track_num, int16_t relative_timecode, bool key_frame, bool discardable, memory_c const &data);
+  uint64_t add_simple_block(unsigned int track_num, int16_t relative_timecode, bool key_frame, bool discardable, frames_t const &frames);
+  uint64_t add_block_group(unsigned int track_num, int16_t relative_timecode, memory_c const &data, std::vector<int64_t> const &references, int64_t duration = -1);
+  uint64_t add_block_group(unsigned int track_num, int16_t relative_timecode, frames_t const &frames, std::vector<int64_t> const &references, int64_t duration = -1);
+
+  // Writes the whole cluster including its head and returns the
+  // number of bytes written.
+  uint64_t finish(mm_io_c &out);
+};
+
+#endif  // MTX_COMMON_KAX_CLUSTER_RENDERER_H
@@ -29,7 +29,6 @@ kax_file_c::kax_file_c(mm_io_cptr &in)
   : m_in(in)
   , m_resynced(false)
   , m_resync_start_pos(0)
-  , m_file_size(m_in->get_size())
   , m_timecode_scale{TIMECODE_SCALE}
   , m_last_timecode{-1}
   , m_es(new EbmlStream(*m_in))
@@ -106,7 +105,7 @@ kax_file_c::read_next_level1_element_internal(uint32_t wanted_id) {
 
       if (m_debug_read_next)
         mxinfo(boost::format("kax_file::read_next_level1_element(): other level 1 element %1% new pos %2% fsize %3% epos %4% esize %5%\n")
-               % EBML_NAME(l1)  % (l1->GetElementPosition() + element_size) % m_file_size
+               % EBML_NAME(l1)  % (l1->GetElementPosition() + element_size) % m_in->get_size()
                % l1->GetElementPosition() % element_size);
 
       delete l1;
@@ -201,7 +200,8 @@ kax_file_c::resync_to_level1_element_internal(uint32_t wanted_id) {
   if (m_debug_resync)
     mxinfo(boost::format("kax_file::resync_to_level1_element(): starting at %1% potential ID %|2$08x|\n") % m_resync_start_pos % actual_id);
 
-  while (m_in->getFilePointer() < m_file_size) {
+  // Files that are being followed may still grow while searching.
+  while (m_in->wait_for_size(m_in->getFilePointer() + 1)) {
     int64_t now = get_current_time_millis();
     if ((now - start_time) >= 10000) {
       mxinfo(boost::format("Still resyncing at position %1%.\n") % m_in->getFilePointer());
@@ -237,7 +237,7 @@ kax_file_c::resync_to_level1_element_internal(uint32_t wanted_id) {
         }
 
         if (   !length.is_valid()
-            || ((element_pos + length.m_value + length.m_coded_size + 2 * 4) >= m_file_size)
+            || !m_in->wait_for_size(element_pos + length.m_value + length.m_coded_size + 2 * 4 + 1)
             || !m_in->setFilePointer2(element_pos + 4 + length.m_value + length.m_coded_size, seek_beginning))
           break;
 
@@ -28,7 +28,7 @@ class kax_file_c {
 protected:
   mm_io_cptr m_in;
   bool m_resynced;
-  uint64_t m_resync_start_pos, m_file_size;
+  uint64_t m_resync_start_pos;
   int64_t m_timecode_scale, m_last_timecode;
   std::shared_ptr<EbmlStream> m_es;
 
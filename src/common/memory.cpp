@@ -16,6 +16,10 @@
 #include "common/memory.h"
 #include "common/error.h"
 
+// How often prepend() put data in front of existing content in place
+// and how often it had to copy that content, and how many bytes of it.
+static uint64_t s_num_prepends_in_place = 0, s_num_prepends_copied = 0, s_bytes_not_copied = 0, s_bytes_copied = 0;
+
 void
 memory_c::resize(size_t new_size)
   throw()
@@ -29,10 +33,11 @@ memory_c::resize(size_t new_size)
 
   } else {
     X *tmp = (X *)safemalloc(new_size);
-    memcpy(tmp, its_counter->ptr + its_counter->offset, its_counter->size - its_counter->offset);
+    memcpy(tmp, its_counter->ptr + its_counter->offset, std::min(new_size, its_counter->size - its_counter->offset));
     its_counter->ptr     = tmp;
     its_counter->is_free = true;
     its_counter->size    = new_size;
+    its_counter->offset  = 0;
   }
 }
 
@@ -47,6 +52,45 @@ memory_c::add(unsigned char const *new_buffer,
   memcpy(get_buffer() + previous_size, new_buffer, new_size);
 }
 
+void
+memory_c::prepend(unsigned char const *new_buffer,
+                  size_t new_size) {
+  if ((0 == new_size) || !new_buffer)
+    return;
+
+  size_t previous_size = get_size();
+
+  if (get_headroom() >= new_size) {
+    its_counter->offset -= new_size;
+    memcpy(get_buffer(), new_buffer, new_size);
+
+    ++s_num_prepends_in_place;
+    s_bytes_not_copied += previous_size;
+
+    return;
+  }
+
+  ++s_num_prepends_copied;
+  s_bytes_copied += previous_size;
+
+  X *tmp               = (X *)safemalloc(new_size + previous_size);
+  memcpy(tmp, new_buffer, new_size);
+  if (previous_size)
+    memcpy(tmp + new_size, get_buffer(), previous_size);
+
+  release();
+  its_counter = new counter(tmp, new_size + previous_size, true);
+}
+
+void
+show_memory_prepend_statistics() {
+  static debugging_option_c s_debug{"memory_prepend"};
+
+  mxdebug_if(s_debug,
+             boost::format("memory_c::prepend(): %1% times in place (%2% bytes not copied), %3% times copied (%4% bytes copied)\n")
+             % s_num_prepends_in_place % s_bytes_not_copied % s_num_prepends_copied % s_bytes_copied);
+}
+
 memory_cptr
 lace_memory_xiph(const std::vector<memory_cptr> &blocks) {
   size_t i, size = 1;
@@ -125,7 +125,15 @@ public:
 
   void set_size(size_t new_size) throw() {
     if (its_counter)
-      its_counter->size = new_size;
+      its_counter->size = new_size + its_counter->offset;
+  }
+
+  size_t get_offset() const throw() {
+    return its_counter ? its_counter->offset : 0;
+  }
+
+  size_t get_headroom() const throw() {
+    return is_free() && is_unique() ? its_counter->offset : 0;
   }
 
   void set_offset(size_t new_offset) {
@@ -170,21 +178,25 @@ public:
   void add(memory_cptr const &new_buffer) {
     add(new_buffer->get_buffer(), new_buffer->get_size());
   }
+  void prepend(unsigned char const *new_buffer, size_t new_size);
+  void prepend(memory_cptr const &new_buffer) {
+    prepend(new_buffer->get_buffer(), new_buffer->get_size());
+  }
 
   operator const unsigned char *() const {
-    return its_counter ? its_counter->ptr : nullptr;
+    return get_buffer();
   }
 
   operator const void *() const {
-    return its_counter ? its_counter->ptr : nullptr;
+    return get_buffer();
   }
 
   operator unsigned char *() const {
-    return its_counter ? its_counter->ptr : nullptr;
+    return get_buffer();
   }
 
   operator void *() const {
-    return its_counter ? its_counter->ptr : nullptr;
+    return get_buffer();
   }
 
   bool operator ==(memory_c const &cmp) const {
@@ -203,6 +215,16 @@ public:
     return memory_cptr(new memory_c(static_cast<unsigned char *>(safemalloc(size)), size, true));
   };
 
+  // Allocates a buffer with 'headroom' bytes of unused space in front
+  // of its content so that prepend() can fill them in without copying.
+  static memory_cptr
+  alloc(size_t size,
+        size_t headroom) {
+    auto mem = memory_c::alloc(size + headroom);
+    mem->its_counter->offset = headroom;
+    return mem;
+  }
+
   static inline memory_cptr
   clone(const void *buffer,
         size_t size) {
@@ -369,6 +391,8 @@ private:
   memory_slice_cursor_c(const memory_slice_cursor_c &) { }
 };
 
+void show_memory_prepend_statistics();
+
 memory_cptr lace_memory_xiph(const std::vector<memory_cptr> &blocks);
 std::vector<memory_cptr> unlace_memory_xiph(memory_cptr &buffer);
 
@@ -15,6 +15,7 @@
 #include "common/common_pch.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -24,6 +25,12 @@
 #endif
 #include <sys/stat.h>
 #include <sys/types.h>
+#if defined(SYS_WINDOWS)
+# include <io.h>
+#else
+# include <limits.h>
+# include <sys/uio.h>
+#endif
 
 #include "common/endian.h"
 #include "common/error.h"
@@ -108,6 +115,84 @@ mm_file_io_c::_write(const void *buffer,
   return bwritten;
 }
 
+/** \brief Write several buffers with as few system calls as possible
+
+   Small amounts of data are simply handed to stdio which coalesces
+   them in its own buffer. Larger batches are written directly to the
+   file descriptor with \c writev() after stdio's buffer has been
+   flushed.
+*/
+size_t
+mm_file_io_c::_write_vectored(mm_io_vec_t const *vecs,
+                              size_t num_vecs) {
+  static size_t const s_min_writev_size = 64 * 1024;
+#if defined(IOV_MAX)
+  static size_t const s_max_iovecs      = IOV_MAX;
+#else
+  static size_t const s_max_iovecs      = 16;
+#endif
+
+  std::vector<iovec> iovecs;
+  size_t total_size = 0;
+
+  iovecs.reserve(num_vecs);
+  for (auto idx = 0u; idx < num_vecs; ++idx) {
+    if (!vecs[idx].m_size)
+      continue;
+
+    iovecs.push_back(iovec{ const_cast<void *>(vecs[idx].m_buffer), vecs[idx].m_size });
+    total_size += vecs[idx].m_size;
+  }
+
+  if ((2 > iovecs.size()) || (s_min_writev_size > total_size))
+    return mm_io_c::_write_vectored(vecs, num_vecs);
+
+  // Make sure the file descriptor's position matches ours and that no
+  // data is left in stdio's buffer.
+  if (fseeko((FILE *)m_file, m_current_position, SEEK_SET) != 0)
+    throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+
+  auto fd            = fileno((FILE *)m_file);
+  size_t written     = 0;
+  size_t current_vec = 0;
+
+  while (current_vec < iovecs.size()) {
+    auto result = writev(fd, &iovecs[current_vec], std::min(iovecs.size() - current_vec, s_max_iovecs));
+    if ((0 > result) && (EINTR == errno))
+      continue;
+    if (0 >= result)
+      break;
+
+    written += result;
+
+    // Skip the buffers written completely; adjust a partially written one.
+    while ((0 < result) && (current_vec < iovecs.size())) {
+      auto &vec = iovecs[current_vec];
+      if (static_cast<size_t>(result) >= vec.iov_len) {
+        result -= vec.iov_len;
+        ++current_vec;
+
+      } else {
+        vec.iov_base  = static_cast<char *>(vec.iov_base) + result;
+        vec.iov_len  -= result;
+        result        = 0;
+      }
+    }
+  }
+
+  auto error          = mtx::mm_io::make_error_code();
+  m_current_position += written;
+  m_cached_size       = -1;
+
+  // Tell stdio where we are now.
+  fseeko((FILE *)m_file, m_current_position, SEEK_SET);
+
+  if (written != total_size)
+    throw mtx::mm_io::read_write_x{error};
+
+  return written;
+}
+
 uint32
 mm_file_io_c::_read(void *buffer,
                     size_t size) {
@@ -131,12 +216,35 @@ mm_file_io_c::eof() {
   return feof((FILE *)m_file) != 0;
 }
 
+void
+mm_file_io_c::flush() {
+  if (m_file)
+    fflush((FILE *)m_file);
+}
+
 int
 mm_file_io_c::truncate(int64_t pos) {
   m_cached_size = -1;
   return ftruncate(fileno((FILE *)m_file), pos);
 }
 
+/** \brief Ask the OS to start reading a range of the file in the background
+
+   This is only a hint. It returns immediately, and the data will
+   hopefully already be in the page cache once it's actually read.
+*/
+void
+mm_file_io_c::prefetch(uint64_t offset,
+                       uint64_t size) {
+#if defined(POSIX_FADV_WILLNEED)
+  if (m_file)
+    posix_fadvise(fileno((FILE *)m_file), offset, size, POSIX_FADV_WILLNEED);
+#else
+  (void)offset;
+  (void)size;
+#endif
+}
+
 /** \brief OS and kernel dependant setup
 */
 void
@@ -509,6 +617,28 @@ mm_io_c::write(const memory_cptr &buffer,
   return size;
 }
 
+size_t
+mm_io_c::write_vectored(mm_io_vec_t const *vecs,
+                        size_t num_vecs) {
+  return _write_vectored(vecs, num_vecs);
+}
+
+size_t
+mm_io_c::_write_vectored(mm_io_vec_t const *vecs,
+                         size_t num_vecs) {
+  size_t written = 0;
+
+  for (auto idx = 0u; idx < num_vecs; ++idx) {
+    auto bytes_written  = write(vecs[idx].m_buffer, vecs[idx].m_size);
+    written            += bytes_written;
+
+    if (bytes_written != vecs[idx].m_size)
+      break;
+  }
+
+  return written;
+}
+
 void
 mm_io_c::skip(int64 num_bytes) {
   uint64_t pos = getFilePointer();
@@ -620,6 +750,12 @@ mm_proxy_io_c::_write(const void *buffer,
   return m_proxy_io->write(buffer, size);
 }
 
+size_t
+mm_proxy_io_c::_write_vectored(mm_io_vec_t const *vecs,
+                               size_t num_vecs) {
+  return m_proxy_io->write_vectored(vecs, num_vecs);
+}
+
 /*
    Dummy class for output to /dev/null. Needed for two pass stuff.
 */
@@ -675,6 +811,76 @@ mm_null_io_c::get_file_name()
   return m_file_name;
 }
 
+/*
+   IO callback class for writing to streams that cannot seek
+*/
+
+mm_stream_write_io_c::mm_stream_write_io_c(FILE *stream,
+                                           std::string const &file_name)
+  : m_stream(stream)
+  , m_pos(0)
+  , m_file_name(file_name)
+{
+#if defined(SYS_WINDOWS)
+  _setmode(_fileno(m_stream), _O_BINARY);
+#endif
+}
+
+uint64
+mm_stream_write_io_c::getFilePointer() {
+  return m_pos;
+}
+
+void
+mm_stream_write_io_c::setFilePointer(int64 offset,
+                                     seek_mode mode) {
+  int64_t new_pos = seek_beginning == mode ? offset
+                  : seek_current   == mode ? static_cast<int64_t>(m_pos) + offset
+                  :                          -1;
+
+  if (new_pos != static_cast<int64_t>(m_pos))
+    throw mtx::mm_io::seek_x{std::make_error_code(std::errc::invalid_seek)};
+}
+
+uint32
+mm_stream_write_io_c::_read(void *,
+                            size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x{};
+}
+
+size_t
+mm_stream_write_io_c::_write(const void *buffer,
+                             size_t size) {
+  size_t bytes_written = fwrite(buffer, 1, size, m_stream);
+  if (bytes_written != size)
+    throw mtx::mm_io::read_write_x{mtx::mm_io::make_error_code()};
+
+  m_pos += bytes_written;
+
+  return bytes_written;
+}
+
+void
+mm_stream_write_io_c::flush() {
+  fflush(m_stream);
+}
+
+void
+mm_stream_write_io_c::close() {
+  fflush(m_stream);
+}
+
+bool
+mm_stream_write_io_c::eof() {
+  return false;
+}
+
+std::string
+mm_stream_write_io_c::get_file_name()
+  const {
+  return m_file_name;
+}
+
 /*
    IO callback class working on memory
 */
@@ -25,6 +25,17 @@ using namespace libebml;
 class mm_io_c;
 typedef std::shared_ptr<mm_io_c> mm_io_cptr;
 
+struct mm_io_vec_t {
+  void const *m_buffer;
+  size_t m_size;
+
+  mm_io_vec_t(void const *buffer, size_t size)
+    : m_buffer{buffer}
+    , m_size{size}
+  {
+  }
+};
+
 class mm_io_c: public IOCallback {
 protected:
   bool m_dos_style_newlines;
@@ -73,6 +84,10 @@ public:
     return write(buffer.c_str(), buffer.length());
   }
   virtual size_t write(const memory_cptr &buffer, size_t size = UINT_MAX, size_t offset = 0);
+  virtual size_t write_vectored(mm_io_vec_t const *vecs, size_t num_vecs);
+  size_t write_vectored(std::initializer_list<mm_io_vec_t> vecs) {
+    return write_vectored(vecs.begin(), vecs.size());
+  }
   virtual bool eof() = 0;
   virtual void flush() {
   }
@@ -105,9 +120,23 @@ public:
   virtual void enable_buffering(bool /* enable */) {
   }
 
+  virtual void enable_following(int64_t /* idle_timeout */) {
+  }
+
+  virtual void clear_cached_size() {
+    m_cached_size = -1;
+  }
+
+  // Returns whether the file is at least 'size' bytes long. Files that
+  // are being followed wait for that much data to arrive first.
+  virtual bool wait_for_size(int64_t size) {
+    return get_size() >= size;
+  }
+
 protected:
   virtual uint32 _read(void *buffer, size_t size) = 0;
   virtual size_t _write(const void *buffer, size_t size) = 0;
+  virtual size_t _write_vectored(mm_io_vec_t const *vecs, size_t num_vecs);
 };
 
 class mm_file_io_c: public mm_io_c {
@@ -133,12 +162,16 @@ public:
   virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
   virtual void close();
   virtual bool eof();
+#if !defined(SYS_WINDOWS)
+  virtual void flush();
+#endif
 
   virtual std::string get_file_name() const {
     return m_file_name;
   }
 
   virtual int truncate(int64_t pos);
+  virtual void prefetch(uint64_t offset, uint64_t size);
 
   static void setup();
   static void cleanup();
@@ -147,6 +180,9 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+#if !defined(SYS_WINDOWS)
+  virtual size_t _write_vectored(mm_io_vec_t const *vecs, size_t num_vecs);
+#endif
 };
 
 typedef std::shared_ptr<mm_file_io_c> mm_file_io_cptr;
@@ -186,6 +222,7 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+  virtual size_t _write_vectored(mm_io_vec_t const *vecs, size_t num_vecs);
 };
 
 typedef std::shared_ptr<mm_proxy_io_c> mm_proxy_io_cptr;
@@ -211,6 +248,32 @@ protected:
 
 typedef std::shared_ptr<mm_null_io_c> mm_null_io_cptr;
 
+// Writes binary data to a stream like the standard output which may
+// be connected to a pipe. The position is only tracked; seeking to any
+// other position fails.
+class mm_stream_write_io_c: public mm_io_c {
+protected:
+  FILE *m_stream;
+  uint64_t m_pos;
+  std::string m_file_name;
+
+public:
+  mm_stream_write_io_c(FILE *stream, std::string const &file_name);
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual void flush();
+  virtual void close();
+  virtual bool eof();
+  virtual std::string get_file_name() const;
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+typedef std::shared_ptr<mm_stream_write_io_c> mm_stream_write_io_cptr;
+
 class mm_mem_io_c: public mm_io_c {
 protected:
   size_t m_pos, m_mem_size, m_allocated, m_increase;
@@ -201,6 +201,11 @@ mm_file_io_c::truncate(int64_t pos) {
   return -1;
 }
 
+void
+mm_file_io_c::prefetch(uint64_t,
+                       uint64_t) {
+}
+
 void
 mm_file_io_c::setup() {
 }
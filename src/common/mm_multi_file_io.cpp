@@ -15,17 +15,23 @@
 
 #include <sstream>
 
+#include "common/debugging.h"
 #include "common/mm_io_x.h"
 #include "common/mm_multi_file_io.h"
 #include "common/output.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
 
+// How much of the next file to ask the OS to read ahead once the
+// current file is about to end.
+static uint64_t const s_default_prefetch_size = 8 * 1024 * 1024;
+
 mm_multi_file_io_c::file_t::file_t(const bfs::path &file_name,
+                                   uint64_t size,
                                    uint64_t global_start,
                                    mm_file_io_cptr file)
   : m_file_name(file_name)
-  , m_size(file->get_size())
+  , m_size(size)
   , m_global_start(global_start)
   , m_file(file)
 {
@@ -37,13 +43,33 @@ mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
   , m_total_size(0)
   , m_current_pos(0)
   , m_current_local_pos(0)
+  , m_prefetch_size(s_default_prefetch_size)
   , m_current_file(0)
+  , m_prefetched_file(-1)
+  , m_debug(debugging_requested("multi_file_io|mpls_multi_io"))
 {
+  // Only the first file is opened right away. All others are opened
+  // shortly before the reader reaches them (see
+  // prefetch_next_file_if_needed()). This keeps start-up fast for
+  // playlists with a lot of segments on slow media.
   for (auto &file_name : file_names) {
-    mm_file_io_cptr file(new mm_file_io_c(file_name.string()));
-    m_files.push_back(mm_multi_file_io_c::file_t(file_name, m_total_size, file));
+    mm_file_io_cptr file;
+    uint64_t size;
+
+    if (m_files.empty()) {
+      file = std::make_shared<mm_file_io_c>(file_name.string());
+      size = file->get_size();
+
+    } else {
+      boost::system::error_code ec;
+      size = bfs::file_size(file_name, ec);
+      if (ec)
+        throw mtx::mm_io::open_x{std::error_code(ec.value(), std::system_category())};
+    }
+
+    m_files.push_back(mm_multi_file_io_c::file_t(file_name, size, m_total_size, file));
 
-    m_total_size += file->get_size();
+    m_total_size += size;
   }
 }
 
@@ -76,9 +102,11 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
 
     m_current_pos       = new_pos;
     m_current_local_pos = new_pos - file.m_global_start;
-    file.m_file->setFilePointer(m_current_local_pos, seek_beginning);
+    get_file(m_current_file).setFilePointer(m_current_local_pos, seek_beginning);
     break;
   }
+
+  prefetch_next_file_if_needed();
 }
 
 uint32
@@ -92,7 +120,7 @@ mm_multi_file_io_c::_read(void *buffer,
     size_t num_to_read = static_cast<size_t>(std::min(static_cast<uint64_t>(size) - static_cast<uint64_t>(num_read_total), file.m_size - m_current_local_pos));
 
     if (0 != num_to_read) {
-      size_t num_read      = file.m_file->read(buffer_ptr, num_to_read);
+      size_t num_read      = get_file(m_current_file).read(buffer_ptr, num_to_read);
       num_read_total      += num_read;
       buffer_ptr          += num_read;
       m_current_local_pos += num_read;
@@ -105,13 +133,46 @@ mm_multi_file_io_c::_read(void *buffer,
     if ((m_current_local_pos >= file.m_size) && (m_files.size() > (m_current_file + 1))) {
       ++m_current_file;
       m_current_local_pos = 0;
-      m_files[m_current_file].m_file->setFilePointer(0, seek_beginning);
+      get_file(m_current_file).setFilePointer(0, seek_beginning);
     }
   }
 
+  prefetch_next_file_if_needed();
+
   return num_read_total;
 }
 
+mm_file_io_c &
+mm_multi_file_io_c::get_file(unsigned int idx) {
+  auto &file = m_files[idx];
+  if (!file.m_file) {
+    mxdebug_if(m_debug, boost::format("multi_file_io: opening file %1% (%2%)\n") % idx % file.m_file_name.string());
+    file.m_file = std::make_shared<mm_file_io_c>(file.m_file_name.string());
+  }
+
+  return *file.m_file;
+}
+
+void
+mm_multi_file_io_c::prefetch_next_file_if_needed() {
+  if (m_files.empty())
+    return;
+
+  auto next_idx = m_current_file + 1;
+  if (   (m_files.size() <= next_idx)
+      || (static_cast<int>(next_idx) == m_prefetched_file)
+      || ((m_current_local_pos + m_prefetch_size) < m_files[m_current_file].m_size))
+    return;
+
+  // Open the next file and let the OS warm up its beginning while the
+  // rest of the current file is still being read so that crossing
+  // the boundary doesn't stall.
+  mxdebug_if(m_debug, boost::format("multi_file_io: prefetching %1% bytes of file %2% at global position %3%\n") % m_prefetch_size % next_idx % m_current_pos);
+
+  get_file(next_idx).prefetch(0, std::min(m_prefetch_size, m_files[next_idx].m_size));
+  m_prefetched_file = next_idx;
+}
+
 size_t
 mm_multi_file_io_c::_write(const void *,
                            size_t) {
@@ -121,12 +182,14 @@ mm_multi_file_io_c::_write(const void *,
 void
 mm_multi_file_io_c::close() {
   for (auto &file : m_files)
-    file.m_file->close();
+    if (file.m_file)
+      file.m_file->close();
 
   m_files.clear();
   m_total_size        = 0;
   m_current_pos       = 0;
   m_current_local_pos = 0;
+  m_prefetched_file   = -1;
 }
 
 bool
@@ -168,7 +231,8 @@ mm_multi_file_io_c::display_other_file_info() {
 void
 mm_multi_file_io_c::enable_buffering(bool enable) {
   for (auto &file : m_files)
-    file.m_file->enable_buffering(enable);
+    if (file.m_file)
+      file.m_file->enable_buffering(enable);
 }
 
 struct path_sorter_t {
@@ -28,14 +28,16 @@ protected:
     uint64_t m_size, m_global_start;
     mm_file_io_cptr m_file;
 
-    file_t(const bfs::path &file_name, uint64_t global_start, mm_file_io_cptr file);
+    file_t(const bfs::path &file_name, uint64_t size, uint64_t global_start, mm_file_io_cptr file);
   };
 
 protected:
   std::string m_display_file_name;
-  uint64_t m_total_size, m_current_pos, m_current_local_pos;
+  uint64_t m_total_size, m_current_pos, m_current_local_pos, m_prefetch_size;
   unsigned int m_current_file;
+  int m_prefetched_file;
   std::vector<mm_multi_file_io_c::file_t> m_files;
+  bool m_debug;
 
 public:
   mm_multi_file_io_c(const std::vector<bfs::path> &file_names, const std::string &display_file_name);
@@ -59,6 +61,9 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+
+  virtual mm_file_io_c &get_file(unsigned int idx);
+  virtual void prefetch_next_file_if_needed();
 };
 
 #endif  // MTX_COMMON_MM_MULTI_FILE_IO_H
@@ -14,6 +14,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/fs_sys_helpers.h"
 #include "common/mm_io_x.h"
 #include "common/mm_read_buffer_io.h"
 
@@ -28,9 +29,11 @@ mm_read_buffer_io_c::mm_read_buffer_io_c(mm_io_c *in,
   , m_fill(0)
   , m_offset(0)
   , m_size(buffer_size)
+  , m_follow_timeout(0)
   , m_buffering(true)
   , m_debug_seek(debugging_requested("read_buffer_io") || debugging_requested("read_buffer_io_read"))
   , m_debug_read(debugging_requested("read_buffer_io") || debugging_requested("read_buffer_io_read"))
+  , m_debug_follow(debugging_requested("read_buffer_io") || debugging_requested("read_buffer_io_follow"))
 {
   setFilePointer(0, seek_beginning);
 }
@@ -86,11 +89,12 @@ mm_read_buffer_io_c::setFilePointer(int64 offset,
 
   int64_t previous_pos = m_proxy_io->getFilePointer();
 
-  // Actual seeking
+  // Actual seeking. A file that is still growing may already contain
+  // data beyond the size determined earlier, so don't clamp then.
   if (new_pos < 0)
     m_proxy_io->setFilePointer(offset, seek_end);
   else
-    m_proxy_io->setFilePointer(std::min(new_pos, get_size()), seek_beginning);
+    m_proxy_io->setFilePointer(m_follow_timeout ? new_pos : std::min(new_pos, get_size()), seek_beginning);
 
   // Get the actual offset from the underlying stream
   // Better be safe than sorry and use this instead of just taking
@@ -131,7 +135,12 @@ mm_read_buffer_io_c::_read(void *buffer,
       m_offset += m_cursor;
       m_cursor  = 0;
       m_fill    = 0;
-      avail     = std::min(get_size() - m_offset, static_cast<int64_t>(m_size));
+
+      int64_t remaining = get_size() - m_offset;
+      if ((0 >= remaining) && m_follow_timeout && wait_for_more_data(m_offset))
+        remaining = get_size() - m_offset;
+
+      avail = std::max<int64_t>(std::min(remaining, static_cast<int64_t>(m_size)), 0);
 
       if (!avail) {
         // must keep track of eof, as m_proxy_io->eof() will never be reached
@@ -162,6 +171,56 @@ mm_read_buffer_io_c::_write(const void *,
   return 0;
 }
 
+/** \brief Keep reading from a file that is still being written to
+
+   Instead of reporting the end of the file as soon as all data present
+   has been read, wait for the file to grow. The end of the file is only
+   reported once its size hasn't changed for \c idle_timeout
+   milliseconds. Passing 0 turns following off again.
+*/
+void
+mm_read_buffer_io_c::enable_following(int64_t idle_timeout) {
+  m_follow_timeout = std::max<int64_t>(idle_timeout, 0);
+}
+
+bool
+mm_read_buffer_io_c::wait_for_size(int64_t size) {
+  // Every time the file grows the idle timeout starts anew.
+  while (get_size() < size)
+    if (!m_follow_timeout || !wait_for_more_data(get_size()))
+      return false;
+
+  return true;
+}
+
+// Waits until the file is larger than 'size' bytes. Returns false if
+// it hasn't grown within the idle timeout.
+bool
+mm_read_buffer_io_c::wait_for_more_data(int64_t size) {
+  auto idle_since = get_current_time_millis();
+
+  mxdebug_if(m_debug_follow, boost::format("waiting for data beyond position %1%\n") % size);
+
+  while (true) {
+    m_proxy_io->clear_cached_size();
+    auto new_size = get_size();
+
+    if (new_size > size) {
+      mxdebug_if(m_debug_follow, boost::format("file grew to %1% after %2% ms\n") % new_size % (get_current_time_millis() - idle_since));
+      return true;
+    }
+
+    if ((get_current_time_millis() - idle_since) >= m_follow_timeout)
+      break;
+
+    sleep_millis(std::min<int64_t>(m_follow_timeout, 100));
+  }
+
+  mxdebug_if(m_debug_follow, boost::format("no new data for %1% ms; assuming the end of the file\n") % m_follow_timeout);
+
+  return false;
+}
+
 void
 mm_read_buffer_io_c::enable_buffering(bool enable) {
   m_buffering = enable;
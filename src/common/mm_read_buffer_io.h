@@ -28,7 +28,8 @@ protected:
   size_t m_fill;
   int64_t m_offset;
   const size_t m_size;
-  bool m_buffering, m_debug_seek, m_debug_read;
+  int64_t m_follow_timeout;
+  bool m_buffering, m_debug_seek, m_debug_read, m_debug_follow;
 
 public:
   mm_read_buffer_io_c(mm_io_c *in, size_t buffer_size = 1 << 12, bool delete_in = true);
@@ -39,10 +40,13 @@ public:
   virtual int64_t get_size();
   inline virtual bool eof() { return m_eof; }
   virtual void enable_buffering(bool enable);
+  virtual void enable_following(int64_t idle_timeout);
+  virtual bool wait_for_size(int64_t size);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+  virtual bool wait_for_more_data(int64_t size);
 };
 
 typedef std::shared_ptr<mm_read_buffer_io_c> mm_read_buffer_io_cptr;
@@ -122,6 +122,46 @@ mm_write_buffer_io_c::_write(const void *buffer,
   return size;
 }
 
+/** \brief Write several buffers at once
+
+   Pieces that still fit into the buffer are copied into it so that
+   small headers get coalesced. A piece that doesn't fit bypasses the
+   buffer: it is handed to the underlying I/O together with the data
+   buffered so far in a single vectored write.
+*/
+size_t
+mm_write_buffer_io_c::_write_vectored(mm_io_vec_t const *vecs,
+                                      size_t num_vecs) {
+  size_t written = 0;
+
+  for (auto idx = 0u; idx < num_vecs; ++idx) {
+    auto &vec = vecs[idx];
+
+    if ((m_fill + vec.m_size) <= m_size) {
+      memcpy(m_buffer + m_fill, vec.m_buffer, vec.m_size);
+      m_fill  += vec.m_size;
+      written += vec.m_size;
+      continue;
+    }
+
+    mm_io_vec_t pieces[2] = { { m_buffer, m_fill }, vec };
+    auto num_pieces       = m_fill ? 2u : 1u;
+    auto to_write         = m_fill + vec.m_size;
+    auto bytes_written    = m_proxy_io->write_vectored(&pieces[2 - num_pieces], num_pieces);
+
+    mxdebug_if(m_debug_write, boost::format("write_vectored() at %1% buffered %2% direct %3% written %4%\n") % (mm_proxy_io_c::getFilePointer() - bytes_written) % m_fill % vec.m_size % bytes_written);
+
+    m_fill = 0;
+
+    if (bytes_written != to_write)
+      throw mtx::mm_io::insufficient_space_x();
+
+    written += vec.m_size;
+  }
+
+  return written;
+}
+
 void
 mm_write_buffer_io_c::flush_buffer() {
   if (!m_fill)
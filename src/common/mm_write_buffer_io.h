@@ -41,6 +41,7 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+  virtual size_t _write_vectored(mm_io_vec_t const *vecs, size_t num_vecs);
   virtual void flush_buffer();
 };
 typedef std::shared_ptr<mm_write_buffer_io_c> mm_write_buffer_io_cptr;
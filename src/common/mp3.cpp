@@ -12,7 +12,9 @@
 */
 
 #include "common/common_pch.h"
+#include "common/endian.h"
 #include "common/mp3.h"
+#include "common/sync_word.h"
 
 // Synch word for a frame is 0xFFE0 (first 11 bits must be set)
 // Frame valuable information (for parsing) are stored in the first 4 bytes :
@@ -124,50 +126,76 @@ static int mp3_samples_per_channel[3][3] = {
   {384, 1152, 576}
 };
 
+static bool
+is_mp3_frame_header(unsigned long header) {
+  return ((header & 0xffe00000) == 0xffe00000)
+      && (((header >> 17) & 3)   != 0)
+      && (((header >> 12) & 0xf) != 0xf)
+      && (((header >> 12) & 0xf) != 0)
+      && (((header >> 10) & 0x3) != 0x3)
+      && (((header >> 19) & 3)   != 0x1)
+      && ((header & 0xffff0000)  != 0xfffe0000);
+}
+
+// Returns the position of the first "ID3" or "TAG" in the first 'end'
+// positions of 'buf' or -1 if there's none. 'buf' must contain at
+// least 'end + 2' bytes.
+static int
+find_mp3_tag(const unsigned char *buf,
+             int end) {
+  int found = -1;
+
+  for (auto const &tag : { "ID3", "TAG" }) {
+    auto ptr = buf;
+    while (ptr < (buf + end)) {
+      ptr = static_cast<const unsigned char *>(memchr(ptr, tag[0], buf + end - ptr));
+      if (!ptr)
+        break;
+
+      if ((ptr[1] == tag[1]) && (ptr[2] == tag[2])) {
+        if ((-1 == found) || ((ptr - buf) < found))
+          found = ptr - buf;
+        break;
+      }
+
+      ++ptr;
+    }
+  }
+
+  return found;
+}
+
 int
 find_mp3_header(const unsigned char *buf,
                 int size) {
-  int i, pos;
-  unsigned long header;
-
   if (size < 4)
     return -1;
 
-  for (pos = 0; pos < (size - 4); pos++) {
-    if ((buf[pos] == 'I') && (buf[pos + 1] == 'D') && (buf[pos + 2] == '3')) {
-      if ((pos + 10) >= size)
-        return -1;
-
-      return pos;
-    }
-    if ((buf[pos] == 'T') && (buf[pos + 1] == 'A') && (buf[pos + 2] == 'G'))
-      return pos;
+  // Frame headers are located via their sync word; only the positions
+  // before the first frame header have to be searched for tags.
+  int frame_pos = -1, pos = 0;
+  while (pos < (size - 4)) {
+    int candidate = mtx::sync_word::find_16(&buf[pos], size - 3 - pos, 0xffe0, 0xffe0);
+    if (0 > candidate)
+      break;
 
-    for (i = 0, header = 0; i < 4; i++) {
-      header <<= 8;
-      header |= buf[i + pos];
+    pos += candidate;
+    if (is_mp3_frame_header(get_uint32_be(&buf[pos]))) {
+      frame_pos = pos;
+      break;
     }
 
-    if (header == FOURCC('R', 'I', 'F', 'F'))
-      continue;
-
-    if ((header & 0xffe00000) != 0xffe00000)
-      continue;
-    if (((header >> 17) & 3) == 0)
-      continue;
-    if (((header >> 12) & 0xf) == 0xf)
-      continue;
-    if (((header >> 12) & 0xf) == 0)
-      continue;
-    if (((header >> 10) & 0x3) == 0x3)
-      continue;
-    if (((header >> 19) & 3) == 0x1)
-      continue;
-    if ((header & 0xffff0000) == 0xfffe0000)
-      continue;
-    return pos;
+    ++pos;
   }
-  return -1;
+
+  int tag_pos = find_mp3_tag(buf, -1 == frame_pos ? size - 4 : frame_pos);
+  if (-1 == tag_pos)
+    return frame_pos;
+
+  if (('I' == buf[tag_pos]) && ((tag_pos + 10) >= size))
+    return -1;
+
+  return tag_pos;
 }
 
 bool
@@ -235,6 +263,34 @@ decode_mp3_header(const unsigned char *buf,
   return true;
 }
 
+// Returns the position of the first decodable frame header at or after
+// 'base' or -1 if there's none. Tags are skipped as a whole. A header
+// that cannot be decoded only skips its first byte so that the scan
+// resumes right after it instead of starting over.
+static int
+find_next_mp3_frame(const unsigned char *buf,
+                    int size,
+                    int base,
+                    mp3_header_t &header) {
+  while (base < size) {
+    int pos = find_mp3_header(&buf[base], size - base);
+    if (0 > pos)
+      return -1;
+
+    base         += pos;
+    auto decoded  = decode_mp3_header(&buf[base], &header);
+    if (decoded && !header.is_tag)
+      return base;
+
+    if (decoded)
+      mxverb(4, boost::format("mp3_reader: Found tag at %1% size %2%\n") % base % header.framesize);
+
+    base += decoded ? std::max<int>(header.framesize, 1) : 1;
+  }
+
+  return -1;
+}
+
 int
 find_consecutive_mp3_headers(const unsigned char *buf,
                              int size,
@@ -243,24 +299,15 @@ find_consecutive_mp3_headers(const unsigned char *buf,
   int i, pos, base, offset;
   mp3_header_t mp3header, new_header;
 
-  base = 0;
-  do {
-    // Let's find the first non-tag header.
-    pos = find_mp3_header(&buf[base], size - base);
-    if (pos < 0)
-      return -1;
-    if (decode_mp3_header(&buf[base + pos], &mp3header) && !mp3header.is_tag)
-      break;
-    mxverb(4, boost::format("mp3_reader: Found tag at %1% size %2%\n") % (base + pos) % mp3header.framesize);
-    base += mp3header.framesize;
-  } while (true);
+  base = find_next_mp3_frame(buf, size, 0, mp3header);
+  if (0 > base)
+    return -1;
 
   if (num == 1) {
     if (header_found)
       memcpy(header_found, &mp3header, sizeof(mp3_header_t));
-    return pos;
+    return base;
   }
-  base += pos;
 
   do {
     mxverb(4, boost::format("find_cons_mp3_h: starting with base at %1%\n") % base);
@@ -268,7 +315,9 @@ find_consecutive_mp3_headers(const unsigned char *buf,
     for (i = 0; i < (num - 1); i++) {
       if ((size - base - offset) < 4)
         break;
-      pos = find_mp3_header(&buf[base + offset], size - base - offset);
+      // Only look for a header right at this position instead of
+      // scanning the rest of the buffer.
+      pos = find_mp3_header(&buf[base + offset], std::min(size - base - offset, 11));
       if ((pos == 0) && decode_mp3_header(&buf[base + offset], &new_header)) {
         if (   (new_header.version            == mp3header.version)
             && (new_header.layer              == mp3header.layer)
@@ -287,14 +336,10 @@ find_consecutive_mp3_headers(const unsigned char *buf,
         memcpy(header_found, &mp3header, sizeof(mp3_header_t));
       return base;
     }
-    base++;
-    offset = 0;
-    pos    = find_mp3_header(&buf[base], size - base);
-    if (pos == -1)
-      return -1;
-    decode_mp3_header(&buf[base + pos], &mp3header);
-    base += pos;
-  } while (base < (size - 5));
+
+    // Resume right after the header the chain started with.
+    base = find_next_mp3_frame(buf, size, base + 1, mp3header);
+  } while ((0 <= base) && (base < (size - 5)));
 
   return -1;
 }
@@ -24,6 +24,7 @@
 #include "common/bit_cursor.h"
 #include "common/byte_buffer.h"
 #include "common/checksums.h"
+#include "common/cpu_kernels.h"
 #include "common/endian.h"
 #include "common/hacks.h"
 #include "common/math.h"
@@ -31,6 +32,10 @@
 #include "common/mpeg4_p10.h"
 #include "common/strings/formatting.h"
 
+#if defined(MTX_CPU_X86)
+# include <emmintrin.h>
+#endif
+
 namespace mpeg4 {
 namespace p10 {
 
@@ -452,26 +457,102 @@ mpeg4::p10::slice_info_t::dump()
          % pps);
 }
 
-void
-mpeg4::p10::nalu_to_rbsp(memory_cptr &buffer) {
-  int pos, size = buffer->get_size();
-  mm_mem_io_c d(nullptr, size, 100);
-  unsigned char *b = buffer->get_buffer();
+namespace mpeg4 { namespace p10 {
 
-  for (pos = 0; pos < size; ++pos) {
+static size_t
+nalu_to_rbsp_scalar(unsigned char const *src,
+                    size_t size,
+                    unsigned char *dst) {
+  auto out = dst;
+  auto pos = static_cast<size_t>(0);
+
+  while (pos < size) {
     if (   ((pos + 2) < size)
-        && (0 == b[pos])
-        && (0 == b[pos + 1])
-        && (3 == b[pos + 2])) {
-      d.write_uint8(0);
-      d.write_uint8(0);
-      pos += 2;
+        && (0 == src[pos])
+        && (0 == src[pos + 1])
+        && (3 == src[pos + 2])) {
+      *out++  = 0;
+      *out++  = 0;
+      pos    += 3;
 
     } else
-      d.write_uint8(b[pos]);
+      *out++ = src[pos++];
   }
 
-  buffer = memory_cptr(new memory_c(d.get_and_lock_buffer(), d.getFilePointer(), true));
+  return out - dst;
+}
+
+#if defined(MTX_CPU_X86)
+
+// Emulation prevention bytes can only follow two zero bytes. Blocks of
+// 16 bytes without any zero byte are copied as a whole. Otherwise
+// everything up to the first zero byte is copied, and the scalar rules
+// are applied to that byte. As 'out' never gets ahead of 'pos' the full
+// 16 byte stores stay within 'dst'.
+static MTX_TARGET("sse2") size_t
+nalu_to_rbsp_sse2(unsigned char const *src,
+                  size_t size,
+                  unsigned char *dst) {
+  auto const zero = _mm_setzero_si128();
+  auto out        = dst;
+  auto pos        = static_cast<size_t>(0);
+
+  while ((pos + 16) <= size) {
+    auto bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&src[pos]));
+    auto zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), bytes);
+
+    if (!zeros) {
+      out += 16;
+      pos += 16;
+      continue;
+    }
+
+    auto num_non_zero  = __builtin_ctz(zeros);
+    out               += num_non_zero;
+    pos               += num_non_zero;
+
+    if (   ((pos + 2) < size)
+        && (0 == src[pos + 1])
+        && (3 == src[pos + 2])) {
+      *out++  = 0;
+      *out++  = 0;
+      pos    += 3;
+
+    } else
+      *out++ = src[pos++];
+  }
+
+  return (out - dst) + nalu_to_rbsp_scalar(&src[pos], size - pos, out);
+}
+
+#endif  // MTX_CPU_X86
+
+mtx::cpu::kernel_c<nalu_to_rbsp_fn> const &
+nalu_to_rbsp_kernel() {
+  static mtx::cpu::kernel_c<nalu_to_rbsp_fn> s_kernel{"nalu_to_rbsp", {
+    { "scalar", mtx::cpu::FEATURE_NONE, nalu_to_rbsp_scalar },
+#if defined(MTX_CPU_X86)
+    { "sse2",   mtx::cpu::FEATURE_SSE2, nalu_to_rbsp_sse2   },
+#endif
+  }};
+
+  return s_kernel;
+}
+
+}}
+
+void
+mpeg4::p10::nalu_to_rbsp(memory_cptr &buffer) {
+  auto size = buffer->get_size();
+  if (!size)
+    return;
+
+  auto rbsp = memory_c::alloc(size);
+  rbsp->set_size(nalu_to_rbsp_kernel()(buffer->get_buffer(), size, rbsp->get_buffer()));
+
+  buffer = rbsp;
 }
 
 void
@@ -1028,7 +1109,7 @@ mpeg4::p10::avc_es_parser_c::add_bytes(unsigned char *buffer,
       if (0 != marker_size) {
         if (-1 != previous_pos) {
           int new_size = cursor.get_position() - marker_size - previous_pos - previous_marker_size;
-          memory_cptr nalu(new memory_c(safemalloc(new_size), new_size, true));
+          auto nalu = memory_c::alloc(new_size, m_nalu_size_length + NALU_EXTRA_DATA_HEADROOM);
           cursor.copy(nalu->get_buffer(), previous_pos + previous_marker_size, new_size);
           m_parsed_position = previous_parsed_pos + previous_pos;
           handle_nalu(nalu);
@@ -1066,7 +1147,10 @@ mpeg4::p10::avc_es_parser_c::flush() {
   if (m_unparsed_buffer && (5 <= m_unparsed_buffer->get_size())) {
     m_parsed_position += m_unparsed_buffer->get_size();
     int marker_size = get_uint32_be(m_unparsed_buffer->get_buffer()) == NALU_START_CODE ? 4 : 3;
-    handle_nalu(memory_c::clone(m_unparsed_buffer->get_buffer() + marker_size, m_unparsed_buffer->get_size() - marker_size));
+    auto nalu_size  = m_unparsed_buffer->get_size() - marker_size;
+    auto nalu       = memory_c::alloc(nalu_size, m_nalu_size_length + NALU_EXTRA_DATA_HEADROOM);
+    memcpy(nalu->get_buffer(), m_unparsed_buffer->get_buffer() + marker_size, nalu_size);
+    handle_nalu(nalu);
   }
 
   m_unparsed_buffer.reset();
@@ -1666,28 +1750,37 @@ mpeg4::p10::avc_es_parser_c::cleanup() {
 memory_cptr
 mpeg4::p10::avc_es_parser_c::create_nalu_with_size(const memory_cptr &src,
                                                    bool add_extra_data) {
-  int final_size = m_nalu_size_length + src->get_size(), offset = 0, size;
-  unsigned char *buffer;
-
   if (add_extra_data) {
+    // A frame's first slice is prefixed with the parameter sets and
+    // SEIs preceding it and with its own size field. Slices are
+    // allocated with room for them so that prepend() can usually put
+    // them in place without copying the slice.
+    size_t prefix_size = m_nalu_size_length;
     for (auto &mem : m_extra_data)
-      final_size += mem->get_size();
-    buffer = (unsigned char *)safemalloc(final_size);
+      prefix_size += mem->get_size();
+
+    auto prefix   = memory_c::alloc(prefix_size);
+    size_t offset = 0;
 
     for (auto &mem : m_extra_data) {
-      memcpy(buffer + offset, mem->get_buffer(), mem->get_size());
+      memcpy(prefix->get_buffer() + offset, mem->get_buffer(), mem->get_size());
       offset += mem->get_size();
     }
 
+    write_nalu_size(prefix->get_buffer() + offset, src->get_size());
+    src->prepend(prefix);
     m_extra_data.clear();
-  } else
-    buffer = (unsigned char *)safemalloc(final_size);
 
-  size = src->get_size();
-  write_nalu_size(buffer + offset, size);
-  memcpy(buffer + offset + m_nalu_size_length, src->get_buffer(), size);
+    return src;
+  }
+
+  int size    = src->get_size();
+  auto buffer = memory_c::alloc(m_nalu_size_length + size);
+
+  write_nalu_size(buffer->get_buffer(), size);
+  memcpy(buffer->get_buffer() + m_nalu_size_length, src->get_buffer(), size);
 
-  return memory_cptr(new memory_c(buffer, final_size, true));
+  return buffer;
 }
 
 memory_cptr
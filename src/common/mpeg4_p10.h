@@ -21,6 +21,10 @@
 
 #define NALU_START_CODE 0x00000001
 
+// Room reserved in front of each NALU read from an elementary stream
+// for the parameter sets and SEIs preceding a frame's first slice.
+#define NALU_EXTRA_DATA_HEADROOM 256
+
 #define NALU_TYPE_NON_IDR_SLICE  0x01
 #define NALU_TYPE_DP_A_SLICE     0x02
 #define NALU_TYPE_DP_B_SLICE     0x03
@@ -0,0 +1,71 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   search for sync words in audio elementary streams
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <cstring>
+
+#include "common/sync_word.h"
+
+namespace mtx { namespace sync_word {
+
+template<unsigned int num_bytes>
+static int
+find_masked(unsigned char const *buffer,
+            size_t size,
+            uint32_t value,
+            uint32_t mask) {
+  assert(0xff == ((mask >> ((num_bytes - 1) * 8)) & 0xff));
+
+  if (size < num_bytes)
+    return -1;
+
+  auto first_byte = static_cast<unsigned char>(value >> ((num_bytes - 1) * 8));
+  auto ptr        = buffer;
+  auto last       = buffer + size - num_bytes;
+
+  while (ptr <= last) {
+    ptr = static_cast<unsigned char const *>(std::memchr(ptr, first_byte, last - ptr + 1));
+    if (!ptr)
+      return -1;
+
+    uint32_t word = 0;
+    for (auto idx = 0u; idx < num_bytes; ++idx)
+      word = (word << 8) | ptr[idx];
+
+    if ((word & mask) == value)
+      return ptr - buffer;
+
+    ++ptr;
+  }
+
+  return -1;
+}
+
+int
+find_16(unsigned char const *buffer,
+        size_t size,
+        uint16_t value,
+        uint16_t mask) {
+  return find_masked<2>(buffer, size, value, mask);
+}
+
+int
+find_32(unsigned char const *buffer,
+        size_t size,
+        uint32_t value,
+        uint32_t mask) {
+  return find_masked<4>(buffer, size, value, mask);
+}
+
+}}
@@ -0,0 +1,34 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   search for sync words in audio elementary streams
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_SYNC_WORD_H
+#define MTX_COMMON_SYNC_WORD_H
+
+#include "common/common_pch.h"
+
+namespace mtx { namespace sync_word {
+
+// Find the first position 'pos' in 'buffer' for which the big endian
+// 16 resp. 32 bit value starting at 'pos' and masked with 'mask' equals
+// 'value'. The most significant byte of 'mask' must be 0xff. Only the
+// positions at which that byte occurs are looked at; they are located
+// with memchr() which all common C libraries implement with SIMD
+// instructions.
+//
+// Returns -1 if no such position exists.
+int find_16(unsigned char const *buffer, size_t size, uint16_t value, uint16_t mask = 0xffff);
+int find_32(unsigned char const *buffer, size_t size, uint32_t value, uint32_t mask = 0xffffffff);
+
+}}
+
+#endif // MTX_COMMON_SYNC_WORD_H
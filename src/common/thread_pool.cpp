@@ -0,0 +1,70 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a fixed size pool of worker threads
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/thread_pool.h"
+
+thread_pool_c::thread_pool_c(unsigned int num_threads)
+  : m_stopping(false)
+{
+  if (!num_threads)
+    num_threads = get_num_cpu_cores();
+
+  for (auto idx = 0u; idx < num_threads; ++idx)
+    m_threads.emplace_back([this]() { run_worker(); });
+}
+
+thread_pool_c::~thread_pool_c() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+
+  m_condition.notify_all();
+
+  // A worker can only end up here if a task exits the program. It
+  // cannot join itself.
+  for (auto &thread : m_threads)
+    if (thread.get_id() == std::this_thread::get_id())
+      thread.detach();
+    else
+      thread.join();
+}
+
+void
+thread_pool_c::run_worker() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+      // Tasks still queued when the pool is destroyed are dropped. Their
+      // futures report a broken promise.
+      if (m_stopping)
+        return;
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+unsigned int
+thread_pool_c::get_num_cpu_cores() {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
@@ -0,0 +1,66 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a fixed size pool of worker threads
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_THREAD_POOL_H
+#define MTX_COMMON_THREAD_POOL_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+class thread_pool_c {
+protected:
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping;
+
+public:
+  // 0 threads means one per CPU core.
+  explicit thread_pool_c(unsigned int num_threads = 0);
+  virtual ~thread_pool_c();
+
+  size_t get_num_threads() const {
+    return m_threads.size();
+  }
+
+  // Queues 'task' for execution by one of the workers. Exceptions
+  // thrown by the task are stored in the returned future.
+  template<typename T>
+  std::future<T>
+  enqueue(std::function<T()> const &task) {
+    auto packaged = std::make_shared<std::packaged_task<T()>>(task);
+    auto result   = packaged->get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push_back([packaged]() { (*packaged)(); });
+    }
+
+    m_condition.notify_one();
+
+    return result;
+  }
+
+  static unsigned int get_num_cpu_cores();
+
+protected:
+  void run_worker();
+};
+
+#endif  // MTX_COMMON_THREAD_POOL_H
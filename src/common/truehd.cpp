@@ -16,6 +16,7 @@
 #include "common/ac3.h"
 #include "common/endian.h"
 #include "common/memory.h"
+#include "common/sync_word.h"
 #include "common/truehd.h"
 
 truehd_parser_c::truehd_parser_c()
@@ -168,13 +169,14 @@ truehd_parser_c::resync(unsigned int offset) {
 
   m_sync_state              = state_unsynced;
 
-  for (offset = offset + 4; (offset + 4) < size; ++offset) {
-    uint32_t sync_word = get_uint32_be(&data[offset]);
-    if ((TRUEHD_SYNC_WORD == sync_word) || (MLP_SYNC_WORD == sync_word)) {
-      m_sync_state  = state_synced;
-      return offset - 4;
-    }
-  }
+  // TRUEHD_SYNC_WORD and MLP_SYNC_WORD only differ in the lowest bit.
+  if ((offset + 8) >= size)
+    return 0;
+
+  int sync_pos = mtx::sync_word::find_32(&data[offset + 4], size - offset - 5, TRUEHD_SYNC_WORD, 0xfffffffe);
+  if (0 > sync_pos)
+    return 0;
 
-  return 0;
+  m_sync_state = state_synced;
+  return offset + sync_pos;
 }
@@ -52,12 +52,11 @@ vint_c::is_valid() {
 vint_c
 vint_c::read(mm_io_c *in,
              vint_c::read_mode_e read_mode) {
-  int64_t pos       = in->getFilePointer();
-  int64_t file_size = in->get_size();
-  int mask          = 0x80;
-  int value_len      = 1;
+  int64_t pos   = in->getFilePointer();
+  int mask      = 0x80;
+  int value_len = 1;
 
-  if (pos >= file_size)
+  if (!in->wait_for_size(pos + 1))
     return vint_c();
 
   unsigned char first_byte = in->read_uint8();
@@ -70,7 +69,7 @@ vint_c::read(mm_io_c *in,
     value_len++;
   }
 
-  if ((pos + value_len) > file_size)
+  if (!in->wait_for_size(pos + value_len))
     return vint_c();
 
   if (   (rm_ebml_id == read_mode)
@@ -43,8 +43,7 @@ xtr_avc_c::write_nal(const binary *data,
     return false;
   }
 
-  m_out->write(s_start_code, 4);
-  m_out->write(data + pos, nal_size);
+  m_out->write_vectored({ { s_start_code, 4 }, { data + pos, nal_size } });
 
   pos += nal_size;
 
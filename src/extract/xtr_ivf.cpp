@@ -86,8 +86,7 @@ xtr_ivf_c::handle_frame(memory_cptr &frame,
   put_uint32_le(&frame_header.frame_size, frame->get_size());
   put_uint32_le(&frame_header.timestamp,  frame_number);
 
-  m_out->write(&frame_header,       sizeof(frame_header));
-  m_out->write(frame->get_buffer(), frame->get_size());
+  m_out->write_vectored({ { &frame_header, sizeof(frame_header) }, { frame->get_buffer(), frame->get_size() } });
 
   ++m_frame_count;
 }
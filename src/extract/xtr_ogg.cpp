@@ -154,8 +154,7 @@ xtr_oggbase_c::flush_pages() {
   ogg_page page;
 
   while (ogg_stream_flush(&m_os, &page)) {
-    m_out->write(page.header, page.header_len);
-    m_out->write(page.body,   page.body_len);
+    m_out->write_vectored({ { page.header, static_cast<size_t>(page.header_len) }, { page.body, static_cast<size_t>(page.body_len) } });
   }
 }
 
@@ -164,8 +163,7 @@ xtr_oggbase_c::write_pages() {
   ogg_page page;
 
   while (ogg_stream_pageout(&m_os, &page)) {
-    m_out->write(page.header, page.header_len);
-    m_out->write(page.body,   page.body_len);
+    m_out->write_vectored({ { page.header, static_cast<size_t>(page.header_len) }, { page.body, static_cast<size_t>(page.body_len) } });
   }
 }
 
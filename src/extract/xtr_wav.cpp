@@ -154,21 +154,18 @@ xtr_wavpack4_c::handle_frame(memory_cptr &frame,
     uint32_t block_size = get_uint32_le(&mybuffer[12]);
 
     put_uint32_le(&wv_header[4], block_size + 24);  // ck_size
-    m_out->write(wv_header, 32);
     flags.push_back(*(uint32_t *)&mybuffer[4]);
     mybuffer += 16;
-    m_out->write(mybuffer, block_size);
+    m_out->write_vectored({ { wv_header, 32 }, { mybuffer, block_size } });
     mybuffer  += block_size;
     data_size -= block_size + 16;
     while (0 < data_size) {
       block_size = get_uint32_le(&mybuffer[8]);
       memcpy(&wv_header[24], mybuffer, 8);
       put_uint32_le(&wv_header[4], block_size + 24);
-      m_out->write(wv_header, 32);
-
       flags.push_back(*(uint32_t *)mybuffer);
       mybuffer += 12;
-      m_out->write(mybuffer, block_size);
+      m_out->write_vectored({ { wv_header, 32 }, { mybuffer, block_size } });
 
       mybuffer  += block_size;
       data_size -= block_size + 12;
@@ -176,8 +173,7 @@ xtr_wavpack4_c::handle_frame(memory_cptr &frame,
 
   } else {
     put_uint32_le(&wv_header[4], data_size + 12); // ck_size
-    m_out->write(wv_header, 32);
-    m_out->write(&mybuffer[12], data_size - 12); // the rest of the
+    m_out->write_vectored({ { wv_header, 32 }, { &mybuffer[12], static_cast<size_t>(data_size - 12) } }); // the rest of the
   }
 
   // support hybrid mode data
@@ -203,9 +199,8 @@ xtr_wavpack4_c::handle_frame(memory_cptr &frame,
         put_uint32_le(&wv_header[4], block_size + 24); // ck_size
         memcpy(&wv_header[24], &flags[flags_index++], 4); // flags
         memcpy(&wv_header[28], mybuffer, 4); // crc
-        m_corr_out->write(wv_header, 32);
         mybuffer += 8;
-        m_corr_out->write(mybuffer, block_size);
+        m_corr_out->write_vectored({ { wv_header, 32 }, { mybuffer, block_size } });
         mybuffer += block_size;
         data_size -= 8 + block_size;
       }
@@ -213,8 +208,7 @@ xtr_wavpack4_c::handle_frame(memory_cptr &frame,
     } else {
       put_uint32_le(&wv_header[4], data_size + 20); // ck_size
       memcpy(&wv_header[28], mybuffer, 4); // crc
-      m_corr_out->write(wv_header, 32);
-      m_corr_out->write(&mybuffer[4], data_size - 4);
+      m_corr_out->write_vectored({ { wv_header, 32 }, { &mybuffer[4], static_cast<size_t>(data_size - 4) } });
     }
   }
 }
@@ -44,6 +44,7 @@ info_cli_parser_c::init_parser() {
   OPT("x|hexdump",      set_hexdump,      YT("Show the first 16 bytes of each frame as a hex dump."));
   OPT("X|full-hexdump", set_full_hexdump, YT("Show all bytes of each frame as a hex dump."));
   OPT("z|size",         set_size,         YT("Show the size of each element including its header."));
+  OPT("F|fast-scan",    set_fast_scan,    YT("Only parse the block headers inside clusters and skip over the frame contents. Checksums and hex dumps are not available in this mode."));
 
   add_common_options();
 
@@ -101,6 +102,11 @@ info_cli_parser_c::set_track_info() {
     verbose = 1;
 }
 
+void
+info_cli_parser_c::set_fast_scan() {
+  m_options.m_fast_scan = true;
+}
+
 void
 info_cli_parser_c::set_file_name() {
   if (!m_options.m_file_name.empty())
@@ -117,5 +123,12 @@ info_cli_parser_c::run() {
   m_options.m_verbose = verbose;
   verbose             = 0;
 
+  if (m_options.m_fast_scan) {
+    if (m_options.m_show_hexdump)
+      mxerror(Y("The options '--fast-scan' and '--hexdump'/'--full-hexdump' are mutually exclusive.\n"));
+
+    m_options.m_calc_checksums = false;
+  }
+
   return m_options;
 }
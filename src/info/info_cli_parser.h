@@ -38,6 +38,7 @@ protected:
   void set_size();
   void set_file_name();
   void set_track_info();
+  void set_fast_scan();
 };
 
 #endif // MTX_INFO_INFO_CLI_PARSER_H
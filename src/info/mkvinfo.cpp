@@ -82,6 +82,7 @@
 #include "common/strings/formatting.h"
 #include "common/translation.h"
 #include "common/version.h"
+#include "common/vint.h"
 #include "common/xml/ebml_chapters_converter.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "info/mkvinfo.h"
@@ -182,6 +183,8 @@ size_t s_mkvmerge_track_id = 0;
 #define BF_CODEC_STATE                       BF_DO(30)
 #define BF_AT                                BF_DO(31)
 #define BF_SIZE                              BF_DO(32)
+#define BF_FAST_BLOCK_SUMMARY_WITH_DURATION  BF_DO(33)
+#define BF_FAST_BLOCK_SUMMARY_NO_DURATION    BF_DO(34)
 
 void
 init_common_boost_formats() {
@@ -218,6 +221,8 @@ init_common_boost_formats() {
   BF_ADD(Y("Codec state: %1%"));                                                                                // 30 -- BF_CODEC_STATE
   BF_ADD(Y(" at %1%"));                                                                                         // 31 -- BF_AT
   BF_ADD(Y(" size %1%"));                                                                                       // 32 -- BF_SIZE
+  BF_ADD(Y("%1% frame, track %2%, timecode %3% (%4%), duration %|5$.3f|, size %6%%7%\n"));                     // 33 -- BF_FAST_BLOCK_SUMMARY_WITH_DURATION
+  BF_ADD(Y("%1% frame, track %2%, timecode %3% (%4%), size %5%%6%\n"));                                         // 34 -- BF_FAST_BLOCK_SUMMARY_NO_DURATION
 }
 
 std::string
@@ -1127,6 +1132,35 @@ handle_silent_track(EbmlStream *&es,
       show_unknown_element(l3, 3);
 }
 
+// Shared by the normal and the fast scanning mode so that both report
+// the same track statistics.
+static void
+add_track_statistics(uint64_t track_num,
+                     char frame_type,
+                     int64_t timecode,
+                     size_t num_frames,
+                     int64_t size,
+                     double duration) {
+  track_info_t &tinfo = s_track_info[track_num];
+
+  tinfo.m_blocks                                                              += num_frames;
+  tinfo.m_blocks_by_ref_num['I' == frame_type ? 0 : 'B' == frame_type ? 2 : 1] += num_frames;
+  tinfo.m_min_timecode                                                          = std::min(tinfo.m_min_timecode, timecode);
+  tinfo.m_size                                                                 += size;
+
+  if (!tinfo.max_timecode_unset() && (tinfo.m_max_timecode >= timecode))
+    return;
+
+  tinfo.m_max_timecode = timecode;
+
+  if (-1.0 == duration)
+    tinfo.m_add_duration_for_n_packets  = num_frames;
+  else {
+    tinfo.m_max_timecode               += duration * 1000000.0;
+    tinfo.m_add_duration_for_n_packets  = 0;
+  }
+}
+
 void
 handle_block_group(EbmlStream *&es,
                    EbmlElement *&l2,
@@ -1306,24 +1340,7 @@ handle_block_group(EbmlStream *&es,
                  % lf_tnum
                  % (lf_timecode / 1000000));
 
-  track_info_t &tinfo = s_track_info[lf_tnum];
-
-  tinfo.m_blocks                                                                                 += frame_sizes.size();
-  tinfo.m_blocks_by_ref_num[bref_found && fref_found ? 2 : bref_found ? 1 : !fref_found ? 0 : 1] += frame_sizes.size();
-  tinfo.m_min_timecode                                                                             = std::min(tinfo.m_min_timecode, lf_timecode);
-  tinfo.m_size                                                                                    += boost::accumulate(frame_sizes, 0);
-
-  if (!tinfo.max_timecode_unset() && (tinfo.m_max_timecode >= lf_timecode))
-    return;
-
-  tinfo.m_max_timecode = lf_timecode;
-
-  if (-1 == bduration)
-    tinfo.m_add_duration_for_n_packets  = frame_sizes.size();
-  else {
-    tinfo.m_max_timecode               += bduration * 1000000.0;
-    tinfo.m_add_duration_for_n_packets  = 0;
-  }
+  add_track_statistics(lf_tnum, bref_found && fref_found ? 'B' : bref_found ? 'P' : !fref_found ? 'I' : 'P', lf_timecode, frame_sizes.size(), boost::accumulate(frame_sizes, 0), bduration);
 }
 
 void
@@ -1338,7 +1355,6 @@ handle_simple_block(EbmlStream *&es,
 
   int64_t frame_pos   = block.GetElementPosition() + block.ElementSize();
   uint64_t timecode   = block.GlobalTimecode() / 1000000;
-  track_info_t &tinfo = s_track_info[block.TrackNum()];
 
   std::string info;
   if (block.IsKeyframe())
@@ -1359,8 +1375,6 @@ handle_simple_block(EbmlStream *&es,
     DataBuffer &data = block.GetBuffer(i);
     uint32_t adler   = calc_adler32(data.Buffer(), data.Size());
 
-    tinfo.m_size += data.Size();
-
     std::string adler_str;
     if (g_options.m_calc_checksums)
       adler_str = (BF_SIMPLE_BLOCK_ADLER % adler).str();
@@ -1403,12 +1417,33 @@ handle_simple_block(EbmlStream *&es,
                  % block.TrackNum()
                  % timecode);
 
-  tinfo.m_blocks                                                                    += block.NumberFrames();
-  tinfo.m_blocks_by_ref_num[block.IsKeyframe() ? 0 : block.IsDiscardable() ? 2 : 1] += block.NumberFrames();
-  tinfo.m_min_timecode                                                                = std::min(tinfo.m_min_timecode, static_cast<int64_t>(block.GlobalTimecode()));
-  tinfo.m_max_timecode                                                                = std::max(tinfo.m_min_timecode, static_cast<int64_t>(block.GlobalTimecode()));
-  tinfo.m_add_duration_for_n_packets                                                  = block.NumberFrames();
-  tinfo.m_size                                                                       += boost::accumulate(frame_sizes, 0);
+  add_track_statistics(block.TrackNum(), block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P', block.GlobalTimecode(), block.NumberFrames(), boost::accumulate(frame_sizes, 0), -1.0);
+}
+
+void
+handle_cluster_child(EbmlStream *&es,
+                     EbmlElement *&l2,
+                     KaxCluster *&cluster) {
+  if (is_id(l2, KaxClusterTimecode))
+    show_element(l2, 2, BF_CLUSTER_TIMECODE      % (static_cast<double>(static_cast<KaxClusterTimecode *>(l2)->GetValue()) * s_tc_scale / 1000000000.0));
+
+  else if (is_id(l2, KaxClusterPosition))
+    show_element(l2, 2, BF_CLUSTER_POSITION      % static_cast<KaxClusterPosition *>(l2)->GetValue());
+
+  else if (is_id(l2, KaxClusterPrevSize))
+    show_element(l2, 2, BF_CLUSTER_PREVIOUS_SIZE % static_cast<KaxClusterPrevSize *>(l2)->GetValue());
+
+  else if (is_id(l2, KaxClusterSilentTracks))
+    handle_silent_track(es, l2);
+
+  else if (is_id(l2, KaxBlockGroup))
+    handle_block_group(es, l2, cluster);
+
+  else if (is_id(l2, KaxSimpleBlock))
+    handle_simple_block(es, l2, cluster);
+
+  else if (!is_global(es, l2, 2))
+    show_unknown_element(l2, 2);
 }
 
 void
@@ -1429,26 +1464,388 @@ handle_cluster(EbmlStream *&es,
   cluster->InitTimecode(FindChildValue<KaxClusterTimecode>(m1), s_tc_scale);
 
   for (auto l2 : *m1)
-    if (is_id(l2, KaxClusterTimecode))
-      show_element(l2, 2, BF_CLUSTER_TIMECODE      % (static_cast<double>(static_cast<KaxClusterTimecode *>(l2)->GetValue()) * s_tc_scale / 1000000000.0));
+    handle_cluster_child(es, l2, cluster);
+}
 
-    else if (is_id(l2, KaxClusterPosition))
-      show_element(l2, 2, BF_CLUSTER_POSITION      % static_cast<KaxClusterPosition *>(l2)->GetValue());
+// Fast scanning mode: only the block headers inside clusters are
+// parsed with vint_c; the frame contents are skipped by seeking over
+// them. All other cluster children as well as block groups containing
+// anything but a block, its duration and references are read with
+// libebml and shown by the normal mode's functions.
+
+struct fast_block_t {
+  uint64_t track_num;
+  int64_t timecode, first_frame_pos;
+  unsigned char flags;
+  std::vector<int64_t> frame_sizes;
+};
 
-    else if (is_id(l2, KaxClusterPrevSize))
-      show_element(l2, 2, BF_CLUSTER_PREVIOUS_SIZE % static_cast<KaxClusterPrevSize *>(l2)->GetValue());
+static void
+show_fast_element(int level,
+                  std::string const &info,
+                  int64_t position,
+                  int64_t size) {
+  if (!g_options.m_show_summary)
+    ui_show_element(level, info, position, size);
+}
 
-    else if (is_id(l2, KaxClusterSilentTracks))
-      handle_silent_track(es, l2);
+// Integers wider than 64 bits are invalid. Elements with such sizes
+// are left to the normal parser; read_fast_uint() doesn't read them.
+static bool
+is_fast_uint_size(int64_t size) {
+  return (0 <= size) && (8 >= size);
+}
 
-    else if (is_id(l2, KaxBlockGroup))
-      handle_block_group(es, l2, cluster);
+static uint64_t
+read_fast_uint(mm_io_c &in,
+               int64_t size) {
+  if (!is_fast_uint_size(size))
+    return 0;
 
-    else if (is_id(l2, KaxSimpleBlock))
-      handle_simple_block(es, l2, cluster);
+  uint64_t value = 0;
+  for (int64_t idx = 0; idx < size; ++idx)
+    value = (value << 8) | in.read_uint8();
 
-    else if (!is_global(es, l2, 2))
-      show_unknown_element(l2, 2);
+  return value;
+}
+
+static int64_t
+read_fast_int(mm_io_c &in,
+              int64_t size) {
+  uint64_t value = read_fast_uint(in, size);
+  if ((0 < size) && (8 > size) && (value & (1ull << (size * 8 - 1))))
+    value |= ~((1ull << (size * 8)) - 1);
+
+  return static_cast<int64_t>(value);
+}
+
+static bool
+read_fast_block_header(mm_io_c &in,
+                       int64_t data_size,
+                       int64_t cluster_timecode,
+                       fast_block_t &block) {
+  int64_t data_start = in.getFilePointer();
+  auto track         = vint_c::read(&in);
+  if (!track.is_valid())
+    return false;
+
+  block.track_num = track.m_value;
+  block.timecode  = (cluster_timecode + static_cast<int16_t>(in.read_uint16_be())) * static_cast<int64_t>(s_tc_scale);
+  block.flags     = in.read_uint8();
+  block.frame_sizes.clear();
+
+  auto lacing        = (block.flags >> 1) & 0x03;
+  size_t num_frames  = 0 == lacing ? 1 : in.read_uint8() + 1;
+  int64_t laced_size = 0;
+
+  if (1 == lacing) {            // Xiph lacing
+    for (size_t idx = 0; (idx + 1) < num_frames; ++idx) {
+      int64_t frame_size = 0;
+      unsigned char byte;
+      do {
+        byte        = in.read_uint8();
+        frame_size += byte;
+      } while (0xff == byte);
+
+      block.frame_sizes.push_back(frame_size);
+      laced_size += frame_size;
+    }
+
+  } else if ((3 == lacing) && (1 < num_frames)) { // EBML lacing
+    auto first_size = vint_c::read(&in);
+    if (!first_size.is_valid())
+      return false;
+
+    int64_t frame_size = first_size.m_value;
+    block.frame_sizes.push_back(frame_size);
+    laced_size += frame_size;
+
+    for (size_t idx = 2; idx < num_frames; ++idx) {
+      auto difference = vint_c::read(&in);
+      if (!difference.is_valid())
+        return false;
+
+      frame_size += difference.m_value - ((1ll << (7 * difference.m_coded_size - 1)) - 1);
+      if (0 > frame_size)
+        return false;
+
+      block.frame_sizes.push_back(frame_size);
+      laced_size += frame_size;
+    }
+  }
+
+  int64_t header_size    = in.getFilePointer() - data_start;
+  int64_t remaining_size = data_size - header_size - laced_size;
+  if (0 > remaining_size)
+    return false;
+
+  if (2 == lacing)              // fixed-size lacing
+    block.frame_sizes.resize(num_frames, remaining_size / num_frames);
+  else
+    block.frame_sizes.push_back(remaining_size);
+
+  block.first_frame_pos = data_start + header_size;
+
+  return true;
+}
+
+static void
+handle_fast_block_statistics(fast_block_t const &block,
+                             char frame_type,
+                             double duration) {
+  if (g_options.m_show_summary) {
+    int64_t frame_pos = block.first_frame_pos;
+
+    for (auto frame_size : block.frame_sizes) {
+      std::string position;
+      if (1 <= g_options.m_verbose)
+        position = (BF_BLOCK_GROUP_SUMMARY_POSITION % frame_pos).str();
+      frame_pos += frame_size;
+
+      if (-1.0 != duration)
+        mxinfo(BF_FAST_BLOCK_SUMMARY_WITH_DURATION
+               % frame_type
+               % block.track_num
+               % (block.timecode / 1000000)
+               % format_timecode(block.timecode, 3)
+               % duration
+               % frame_size
+               % position);
+      else
+        mxinfo(BF_FAST_BLOCK_SUMMARY_NO_DURATION
+               % frame_type
+               % block.track_num
+               % (block.timecode / 1000000)
+               % format_timecode(block.timecode, 3)
+               % frame_size
+               % position);
+    }
+
+  } else if (g_options.m_verbose > 2)
+    show_fast_element(2, (BF_BLOCK_GROUP_SUMMARY_V2 % frame_type % block.track_num % (block.timecode / 1000000)).str(), -1, -1);
+
+  add_track_statistics(block.track_num, frame_type, block.timecode, block.frame_sizes.size(), boost::accumulate(block.frame_sizes, static_cast<int64_t>(0)), duration);
+}
+
+static void
+show_fast_block_frames(fast_block_t const &block,
+                       int level) {
+  for (auto frame_size : block.frame_sizes)
+    show_fast_element(level, (BF_SIMPLE_BLOCK_FRAME % frame_size % "" % "").str(), -1, -1);
+}
+
+static void
+handle_simple_block_fast(mm_io_c &in,
+                         int64_t element_pos,
+                         int64_t element_end,
+                         int64_t cluster_timecode) {
+  fast_block_t block;
+  if (!read_fast_block_header(in, element_end - in.getFilePointer(), cluster_timecode, block))
+    return;
+
+  bool is_keyframe    = 0x80 == (block.flags & 0x80);
+  bool is_discardable = 0x01 == (block.flags & 0x01);
+
+  std::string info;
+  if (is_keyframe)
+    info = Y("key, ");
+  if (is_discardable)
+    info += Y("discardable, ");
+
+  show_fast_element(2,
+                    (BF_SIMPLE_BLOCK_BASICS
+                     % info
+                     % block.track_num
+                     % block.frame_sizes.size()
+                     % (static_cast<double>(block.timecode) / 1000000000.0)
+                     % format_timecode(block.timecode, 3)).str(),
+                    element_pos, element_end - element_pos);
+  show_fast_block_frames(block, 3);
+
+  handle_fast_block_statistics(block, is_keyframe ? 'I' : is_discardable ? 'B' : 'P', -1.0);
+}
+
+static bool
+is_block_group_fast_scannable(mm_io_c &in,
+                              int64_t group_end) {
+  static std::vector<uint32_t> const s_fast_ids{ EBML_ID_VALUE(EBML_ID(KaxBlock)), EBML_ID_VALUE(EBML_ID(KaxBlockDuration)), EBML_ID_VALUE(EBML_ID(KaxReferenceBlock)) };
+  static std::vector<uint32_t> const s_int_ids{ EBML_ID_VALUE(EBML_ID(KaxBlockDuration)), EBML_ID_VALUE(EBML_ID(KaxReferenceBlock)) };
+
+  int64_t group_start = in.getFilePointer();
+  bool scannable      = true;
+
+  while (scannable && (in.getFilePointer() < static_cast<uint64_t>(group_end))) {
+    auto id   = vint_c::read_ebml_id(&in);
+    auto size = vint_c::read(&in);
+
+    scannable = id.is_valid() && size.is_valid() && !size.is_unknown() && (brng::find(s_fast_ids, id.m_value) != s_fast_ids.end())
+             && ((brng::find(s_int_ids, id.m_value) == s_int_ids.end()) || is_fast_uint_size(size.m_value));
+    if (scannable)
+      in.setFilePointer(in.getFilePointer() + size.m_value);
+  }
+
+  in.setFilePointer(group_start);
+
+  return scannable;
+}
+
+static void
+handle_cluster_child_fully(mm_io_c &in,
+                           int64_t element_pos,
+                           int64_t cluster_timecode) {
+  in.setFilePointer(element_pos);
+
+  EbmlStream stream(in);
+  EbmlStream *es   = &stream;
+  int upper_lvl_el = 0;
+  EbmlElement *l2  = es->FindNextElement(EBML_CLASS_CONTEXT(KaxCluster), upper_lvl_el, 0xFFFFFFFFL, true);
+
+  if (!l2)
+    return;
+
+  std::shared_ptr<EbmlElement> af_l2(l2);
+  EbmlElement *element_found = nullptr;
+  upper_lvl_el               = 0;
+  l2->Read(*es, EBML_CONTEXT(l2), upper_lvl_el, element_found, true);
+
+  KaxCluster cluster;
+  auto cluster_ptr = &cluster;
+  cluster.InitTimecode(cluster_timecode, s_tc_scale);
+
+  handle_cluster_child(es, l2, cluster_ptr);
+}
+
+static void
+handle_block_group_fast(mm_io_c &in,
+                        int64_t group_pos,
+                        int64_t group_end,
+                        int64_t cluster_timecode) {
+  show_fast_element(2, Y("Block group"), group_pos, group_end - group_pos);
+
+  fast_block_t block;
+  bool block_found = false, bref_found = false, fref_found = false;
+  double bduration = -1.0;
+
+  while (in.getFilePointer() < static_cast<uint64_t>(group_end)) {
+    int64_t element_pos = in.getFilePointer();
+    auto id             = vint_c::read_ebml_id(&in);
+    auto size           = vint_c::read(&in);
+
+    if (!id.is_valid() || !size.is_valid() || size.is_unknown())
+      break;
+
+    int64_t element_end = in.getFilePointer() + size.m_value;
+
+    if (EBML_ID_VALUE(EBML_ID(KaxBlock)) == id.m_value) {
+      block_found = read_fast_block_header(in, size.m_value, cluster_timecode, block);
+      if (block_found) {
+        show_fast_element(3,
+                          (BF_BLOCK_GROUP_BLOCK_BASICS
+                           % block.track_num
+                           % block.frame_sizes.size()
+                           % (static_cast<double>(block.timecode) / 1000000000.0)
+                           % format_timecode(block.timecode, 3)).str(),
+                          element_pos, element_end - element_pos);
+        show_fast_block_frames(block, 4);
+      }
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxBlockDuration)) == id.m_value) {
+      auto duration = read_fast_uint(in, size.m_value);
+      bduration     = static_cast<double>(duration) * s_tc_scale / 1000000.0;
+      show_fast_element(3, (BF_BLOCK_GROUP_DURATION % (duration * s_tc_scale / 1000000) % (duration * s_tc_scale % 1000000)).str(), element_pos, element_end - element_pos);
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxReferenceBlock)) == id.m_value) {
+      int64_t reference = read_fast_int(in, size.m_value) * static_cast<int64_t>(s_tc_scale);
+
+      if (0 >= reference) {
+        bref_found  = true;
+        reference  *= -1;
+        show_fast_element(3, (BF_BLOCK_GROUP_REFERENCE_1 % (reference / 1000000) % (reference % 1000000)).str(), element_pos, element_end - element_pos);
+
+      } else {
+        fref_found = true;
+        show_fast_element(3, (BF_BLOCK_GROUP_REFERENCE_2 % (reference / 1000000) % (reference % 1000000)).str(), element_pos, element_end - element_pos);
+      }
+    }
+
+    in.setFilePointer(element_end);
+  }
+
+  in.setFilePointer(group_end);
+
+  if (block_found)
+    handle_fast_block_statistics(block, bref_found && fref_found ? 'B' : bref_found ? 'P' : !fref_found ? 'I' : 'P', bduration);
+}
+
+static bool
+is_cluster_next(mm_io_c &in) {
+  int64_t pos = in.getFilePointer();
+  auto id     = vint_c::read_ebml_id(&in);
+  in.setFilePointer(pos);
+
+  return id.is_valid() && (EBML_ID_VALUE(EBML_ID(KaxCluster)) == id.m_value);
+}
+
+// Returns false without having consumed anything if the cluster's
+// size is invalid. The normal parser has to deal with it then.
+static bool
+handle_cluster_fast(mm_io_c &in,
+                    kax_file_c &kax_file,
+                    int64_t file_size) {
+  int64_t cluster_pos = in.getFilePointer();
+  vint_c::read_ebml_id(&in);
+  auto size           = vint_c::read(&in);
+
+  if (!size.is_valid()) {
+    in.setFilePointer(cluster_pos);
+    return false;
+  }
+
+  int64_t data_start  = in.getFilePointer();
+  int64_t cluster_end = size.is_unknown() ? file_size : std::min<int64_t>(data_start + size.m_value, file_size);
+
+  show_fast_element(1, Y("Cluster"), cluster_pos, size.is_unknown() ? -2 : cluster_end - cluster_pos);
+
+  if (g_options.m_use_gui)
+    ui_show_progress(100 * cluster_pos / file_size, Y("Parsing file"));
+
+  int64_t cluster_timecode = 0;
+
+  while (in.getFilePointer() < static_cast<uint64_t>(cluster_end)) {
+    int64_t element_pos = in.getFilePointer();
+    auto id             = vint_c::read_ebml_id(&in);
+    auto element_size   = vint_c::read(&in);
+
+    if (!id.is_valid() || !element_size.is_valid() || element_size.is_unknown())
+      break;
+
+    // Clusters of unknown size end at the next level 1 element.
+    if (size.is_unknown() && kax_file.is_level1_element_id(id)) {
+      in.setFilePointer(element_pos);
+      return true;
+    }
+
+    int64_t element_end = std::min<int64_t>(in.getFilePointer() + element_size.m_value, cluster_end);
+
+    if ((EBML_ID_VALUE(EBML_ID(KaxClusterTimecode)) == id.m_value) && is_fast_uint_size(element_size.m_value)) {
+      cluster_timecode = read_fast_uint(in, element_size.m_value);
+      show_fast_element(2, (BF_CLUSTER_TIMECODE % (static_cast<double>(cluster_timecode) * s_tc_scale / 1000000000.0)).str(), element_pos, element_end - element_pos);
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxSimpleBlock)) == id.m_value)
+      handle_simple_block_fast(in, element_pos, element_end, cluster_timecode);
+
+    else if ((EBML_ID_VALUE(EBML_ID(KaxBlockGroup)) == id.m_value) && is_block_group_fast_scannable(in, element_end))
+      handle_block_group_fast(in, element_pos, element_end, cluster_timecode);
+
+    else
+      handle_cluster_child_fully(in, element_pos, cluster_timecode);
+
+    in.setFilePointer(element_end);
+  }
+
+  in.setFilePointer(cluster_end);
+
+  return true;
 }
 
 void
@@ -1656,7 +2053,18 @@ process_file(const std::string &file_name) {
     // Prevent reporting "first timecode after resync":
     kax_file->set_timecode_scale(-1);
 
-    while ((l1 = kax_file->read_next_level1_element())) {
+    bool fast_scan_clusters = g_options.m_fast_scan && (g_options.m_show_summary || (0 < g_options.m_verbose));
+
+    while (true) {
+      if (fast_scan_clusters && is_cluster_next(*in) && handle_cluster_fast(*in, *kax_file, file_size)) {
+        if (!in_parent(l0))
+          break;
+        continue;
+      }
+
+      if (!(l1 = kax_file->read_next_level1_element()))
+        break;
+
       std::shared_ptr<EbmlElement> af_l1(l1);
 
       if (is_id(l1, KaxInfo))
@@ -92,6 +92,8 @@ avi_reader_c::avi_reader_c(const track_info_c &ti,
   , m_bytes_to_process(0)
   , m_bytes_processed(0)
   , m_video_track_ok(false)
+  , m_next_chunk(0)
+  , m_read_sequentially(false)
 {
 }
 
@@ -380,6 +382,87 @@ avi_reader_c::create_packetizers() {
 
   for (i = 0; static_cast<int>(m_subtitle_demuxers.size()) > i; ++i)
     create_subs_packetizer(i);
+
+  setup_sequential_reading();
+}
+
+/** \brief Decide whether or not the chunks can be read in file order
+
+   Reading each track on its own via avilib's index means seeking back
+   and forth between the tracks' chunks all the time. If the tracks are
+   interleaved reasonably well then it is much cheaper to walk the
+   chunks once in the order they're stored in and to hand each one to
+   its packetizer. Badly interleaved files would require queueing huge
+   amounts of data, though. Those are still read track by track.
+*/
+void
+avi_reader_c::setup_sequential_reading() {
+  auto debug = debugging_requested("avi_sequential_reading");
+
+  m_chunks.clear();
+  m_next_chunk        = 0;
+  m_read_sequentially = false;
+
+  std::vector<unsigned int> num_chunks;
+
+  if (-1 != m_vptzr) {
+    for (auto idx = m_video_frames_read; idx < m_max_video_frames; ++idx)
+      m_chunks.emplace_back(m_avi->video_index[idx].pos, m_avi->video_index[idx].len, -1, idx);
+    num_chunks.push_back(m_max_video_frames - m_video_frames_read);
+  }
+
+  for (int demuxer_idx = 0; static_cast<int>(m_audio_demuxers.size()) > demuxer_idx; ++demuxer_idx) {
+    auto &demuxer = m_audio_demuxers[demuxer_idx];
+    if (-1 == demuxer.m_ptzr) {
+      num_chunks.push_back(0);
+      continue;
+    }
+
+    AVI_set_audio_track(m_avi, demuxer.m_aid);
+
+    auto &track = m_avi->track[demuxer.m_aid];
+    auto start  = std::max<long>(AVI_get_audio_position_index(m_avi), 0);
+
+    for (auto idx = start; idx < track.audio_chunks; ++idx)
+      m_chunks.emplace_back(track.audio_index[idx].pos, track.audio_index[idx].len, demuxer_idx, idx);
+    num_chunks.push_back(std::max<long>(track.audio_chunks - start, 0));
+  }
+
+  if (m_chunks.empty())
+    return;
+
+  std::stable_sort(m_chunks.begin(), m_chunks.end(), [](avi_chunk_t const &a, avi_chunk_t const &b) { return a.m_pos < b.m_pos; });
+
+  // Determine how far the tracks drift apart when read in file
+  // order. The progress of each track is the fraction of its chunks
+  // already seen.
+  std::vector<unsigned int> num_seen(num_chunks.size(), 0);
+  auto video_offset = -1 != m_vptzr ? 1 : 0;
+  auto max_skew     = 0.0;
+
+  for (auto &chunk : m_chunks) {
+    ++num_seen[chunk.m_demuxer_idx + video_offset];
+
+    auto min_progress = 1.0, max_progress = 0.0;
+    for (auto idx = 0u; num_chunks.size() > idx; ++idx) {
+      if (!num_chunks[idx])
+        continue;
+      auto progress = static_cast<double>(num_seen[idx]) / num_chunks[idx];
+      min_progress  = std::min(min_progress, progress);
+      max_progress  = std::max(max_progress, progress);
+    }
+
+    max_skew = std::max(max_skew, max_progress - min_progress);
+  }
+
+  auto duration       = ((-1 != m_vptzr) && (0 < m_fps)) ? m_max_video_frames / m_fps : 0.0;
+  m_read_sequentially = duration ? (max_skew * duration) <= 10.0 : max_skew <= 0.01;
+
+  mxdebug_if(debug, boost::format("avi_sequential_reading: %1% chunks, maximum skew %2%%% (%3% s at a duration of %4% s); reading %5%\n")
+             % m_chunks.size() % (max_skew * 100) % (max_skew * duration) % duration % (m_read_sequentially ? "sequentially" : "track by track"));
+
+  if (!m_read_sequentially)
+    m_chunks.clear();
 }
 
 void
@@ -733,30 +816,8 @@ avi_reader_c::read_video() {
 
   m_dropped_video_frames += dropped_frames_here;
 
-  // AVC with framed packets (without NALU start codes but with length fields)
-  // or non-AVC video track?
-  if (0 >= m_avc_nal_size_size)
-    PTZR(m_vptzr)->process(new packet_t(chunk, timestamp, duration, key ? VFT_IFRAME : VFT_PFRAMEAUTOMATIC, VFT_NOBFRAME));
-
-  else {
-    // AVC video track without NALU start codes. Re-frame with NALU start codes.
-    int offset = 0;
-
-    while ((offset + m_avc_nal_size_size) < num_read) {
-      int nalu_size  = get_uint_be(chunk->get_buffer() + offset, m_avc_nal_size_size);
-      offset        += m_avc_nal_size_size;
-
-      if ((offset + nalu_size) > num_read)
-        break;
-
-      memory_cptr nalu = memory_c::alloc(4 + nalu_size);
-      put_uint32_be(nalu->get_buffer(), NALU_START_CODE);
-      memcpy(nalu->get_buffer() + 4, chunk->get_buffer() + offset, nalu_size);
-      offset += nalu_size;
-
-      PTZR(m_vptzr)->process(new packet_t(nalu, timestamp, duration, key ? VFT_IFRAME : VFT_PFRAMEAUTOMATIC, VFT_NOBFRAME));
-    }
-  }
+  chunk->set_size(num_read);
+  process_video_frame(chunk, timestamp, duration, key);
 
   m_bytes_processed += num_read;
 
@@ -784,15 +845,146 @@ avi_reader_c::read_audio(avi_demuxer_t &demuxer) {
     if (0 >= size)
       continue;
 
-    PTZR(demuxer.m_ptzr)->add_avi_block_size(size);
-    PTZR(demuxer.m_ptzr)->process(new packet_t(chunk));
-
-    m_bytes_processed += size;
+    chunk->set_size(size);
+    process_audio_chunk(demuxer, chunk);
 
     return AVI_get_audio_position_index(m_avi) < AVI_max_audio_chunk(m_avi) ? FILE_STATUS_MOREDATA : flush_packetizer(demuxer.m_ptzr);
   }
 }
 
+void
+avi_reader_c::process_video_frame(memory_cptr &frame,
+                                  int64_t timestamp,
+                                  int64_t duration,
+                                  bool is_key) {
+  auto bref = is_key ? VFT_IFRAME : VFT_PFRAMEAUTOMATIC;
+
+  // AVC with framed packets (without NALU start codes but with length fields)
+  // or non-AVC video track?
+  if (0 >= m_avc_nal_size_size) {
+    PTZR(m_vptzr)->process(new packet_t(frame, timestamp, duration, bref, VFT_NOBFRAME));
+    return;
+  }
+
+  // AVC video track without NALU start codes. Re-frame with NALU start
+  // codes. Size fields of at least three bytes are overwritten with
+  // start codes of the same length in place. Shorter ones require
+  // moving the data, but even then the frame is only copied once.
+  auto buffer       = frame->get_buffer();
+  auto size         = frame->get_size();
+  size_t nss        = m_avc_nal_size_size;
+  size_t offset     = 0;
+  size_t out_size   = 0;
+  std::vector<std::pair<size_t, size_t> > nalus;
+
+  while ((offset + nss) < size) {
+    size_t nalu_size  = get_uint_be(buffer + offset, nss);
+    offset           += nss;
+
+    if ((offset + nalu_size) > size)
+      break;
+
+    nalus.emplace_back(offset, nalu_size);
+    offset   += nalu_size;
+    out_size += 4 + nalu_size;
+  }
+
+  if (nalus.empty())
+    return;
+
+  if (3 <= nss) {
+    for (auto &nalu : nalus) {
+      memset(buffer + nalu.first - nss, 0, nss - 1);
+      buffer[nalu.first - 1] = 0x01;
+    }
+
+    frame->set_size(nalus.back().first + nalus.back().second);
+
+  } else {
+    auto reframed = memory_c::alloc(out_size);
+    auto out      = reframed->get_buffer();
+
+    for (auto &nalu : nalus) {
+      put_uint32_be(out, NALU_START_CODE);
+      memcpy(out + 4, buffer + nalu.first, nalu.second);
+      out += 4 + nalu.second;
+    }
+
+    frame = reframed;
+  }
+
+  PTZR(m_vptzr)->process(new packet_t(frame, timestamp, duration, bref, VFT_NOBFRAME));
+}
+
+void
+avi_reader_c::process_audio_chunk(avi_demuxer_t &demuxer,
+                                  memory_cptr const &chunk) {
+  PTZR(demuxer.m_ptzr)->add_avi_block_size(chunk->get_size());
+  PTZR(demuxer.m_ptzr)->process(new packet_t(chunk));
+
+  m_bytes_processed += chunk->get_size();
+}
+
+file_status_e
+avi_reader_c::read_next_chunk() {
+  while (m_next_chunk < m_chunks.size()) {
+    auto &chunk = m_chunks[m_next_chunk++];
+
+    // Zero-sized video frames are dropped frames. They're accounted for
+    // by extending the duration of the preceding frame.
+    if (!chunk.m_size)
+      continue;
+
+    if (-1 == chunk.m_demuxer_idx) {
+      if (chunk.m_index < m_video_frames_read)
+        continue;
+
+      auto timestamp_idx  = m_video_frames_read;
+      m_video_frames_read = chunk.m_index + 1;
+      while ((m_video_frames_read < m_max_video_frames) && !AVI_frame_size(m_avi, m_video_frames_read))
+        ++m_video_frames_read;
+
+      auto num_dropped        = m_video_frames_read - timestamp_idx - 1;
+      m_dropped_video_frames += num_dropped;
+
+      auto frame = memory_c::alloc(chunk.m_size);
+      m_in->setFilePointer(chunk.m_pos);
+      if (m_in->read(frame->get_buffer(), chunk.m_size) != static_cast<uint32_t>(chunk.m_size))
+        break;
+
+      process_video_frame(frame,
+                          static_cast<int64_t>(static_cast<int64_t>(timestamp_idx)   * 1000000000ll / m_fps),
+                          static_cast<int64_t>(static_cast<int64_t>(num_dropped + 1) * 1000000000ll / m_fps),
+                          0x10 == m_avi->video_index[chunk.m_index].key);
+
+      m_bytes_processed += chunk.m_size;
+
+    } else {
+      auto data = memory_c::alloc(chunk.m_size);
+      m_in->setFilePointer(chunk.m_pos);
+      if (m_in->read(data->get_buffer(), chunk.m_size) != static_cast<uint32_t>(chunk.m_size))
+        break;
+
+      process_audio_chunk(m_audio_demuxers[chunk.m_demuxer_idx], data);
+    }
+
+    return FILE_STATUS_MOREDATA;
+  }
+
+  // All chunks have been read, or the file is truncated. Subtitles
+  // are handled separately.
+  m_next_chunk = m_chunks.size();
+
+  if (-1 != m_vptzr)
+    PTZR(m_vptzr)->flush();
+
+  for (auto &demuxer : m_audio_demuxers)
+    if (-1 != demuxer.m_ptzr)
+      PTZR(demuxer.m_ptzr)->flush();
+
+  return FILE_STATUS_DONE;
+}
+
 file_status_e
 avi_reader_c::read_subtitles(avi_subs_demuxer_t &demuxer) {
   if (!demuxer.m_subs->empty())
@@ -804,6 +996,13 @@ avi_reader_c::read_subtitles(avi_subs_demuxer_t &demuxer) {
 file_status_e
 avi_reader_c::read(generic_packetizer_c *ptzr,
                    bool) {
+  for (auto &subs_demuxer : m_subtitle_demuxers)
+    if ((-1 != subs_demuxer.m_ptzr) && (PTZR(subs_demuxer.m_ptzr) == ptzr))
+      return read_subtitles(subs_demuxer);
+
+  if (m_read_sequentially)
+    return read_next_chunk();
+
   if ((-1 != m_vptzr) && (PTZR(m_vptzr) == ptzr))
     return read_video();
 
@@ -811,10 +1010,6 @@ avi_reader_c::read(generic_packetizer_c *ptzr,
     if ((-1 != demuxer.m_ptzr) && (PTZR(demuxer.m_ptzr) == ptzr))
       return read_audio(demuxer);
 
-  for (auto &subs_demuxer : m_subtitle_demuxers)
-    if ((-1 != subs_demuxer.m_ptzr) && (PTZR(subs_demuxer.m_ptzr) == ptzr))
-      return read_subtitles(subs_demuxer);
-
   return flush_packetizers();
 }
 
@@ -944,7 +1139,7 @@ avi_reader_c::identify_attachments() {
   }
 
   for (i = 0; i < g_attachments.size(); i++)
-    id_result_attachment(g_attachments[i].ui_id, g_attachments[i].mime_type, g_attachments[i].data->get_size(), g_attachments[i].name, g_attachments[i].description);
+    id_result_attachment(g_attachments[i].ui_id, g_attachments[i].mime_type, g_attachments[i].get_size(), g_attachments[i].name, g_attachments[i].description);
 }
 
 void
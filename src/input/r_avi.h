@@ -42,6 +42,20 @@ typedef struct avi_demuxer_t {
   }
 } avi_demuxer_t;
 
+struct avi_chunk_t {
+  int64_t m_pos, m_size;
+  int m_demuxer_idx;            // -1 for the video track
+  unsigned int m_index;         // video frame or audio chunk number
+
+  avi_chunk_t(int64_t pos, int64_t size, int demuxer_idx, unsigned int index)
+    : m_pos(pos)
+    , m_size(size)
+    , m_demuxer_idx(demuxer_idx)
+    , m_index(index)
+  {
+  }
+};
+
 struct avi_subs_demuxer_t {
   enum {
     TYPE_UNKNOWN,
@@ -79,6 +93,10 @@ private:
   uint64_t m_bytes_to_process, m_bytes_processed;
   bool m_video_track_ok;
 
+  std::vector<avi_chunk_t> m_chunks;
+  size_t m_next_chunk;
+  bool m_read_sequentially;
+
 public:
   avi_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~avi_reader_c();
@@ -102,6 +120,9 @@ protected:
   virtual file_status_e read_video();
   virtual file_status_e read_audio(avi_demuxer_t &demuxer);
   virtual file_status_e read_subtitles(avi_subs_demuxer_t &demuxer);
+  virtual file_status_e read_next_chunk();
+  virtual void process_video_frame(memory_cptr &frame, int64_t timestamp, int64_t duration, bool is_key);
+  virtual void process_audio_chunk(avi_demuxer_t &demuxer, memory_cptr const &chunk);
 
   virtual generic_packetizer_c *create_aac_packetizer(int aid, avi_demuxer_t &demuxer);
   virtual generic_packetizer_c *create_dts_packetizer(int aid);
@@ -122,6 +143,7 @@ protected:
 
   void parse_subtitle_chunks();
   void verify_video_track();
+  void setup_sequential_reading();
 
   virtual void identify_video();
   virtual void identify_audio();
@@ -15,6 +15,7 @@
 #include "common/common_pch.h"
 
 #include "common/dts.h"
+#include "common/endian.h"
 #include "common/error.h"
 #include "input/r_dts.h"
 #include "output/p_dts.h"
@@ -53,20 +54,18 @@ dts_reader_c::probe_file(mm_io_c *in,
 dts_reader_c::dts_reader_c(const track_info_c &ti,
                            const mm_io_cptr &in)
   : generic_reader_c(ti, in)
-  , m_af_buf(memory_c::alloc(2 * READ_SIZE))
-  , m_cur_buf(0)
+  , m_af_buf(memory_c::alloc(READ_SIZE))
   , m_dts14_to_16(false)
   , m_swap_bytes(false)
   , m_debug(debugging_requested("dts") || debugging_requested("dts_reader"))
 {
-  m_buf[0] = reinterpret_cast<unsigned short *>(m_af_buf->get_buffer());
-  m_buf[1] = reinterpret_cast<unsigned short *>(m_af_buf->get_buffer() + READ_SIZE);
+  m_buf = reinterpret_cast<unsigned short *>(m_af_buf->get_buffer());
 }
 
 void
 dts_reader_c::read_headers() {
   try {
-    if (m_in->read(m_buf[m_cur_buf], READ_SIZE) != READ_SIZE)
+    if (m_in->read(m_buf, READ_SIZE) != READ_SIZE)
       throw mtx::input::header_parsing_x();
     m_in->setFilePointer(0, seek_beginning);
 
@@ -74,12 +73,12 @@ dts_reader_c::read_headers() {
     throw mtx::input::open_x();
   }
 
-  detect_dts(m_buf[m_cur_buf], READ_SIZE, m_dts14_to_16, m_swap_bytes);
+  detect_dts(m_buf, READ_SIZE, m_dts14_to_16, m_swap_bytes);
 
   mxdebug_if(m_debug, boost::format("DTS: 14->16 %1% swap %2%\n") % m_dts14_to_16 % m_swap_bytes);
 
-  decode_buffer(READ_SIZE);
-  int pos = find_dts_header(reinterpret_cast<const unsigned char *>(m_buf[m_cur_buf]), READ_SIZE, &m_dtsheader);
+  int decoded_size = decode_buffer(READ_SIZE);
+  int pos          = find_dts_header(reinterpret_cast<const unsigned char *>(m_buf), decoded_size, &m_dtsheader);
 
   if (0 > pos)
     throw mtx::input::header_parsing_x();
@@ -94,15 +93,12 @@ dts_reader_c::~dts_reader_c() {
 
 int
 dts_reader_c::decode_buffer(size_t length) {
-  if (m_swap_bytes) {
-    swab(reinterpret_cast<char *>(m_buf[m_cur_buf]), reinterpret_cast<char *>(m_buf[m_cur_buf ^ 1]), length);
-    m_cur_buf ^= 1;
-  }
+  if (m_swap_bytes)
+    swap_16bit_words(m_buf, length);
 
   if (m_dts14_to_16) {
-    dts_14_to_dts_16(m_buf[m_cur_buf], length / 2, m_buf[m_cur_buf ^ 1]);
-    m_cur_buf ^= 1;
-    length     = length * 7 / 8;
+    dts_14_to_dts_16(m_buf, length / 2, m_buf);
+    length = length * 7 / 8;
   }
 
   return length;
@@ -123,7 +119,7 @@ dts_reader_c::create_packetizer(int64_t) {
 file_status_e
 dts_reader_c::read(generic_packetizer_c *,
                    bool) {
-  size_t num_read = m_in->read(m_buf[m_cur_buf], READ_SIZE);
+  size_t num_read = m_in->read(m_buf, READ_SIZE);
 
   if (m_dts14_to_16)
     num_read &= ~0xf;
@@ -133,7 +129,7 @@ dts_reader_c::read(generic_packetizer_c *,
 
   int num_to_output = decode_buffer(num_read);
 
-  PTZR0->process(new packet_t(new memory_c(m_buf[m_cur_buf], num_to_output, false)));
+  PTZR0->process(new packet_t(new memory_c(m_buf, num_to_output, false)));
 
   return ((num_read < READ_SIZE) || m_in->eof()) ? flush_packetizers() : FILE_STATUS_MOREDATA;
 }
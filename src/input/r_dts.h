@@ -27,8 +27,7 @@
 class dts_reader_c: public generic_reader_c {
 private:
   memory_cptr m_af_buf;
-  unsigned short *m_buf[2];
-  unsigned int m_cur_buf;
+  unsigned short *m_buf;
   dts_header_t m_dtsheader;
   bool m_dts14_to_16, m_swap_bytes, m_debug;
 
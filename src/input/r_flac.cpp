@@ -16,13 +16,14 @@
 #include <ogg/ogg.h>
 #include <vorbis/codec.h>
 
+#include "common/checksums.h"
 #include "common/flac.h"
 #include "common/matroska.h"
 #include "input/r_flac.h"
 #include "merge/output_control.h"
 #include "merge/pr_generic.h"
 
-#define BUFFER_SIZE 4096
+#define READ_SIZE (128 * 1024)
 
 #if defined(HAVE_FLAC_FORMAT_H)
 
@@ -106,6 +107,11 @@ flac_reader_c::flac_reader_c(const track_info_c &ti,
                              const mm_io_cptr &in)
   : generic_reader_c(ti, in)
   , samples(0)
+  , m_scan_pos(0)
+  , m_first_candidate_pos(0)
+  , m_crc_pos(0)
+  , m_crc(0)
+  , m_eof(false)
 {
 }
 
@@ -116,28 +122,16 @@ flac_reader_c::read_headers() {
 
   show_demuxer_info();
 
-  if (!parse_file())
-    throw mtx::input::header_parsing_x();
-
+  bool ok = false;
   try {
-    uint32_t block_size = 0;
-
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++)
-      block_size += current_block->len;
-
-    m_header = memory_c::alloc(block_size);
-
-    block_size         = 0;
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++) {
-      m_in->setFilePointer(current_block->filepos);
-      if (m_in->read(m_header->get_buffer() + block_size, current_block->len) != current_block->len)
-        mxerror(Y("flac_reader: Could not read a header packet.\n"));
-      block_size += current_block->len;
-    }
+    ok = parse_file();
 
-  } catch (mtx::exception &) {
+  } catch (mtx::mm_io::exception &) {
     mxerror(Y("flac_reader: could not initialize the FLAC packetizer.\n"));
   }
+
+  if (!ok)
+    throw mtx::input::header_parsing_x();
 }
 
 flac_reader_c::~flac_reader_c() {
@@ -155,16 +149,14 @@ flac_reader_c::create_packetizer(int64_t) {
 bool
 flac_reader_c::parse_file() {
   FLAC__StreamDecoder *decoder;
-  FLAC__StreamDecoderState state;
-  flac_block_t block;
-  uint64_t u, old_pos;
-  int result, progress, old_progress;
-  bool ok;
+  uint64_t u;
+  int result;
 
   m_in->setFilePointer(0);
   metadata_parsed = false;
 
-  mxinfo(Y("+-> Parsing the FLAC file. This can take a LONG time.\n"));
+  // Only the metadata blocks are parsed with libFLAC. The frames are
+  // split while reading (see find_next_frame_start()).
   decoder = FLAC__stream_decoder_new();
   if (!decoder)
     mxerror(Y("flac_reader: FLAC__stream_decoder_new() failed.\n"));
@@ -176,85 +168,159 @@ flac_reader_c::parse_file() {
 
   result = FLAC__stream_decoder_process_until_end_of_metadata(decoder);
 
-  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%, num blocks: %3%\n") % result % metadata_parsed % blocks.size());
+  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%\n") % result % metadata_parsed);
 
   if (!metadata_parsed)
     mxerror_fn(m_ti.m_fname, Y("No metadata block found. This file is broken.\n"));
 
-  FLAC__stream_decoder_get_decode_position(decoder, &u);
+  if (!FLAC__stream_decoder_get_decode_position(decoder, &u) || (4 >= u))
+    mxerror(Y("flac_reader: Could not read all header packets.\n"));
+
+  FLAC__stream_decoder_reset(decoder);
+  FLAC__stream_decoder_delete(decoder);
+
+  mxverb(2, boost::format("flac_reader: headers: block at %1% with size %2%\n") % 4 % (u - 4));
+
+  m_header = memory_c::alloc(u - 4);
+  m_in->setFilePointer(4);
+  if (m_in->read(m_header, u - 4) != (u - 4))
+    mxerror(Y("flac_reader: Could not read a header packet.\n"));
+
+  return metadata_parsed;
+}
 
-  block.type    = FLAC_BLOCK_TYPE_HEADERS;
-  block.filepos = 0;
-  block.len     = u;
-  old_pos       = u;
+bool
+flac_reader_c::fill_buffer() {
+  if (m_eof)
+    return false;
 
-  blocks.push_back(block);
+  auto num_read = m_in->read(m_buffer.reserve(READ_SIZE), READ_SIZE);
+  m_buffer.commit(num_read);
 
-  mxverb(2, boost::format("flac_reader: headers: block at %1% with size %2%\n") % block.filepos % block.len);
+  if (READ_SIZE != num_read)
+    m_eof = true;
 
-  old_progress = -5;
-  ok = FLAC__stream_decoder_skip_single_frame(decoder);
-  while (ok) {
-    state = FLAC__stream_decoder_get_state(decoder);
+  return 0 < num_read;
+}
 
-    progress = m_in->getFilePointer() * 100 / m_size;
-    if ((progress - old_progress) >= 5) {
-      mxinfo(boost::format(Y("+-> Pre-parsing FLAC file: %1%%%%2%")) % progress % "\r");
-      old_progress = progress;
+// Checks the CRC-16 of the first 'size' bytes of the buffer. The CRC is
+// continued from where the previous call left off instead of being
+// recalculated from the frame's start for each sync code candidate.
+bool
+flac_reader_c::is_frame_crc_valid(size_t size) {
+  if (m_crc_pos < size) {
+    m_crc     = crc_calc(crc_get_table(CRC_16_ANSI), m_crc, m_buffer.get_buffer() + m_crc_pos, size - m_crc_pos);
+    m_crc_pos = size;
+  }
+
+  return (2 < size) && !m_crc;
+}
+
+// Returns the size of the frame at the start of the buffer. A frame
+// ends where the next valid frame header (sync code and CRC-8) starts
+// if the CRC-16 of the data before that header matches.
+size_t
+flac_reader_c::find_next_frame_start() {
+  auto max_unverified_size = std::max<size_t>(2 * stream_info.max_framesize, 1024 * 1024);
+
+  while (true) {
+    auto buffer = m_buffer.get_buffer();
+    auto size   = m_buffer.get_size();
+
+    // Skip anything that isn't a frame header at the start of the
+    // buffer.
+    if (!m_scan_pos) {
+      size_t pos;
+      for (pos = 0; (pos + FLAC_MAX_FRAME_HEADER_SIZE) <= size; ++pos)
+        if (flac_get_frame_header_size(&buffer[pos], size - pos))
+          break;
+
+      if (pos) {
+        mxverb(2, boost::format("flac_reader: skipping %1% bytes of garbage\n") % pos);
+        m_buffer.remove(pos);
+        buffer = m_buffer.get_buffer();
+        size   = m_buffer.get_size();
+      }
+
+      if ((FLAC_MAX_FRAME_HEADER_SIZE <= size) || m_eof)
+        m_scan_pos = 1;
     }
 
-    if (FLAC__stream_decoder_get_decode_position(decoder, &u) && (u != old_pos)) {
-      block.type    = FLAC_BLOCK_TYPE_DATA;
-      block.filepos = old_pos;
-      block.len     = u - old_pos;
-      old_pos       = u;
-      blocks.push_back(block);
+    for (; m_scan_pos && ((m_scan_pos + FLAC_MAX_FRAME_HEADER_SIZE) <= size); ++m_scan_pos) {
+      if (   (0xff != buffer[m_scan_pos])
+          || (0xf8 != (buffer[m_scan_pos + 1] & 0xfe))
+          || !flac_get_frame_header_size(&buffer[m_scan_pos], size - m_scan_pos))
+        continue;
 
-      mxverb(2, boost::format("flac_reader: skip/decode frame, block at %1% with size %2%\n") % block.filepos % block.len);
+      if (is_frame_crc_valid(m_scan_pos))
+        return m_scan_pos;
+
+      if (!m_first_candidate_pos)
+        m_first_candidate_pos = m_scan_pos;
     }
 
-    if (state > FLAC__STREAM_DECODER_READ_FRAME)
-      break;
+    // Damaged frame: don't buffer the rest of the file looking for a
+    // matching CRC. Split at the first valid header instead.
+    if (m_first_candidate_pos && (size > max_unverified_size)) {
+      mxwarn_fn(m_ti.m_fname, boost::format(Y("The FLAC frame at byte position %1% is damaged (CRC mismatch).\n")) % (m_in->getFilePointer() - size));
+      return m_first_candidate_pos;
+    }
 
-    ok = FLAC__stream_decoder_skip_single_frame(decoder);
-  }
+    if (fill_buffer())
+      continue;
 
-  if (100 != old_progress)
-    mxinfo(Y("+-> Pre-parsing FLAC file: 100%\n"));
-  else
-    mxinfo("\n");
+    // End of file: the rest is the last frame, possibly followed by
+    // trailing data such as an ID3v1 tag. The last frame ends where
+    // the longest prefix with a matching CRC ends. No frame is larger
+    // than the maximum frame size from the stream info.
+    if (!size || is_frame_crc_valid(size))
+      return size;
 
-  if ((blocks.size() == 0) || (blocks[0].type != FLAC_BLOCK_TYPE_HEADERS))
-    mxerror(Y("flac_reader: Could not read all header packets.\n"));
+    auto max_frame_size = stream_info.max_framesize ? std::min<size_t>(stream_info.max_framesize, size) : size;
+    auto frame_size     = flac_find_longest_valid_frame(buffer, max_frame_size);
 
-  FLAC__stream_decoder_reset(decoder);
-  FLAC__stream_decoder_delete(decoder);
+    if (!frame_size && m_first_candidate_pos)
+      return m_first_candidate_pos;
 
-  m_in->setFilePointer(0);
-  blocks[0].len     -= 4;
-  blocks[0].filepos  = 4;
+    if (!frame_size)
+      frame_size = max_frame_size;
 
-  return metadata_parsed;
+    if ((128 == (size - frame_size)) && !memcmp(&buffer[frame_size], "TAG", 3))
+      mxverb(2, "flac_reader: skipping the ID3v1 tag at the end\n");
+
+    else if (frame_size < size)
+      mxwarn_fn(m_ti.m_fname, boost::format(Y("Ignoring %1% bytes of trailing data that aren't part of a FLAC frame at the end of the file.\n")) % (size - frame_size));
+
+    return frame_size;
+  }
 }
 
 file_status_e
 flac_reader_c::read(generic_packetizer_c *,
                     bool) {
-  if (current_block == blocks.end())
+  auto frame_size = find_next_frame_start();
+  if (!frame_size)
     return flush_packetizers();
 
-  memory_cptr buf = memory_c::alloc(current_block->len);
-  m_in->setFilePointer(current_block->filepos);
-  if (m_in->read(buf, current_block->len) != current_block->len)
-    return flush_packetizers();
+  memory_cptr buf = memory_c::clone(m_buffer.get_buffer(), frame_size);
+  m_buffer.remove(frame_size);
+  m_scan_pos            = 1;
+  m_first_candidate_pos = 0;
+  m_crc_pos             = 0;
+  m_crc                 = 0;
+
+  // Drop trailing data that isn't a frame (e.g. an ID3v1 tag). The
+  // warning has already been issued by find_next_frame_start().
+  if (m_eof && m_buffer.get_size() && !flac_get_frame_header_size(m_buffer.get_buffer(), m_buffer.get_size()))
+    m_buffer.clear();
 
-  unsigned int samples_here = flac_get_num_samples(buf->get_buffer(), current_block->len, stream_info);
+  int samples_here = flac_get_num_samples(buf->get_buffer(), frame_size, stream_info);
   PTZR0->process(new packet_t(buf, samples * 1000000000 / sample_rate));
 
-  samples += samples_here;
-  current_block++;
+  if (0 < samples_here)
+    samples += samples_here;
 
-  return (current_block == blocks.end()) ? flush_packetizers() : FILE_STATUS_MOREDATA;
+  return (m_eof && !m_buffer.get_size()) ? flush_packetizers() : FILE_STATUS_MOREDATA;
 }
 
 FLAC__StreamDecoderReadStatus
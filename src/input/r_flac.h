@@ -16,6 +16,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/byte_buffer.h"
 #include "common/mm_io.h"
 #include "merge/pr_generic.h"
 
@@ -26,24 +27,19 @@
 
 #include "output/p_flac.h"
 
-#define FLAC_BLOCK_TYPE_HEADERS 0
-#define FLAC_BLOCK_TYPE_DATA    1
-
-typedef struct {
-  int64_t filepos;
-  unsigned int type, len;
-} flac_block_t;
-
 class flac_reader_c: public generic_reader_c {
 private:
   memory_cptr m_header;
   int sample_rate;
   bool metadata_parsed;
   uint64_t samples;
-  std::vector<flac_block_t> blocks;
-  std::vector<flac_block_t>::iterator current_block;
   FLAC__StreamMetadata_StreamInfo stream_info;
 
+  byte_buffer_c m_buffer;
+  size_t m_scan_pos, m_first_candidate_pos, m_crc_pos;
+  uint32_t m_crc;
+  bool m_eof;
+
 public:
   flac_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~flac_reader_c();
@@ -77,6 +73,9 @@ public:
 
 protected:
   virtual bool parse_file();
+  virtual bool fill_buffer();
+  virtual size_t find_next_frame_start();
+  virtual bool is_frame_crc_valid(size_t size);
 };
 
 #else  // HAVE_FLAC_FORMAT_H
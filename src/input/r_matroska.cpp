@@ -54,6 +54,7 @@
 #include "common/strings/parsing.h"
 #include "common/strings/utf8.h"
 #include "common/tags/tags.h"
+#include "common/vint.h"
 #include "input/r_matroska.h"
 #include "merge/output_control.h"
 #include "merge/pr_generic.h"
@@ -629,39 +630,94 @@ kax_reader_c::handle_attachments(mm_io_c *io,
   if (!atts)
     return;
 
-  EbmlElement *element_found = nullptr;
-  upper_lvl_el               = 0;
+  // Only the attachments' properties are read here. Their content is
+  // copied straight from this file when the output file is written
+  // instead of being kept in memory until then. Files consisting of
+  // several parts are the exception.
+  auto stream_content = !get_underlying_input_as_multi_file_io();
+  auto atts_start     = atts->GetElementPosition() + atts->HeadSize();
+  auto atts_end       = atts->IsFiniteSize() ? atts_start + atts->GetSize() : static_cast<uint64_t>(io->get_size());
 
-  atts->Read(*m_es, EBML_CLASS_CONTEXT(KaxAttachments), upper_lvl_el, element_found, true);
+  auto read_element_head = [io](uint32_t &id, uint64_t &end) -> bool {
+    auto id_vint   = vint_c::read_ebml_id(io);
+    auto size_vint = vint_c::read(io);
 
-  for (auto l1_att : *atts) {
-    auto att = dynamic_cast<KaxAttached *>(l1_att);
-    if (!att)
-      continue;
+    if (!id_vint.is_valid() || !size_vint.is_valid() || size_vint.is_unknown())
+      return false;
 
-    attachment_t matt;
-    matt.name        = to_utf8(FindChildValue<KaxFileName>(att));
-    matt.description = to_utf8(FindChildValue<KaxFileDescription>(att));
-    matt.mime_type   = FindChildValue<KaxMimeType>(att);
-    matt.id          = FindChildValue<KaxFileUID>(att);
-
-    auto fdata       = FindChild<KaxFileData>(att);
-    if (fdata)
-      matt.data = memory_c::clone(static_cast<unsigned char *>(fdata->GetBuffer()), fdata->GetSize());
-
-    ++m_attachment_id;
-    attach_mode_e attach_mode;
-    if (   !matt.id
-        || !matt.data->get_size()
-        || matt.mime_type.empty()
-        || matt.name.empty()
-        || ((attach_mode = attachment_requested(m_attachment_id)) == ATTACH_MODE_SKIP))
-      continue;
+    id  = id_vint.m_value;
+    end = io->getFilePointer() + size_vint.m_value;
+
+    return true;
+  };
+
+  auto read_string = [io](uint64_t end) -> std::string {
+    std::string value;
+    io->read(value, end - io->getFilePointer());
+    return value.substr(0, value.find('\0'));
+  };
+
+  io->setFilePointer(atts_start);
+
+  try {
+    uint32_t id;
+    uint64_t att_end;
+
+    while ((io->getFilePointer() < atts_end) && read_element_head(id, att_end) && (att_end <= atts_end)) {
+      if (EBML_ID_VALUE(EBML_ID(KaxAttached)) != id) {
+        io->setFilePointer(att_end);
+        continue;
+      }
 
-    matt.ui_id          = m_attachment_id;
-    matt.to_all_files   = ATTACH_MODE_TO_ALL_FILES == attach_mode;
+      attachment_t matt;
+      uint64_t child_end;
+
+      while ((io->getFilePointer() < att_end) && read_element_head(id, child_end) && (child_end <= att_end)) {
+        if (EBML_ID_VALUE(EBML_ID(KaxFileName)) == id)
+          matt.name = read_string(child_end);
+
+        else if (EBML_ID_VALUE(EBML_ID(KaxFileDescription)) == id)
+          matt.description = read_string(child_end);
+
+        else if (EBML_ID_VALUE(EBML_ID(KaxMimeType)) == id)
+          matt.mime_type = read_string(child_end);
+
+        else if ((EBML_ID_VALUE(EBML_ID(KaxFileUID)) == id) && ((child_end - io->getFilePointer()) <= 8)) {
+          unsigned char buffer[8];
+          auto size = child_end - io->getFilePointer();
+          if (io->read(buffer, size) == size)
+            matt.id = get_uint_be(buffer, size);
+
+        } else if ((EBML_ID_VALUE(EBML_ID(KaxFileData)) == id) && stream_content) {
+          matt.source_file_name = m_ti.m_fname;
+          matt.source_offset    = io->getFilePointer();
+          matt.source_size      = child_end - matt.source_offset;
+
+        } else if (EBML_ID_VALUE(EBML_ID(KaxFileData)) == id)
+          matt.data = io->read(child_end - io->getFilePointer());
+
+        io->setFilePointer(child_end);
+      }
+
+      io->setFilePointer(att_end);
+
+      ++m_attachment_id;
+      attach_mode_e attach_mode;
+      if (   !matt.id
+          || !matt.get_size()
+          || matt.mime_type.empty()
+          || matt.name.empty()
+          || ((attach_mode = attachment_requested(m_attachment_id)) == ATTACH_MODE_SKIP))
+        continue;
+
+      matt.ui_id          = m_attachment_id;
+      matt.to_all_files   = ATTACH_MODE_TO_ALL_FILES == attach_mode;
+
+      add_attachment(matt);
+    }
 
-    add_attachment(matt);
+  } catch (mtx::mm_io::exception &) {
+    mxwarn_fn(m_ti.m_fname, Y("A read error occurred while reading the attachments. The remaining attachments will be skipped.\n"));
   }
 }
 
@@ -2148,7 +2204,7 @@ kax_reader_c::get_progress() {
   if (0 != m_segment_duration)
     return (m_last_timecode - std::max(m_first_timecode, static_cast<int64_t>(0))) * 100 / m_segment_duration;
 
-  return 100 * m_in->getFilePointer() / m_size;
+  return std::min<int>(100 * m_in->getFilePointer() / m_size, 100);
 }
 
 void
@@ -2256,7 +2312,7 @@ kax_reader_c::identify() {
   }
 
   for (auto &attachment : g_attachments)
-    id_result_attachment(attachment.ui_id, attachment.mime_type, attachment.data->get_size(), attachment.name, attachment.description);
+    id_result_attachment(attachment.ui_id, attachment.mime_type, attachment.get_size(), attachment.name, attachment.description);
 
   if (m_chapters)
     id_result_chapters(count_chapter_atoms(*m_chapters));
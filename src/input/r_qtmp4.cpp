@@ -130,12 +130,18 @@ qtmp4_reader_c::qtmp4_reader_c(const track_info_c &ti,
   , m_time_scale(1)
   , m_compression_algorithm{}
   , m_main_dmx(-1)
+  , m_fragmented(false)
+  , m_next_fragment_pos(0)
+  , m_moof_pos(0)
+  , m_fragment_implicit_offset(0)
+  , m_fragment_dmx(nullptr)
   , m_audio_encoder_delay_samples(0)
   , m_debug_chapters(    debugging_requested("qtmp4") || debugging_requested("qtmp4_full") || debugging_requested("qtmp4_chapters"))
   , m_debug_headers(     debugging_requested("qtmp4") || debugging_requested("qtmp4_full") || debugging_requested("qtmp4_headers"))
   , m_debug_tables(                                      debugging_requested("qtmp4_full") || debugging_requested("qtmp4_tables"))
   , m_debug_interleaving(debugging_requested("qtmp4") || debugging_requested("qtmp4_full") || debugging_requested("qtmp4_interleaving"))
   , m_debug_resync(      debugging_requested("qtmp4|qtmp4_full|qtmp4_resync"))
+  , m_debug_fragments(   debugging_requested("qtmp4|qtmp4_full|qtmp4_fragments"))
 {
 }
 
@@ -236,6 +242,14 @@ qtmp4_reader_c::parse_headers() {
       handle_moov_atom(atom.to_parent(), 0);
       headers_parsed = true;
 
+      // Fragmented files: the samples are described by the 'moof'
+      // atoms following the 'moov' atom. Those are parsed one at a
+      // time while reading.
+      if (m_fragmented) {
+        m_next_fragment_pos = atom.pos + atom.size;
+        break;
+      }
+
     } else if (atom.fourcc == "mdat") {
       m_mdat_pos  = m_in->getFilePointer();
       m_mdat_size = atom.size;
@@ -251,10 +265,11 @@ qtmp4_reader_c::parse_headers() {
 
   if (!headers_parsed)
     mxerror(Y("Quicktime/MP4 reader: Have not found any header atoms.\n"));
-  if (-1 == m_mdat_pos)
+  if ((-1 == m_mdat_pos) && !m_fragmented)
     mxerror(Y("Quicktime/MP4 reader: Have not found the 'mdat' atom. No movie data found.\n"));
 
-  m_in->setFilePointer(m_mdat_pos);
+  if (!m_fragmented)
+    m_in->setFilePointer(m_mdat_pos);
 
   for (auto &dmx : m_demuxers) {
     if (m_chapter_track_ids[dmx->container_id])
@@ -272,9 +287,18 @@ qtmp4_reader_c::parse_headers() {
     else if (dmx->is_unknown())
       continue;
 
-    dmx->ok = dmx->update_tables(m_time_scale);
+    // The samples of fragmented files are usually only described by
+    // the 'moof' atoms. Sample tables present in the 'moov' atom must
+    // be valid nonetheless.
+    dmx->ok = m_fragmented && !dmx->has_sample_tables() ? verify_fragment_defaults(*dmx) : dmx->update_tables(m_time_scale);
   }
 
+  if (m_fragmented)
+    for (auto &dmx : m_demuxers) {
+      dmx->m_defaults     = m_track_defaults[dmx->container_id];
+      dmx->m_fragment_dts = boost::accumulate(dmx->durmap_table, 0ll, [](int64_t accu, qt_durmap_t const &durmap) { return accu + static_cast<int64_t>(durmap.number) * durmap.duration; });
+    }
+
   read_chapter_track();
 
   brng::remove_erase_if(m_demuxers, [this](qtmp4_demuxer_cptr const &dmx) { return !dmx->ok || dmx->is_chapters(); });
@@ -284,6 +308,18 @@ qtmp4_reader_c::parse_headers() {
   if (!g_identifying)
     calculate_timecodes();
 
+  // Make sure each track has at least one entry in its index so that
+  // the packetizers can look at the first frame (e.g. AC3).
+  if (m_fragmented && !g_identifying) {
+    auto index_empty = [](qtmp4_demuxer_cptr const &dmx) { return dmx->m_index.empty(); };
+    auto num_parsed  = 0u;
+
+    while (   (m_demuxers.end() != brng::find_if(m_demuxers, index_empty))
+           && (10 > num_parsed++)
+           && parse_next_fragment())
+      ;
+  }
+
   mxdebug_if(m_debug_headers, boost::format("Number of valid tracks found: %1%\n") % m_demuxers.size());
 }
 
@@ -552,6 +588,9 @@ qtmp4_reader_c::handle_moov_atom(qt_atom_t parent,
     else if (atom.fourcc == "udta")
       handle_udta_atom(atom.to_parent(), level + 1);
 
+    else if (atom.fourcc == "mvex")
+      handle_mvex_atom(atom.to_parent(), level + 1);
+
     else if (atom.fourcc == "trak") {
       qtmp4_demuxer_cptr new_dmx(new qtmp4_demuxer_c);
       new_dmx->id = m_demuxers.size();
@@ -581,6 +620,224 @@ qtmp4_reader_c::handle_mvhd_atom(qt_atom_t atom,
   mxdebug_if(m_debug_headers, boost::format("%1%Time scale: %2%\n") % space(level * 2 + 1) % m_time_scale);
 }
 
+void
+qtmp4_reader_c::handle_mvex_atom(qt_atom_t parent,
+                                 int level) {
+  m_fragmented = true;
+
+  while (parent.size > 0) {
+    qt_atom_t atom = read_atom();
+    print_basic_atom_info();
+
+    if (atom.fourcc == "trex")
+      handle_trex_atom(atom.to_parent(), level + 1);
+
+    skip_atom();
+    parent.size -= atom.size;
+  }
+}
+
+void
+qtmp4_reader_c::handle_trex_atom(qt_atom_t,
+                                 int level) {
+  m_in->skip(1 + 3);        // version & flags
+
+  auto track_id  = m_in->read_uint32_be();
+  auto &defaults = m_track_defaults[track_id];
+
+  defaults.sample_description_id = m_in->read_uint32_be();
+  defaults.sample_duration       = m_in->read_uint32_be();
+  defaults.sample_size           = m_in->read_uint32_be();
+  defaults.sample_flags          = m_in->read_uint32_be();
+
+  mxdebug_if(m_debug_headers, boost::format("%1%Track defaults for track ID %2%: sample description ID %3% duration %4% size %5% flags %6%\n")
+             % space(level * 2 + 1) % track_id % defaults.sample_description_id % defaults.sample_duration % defaults.sample_size % defaults.sample_flags);
+}
+
+bool
+qtmp4_reader_c::verify_fragment_defaults(qtmp4_demuxer_c &dmx) {
+  auto defaults = m_track_defaults.find(dmx.container_id);
+
+  if (m_track_defaults.end() == defaults) {
+    mxwarn(boost::format(Y("Quicktime/MP4 reader: Track %1% of the fragmented file lacks its 'track extends' atom ('trex'). Skipping this track.\n")) % dmx.id);
+    return false;
+  }
+
+  if (!defaults->second.sample_description_id || (defaults->second.sample_description_id > dmx.m_num_sample_descriptions)) {
+    mxwarn(boost::format(Y("Quicktime/MP4 reader: The fragments of track %1% refer to the sample description %2% by default, but the track only has %3%. Skipping this track.\n"))
+           % dmx.id % defaults->second.sample_description_id % dmx.m_num_sample_descriptions);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+qtmp4_reader_c::parse_next_fragment() {
+  for (auto &dmx : m_demuxers)
+    dmx->drop_consumed_index_entries();
+
+  try {
+    while (true) {
+      if ((m_next_fragment_pos + 8) > static_cast<uint64_t>(m_in->get_size()))
+        break;
+
+      m_in->setFilePointer(m_next_fragment_pos);
+      auto atom = read_atom(nullptr, false);
+      mxdebug_if(m_debug_fragments, boost::format("Top level atom while looking for fragments: %1%\n") % atom);
+
+      if (atom.fourcc == "moof") {
+        m_next_fragment_pos = atom.pos + atom.size;
+        m_moof_pos          = atom.pos;
+        handle_moof_atom(atom.to_parent(), 0);
+
+        return true;
+      }
+
+      if (atom.fourcc.human_readable())
+        m_next_fragment_pos = atom.pos + atom.size;
+
+      else if (resync_to_top_level_atom(atom.pos))
+        m_next_fragment_pos = m_in->getFilePointer();
+
+      else
+        break;
+    }
+
+  } catch (mtx::mm_io::exception &) {
+  } catch (bool) {
+  }
+
+  mxdebug_if(m_debug_fragments, boost::format("No more fragments found after %1%\n") % m_next_fragment_pos);
+
+  return false;
+}
+
+void
+qtmp4_reader_c::handle_moof_atom(qt_atom_t parent,
+                                 int level) {
+  // The data of the first track fragment without an explicit base
+  // data offset starts relative to the 'moof' atom, that of all
+  // following ones where the previous track fragment's data ended.
+  m_fragment_implicit_offset = m_moof_pos;
+
+  while (parent.size > 0) {
+    qt_atom_t atom = read_atom();
+    print_basic_atom_info();
+
+    if (atom.fourcc == "traf")
+      handle_traf_atom(atom.to_parent(), level + 1);
+
+    skip_atom();
+    parent.size -= atom.size;
+  }
+}
+
+void
+qtmp4_reader_c::handle_traf_atom(qt_atom_t parent,
+                                 int level) {
+  m_fragment     = qt_fragment_t{};
+  m_fragment_dmx = nullptr;
+
+  while (parent.size > 0) {
+    qt_atom_t atom = read_atom();
+    print_basic_atom_info();
+
+    if (atom.fourcc == "tfhd")
+      handle_tfhd_atom(atom.to_parent(), level + 1);
+
+    else if (atom.fourcc == "tfdt")
+      handle_tfdt_atom(atom.to_parent(), level + 1);
+
+    else if (atom.fourcc == "trun")
+      handle_trun_atom(atom.to_parent(), level + 1);
+
+    skip_atom();
+    parent.size -= atom.size;
+  }
+}
+
+void
+qtmp4_reader_c::handle_tfhd_atom(qt_atom_t,
+                                 int level) {
+  m_in->skip(1);            // version
+  auto flags = m_in->read_uint24_be();
+
+  m_fragment.track_id = m_in->read_uint32_be();
+
+  auto dmx_itr   = brng::find_if(m_demuxers, [this](qtmp4_demuxer_cptr const &dmx) { return dmx->container_id == m_fragment.track_id; });
+  m_fragment_dmx = (m_demuxers.end() != dmx_itr) && (*dmx_itr)->ok ? dmx_itr->get() : nullptr;
+
+  auto &defaults = m_track_defaults[m_fragment.track_id];
+
+  m_fragment.base_data_offset      = flags & 0x000001 ? m_in->read_uint64_be()
+                                    : flags & 0x020000 ? m_moof_pos
+                                    :                    m_fragment_implicit_offset;
+  m_fragment.next_data_offset      = m_fragment.base_data_offset;
+  m_fragment.sample_description_id = flags & 0x000002 ? m_in->read_uint32_be() : defaults.sample_description_id;
+  m_fragment.sample_duration       = flags & 0x000008 ? m_in->read_uint32_be() : defaults.sample_duration;
+  m_fragment.sample_size           = flags & 0x000010 ? m_in->read_uint32_be() : defaults.sample_size;
+  m_fragment.sample_flags          = flags & 0x000020 ? m_in->read_uint32_be() : defaults.sample_flags;
+
+  // The track's parameters are taken from its first sample
+  // description. Samples using another one cannot be muxed with them.
+  if (m_fragment_dmx && (1 != m_fragment.sample_description_id)) {
+    m_fragment.skip_samples = true;
+
+    if (!m_fragment_dmx->m_sample_description_warning_printed)
+      mxwarn_tid(m_ti.m_fname, m_fragment_dmx->id,
+                 boost::format(Y("A fragment uses the sample description %1% whereas only the first one is supported. Its samples will be skipped.\n")) % m_fragment.sample_description_id);
+    m_fragment_dmx->m_sample_description_warning_printed = true;
+  }
+
+  mxdebug_if(m_debug_fragments, boost::format("%1%Track fragment for track ID %2% (%3%): base data offset %4% duration %5% size %6% flags %7%\n")
+             % space(level * 2 + 1) % m_fragment.track_id % (m_fragment_dmx ? "known" : "ignored") % m_fragment.base_data_offset
+             % m_fragment.sample_duration % m_fragment.sample_size % m_fragment.sample_flags);
+}
+
+void
+qtmp4_reader_c::handle_tfdt_atom(qt_atom_t,
+                                 int level) {
+  auto version          = m_in->read_uint8();
+  m_in->skip(3);            // flags
+  auto base_decode_time = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+
+  mxdebug_if(m_debug_fragments, boost::format("%1%Base media decode time: %2%\n") % space(level * 2 + 1) % base_decode_time);
+
+  if (m_fragment_dmx)
+    m_fragment_dmx->m_fragment_dts = base_decode_time;
+}
+
+void
+qtmp4_reader_c::handle_trun_atom(qt_atom_t,
+                                 int level) {
+  m_in->skip(1);            // version
+  auto flags              = m_in->read_uint24_be();
+  auto num_samples        = m_in->read_uint32_be();
+  auto data_offset        = flags & 0x000001 ? m_fragment.base_data_offset + static_cast<int32_t>(m_in->read_uint32_be()) : m_fragment.next_data_offset;
+  auto first_sample_flags = flags & 0x000004 ? m_in->read_uint32_be()                                                       : m_fragment.sample_flags;
+
+  mxdebug_if(m_debug_fragments, boost::format("%1%Track run: %2% samples, data offset %3%\n") % space(level * 2 + 1) % num_samples % data_offset);
+
+  for (auto idx = 0u; idx < num_samples; ++idx) {
+    uint32_t sample_duration = flags & 0x000100 ? m_in->read_uint32_be()                      : m_fragment.sample_duration;
+    uint32_t sample_size     = flags & 0x000200 ? m_in->read_uint32_be()                      : m_fragment.sample_size;
+    uint32_t sample_flags    = flags & 0x000400 ? m_in->read_uint32_be()                      : !idx ? first_sample_flags : m_fragment.sample_flags;
+    int64_t  cts_offset      = flags & 0x000800 ? static_cast<int32_t>(m_in->read_uint32_be()) : 0;
+
+    if (m_fragment_dmx && m_fragment.skip_samples)
+      m_fragment_dmx->m_fragment_dts += sample_duration;
+
+    else if (m_fragment_dmx)
+      m_fragment_dmx->add_fragment_index_entry(data_offset, sample_size, sample_duration, cts_offset, !(sample_flags & 0x00010000), m_time_scale);
+
+    data_offset += sample_size;
+  }
+
+  m_fragment.next_data_offset = data_offset;
+  m_fragment_implicit_offset  = data_offset;
+}
+
 void
 qtmp4_reader_c::handle_udta_atom(qt_atom_t parent,
                                  int level) {
@@ -897,6 +1154,8 @@ qtmp4_reader_c::handle_stsd_atom(qtmp4_demuxer_cptr &new_dmx,
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
 
+  new_dmx->m_num_sample_descriptions = count;
+
   size_t i;
   for (i = 0; i < count; ++i) {
     int64_t pos   = m_in->getFilePointer();
@@ -1132,6 +1391,10 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
     if ((-1 == dmx->ptzr) || (PTZR(dmx->ptzr) != ptzr))
       continue;
 
+    if (m_fragmented)
+      while ((dmx->pos >= dmx->m_index.size()) && parse_next_fragment())
+        ;
+
     if (dmx->pos < dmx->m_index.size())
       break;
   }
@@ -1148,7 +1411,7 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
   memory_cptr buffer;
 
   if (   dmx->is_video()
-      && !dmx->pos
+      && !(dmx->pos + dmx->m_num_index_entries_dropped)
       && (dmx->fourcc.equiv("mp4v") || dmx->fourcc.equiv("xvid"))
       && dmx->esds_parsed
       && (dmx->esds.decoder_config)) {
@@ -1170,6 +1433,10 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
   PTZR(dmx->ptzr)->process(new packet_t(buffer, index.timecode, index.duration, index.is_keyframe ? VFT_IFRAME : VFT_PFRAMEAUTOMATIC, VFT_NOBFRAME));
   ++dmx->pos;
 
+  if (m_fragmented)
+    while ((dmx->pos >= dmx->m_index.size()) && parse_next_fragment())
+      ;
+
   if (dmx->pos < dmx->m_index.size())
     return FILE_STATUS_MOREDATA;
 
@@ -1252,7 +1519,7 @@ qtmp4_reader_c::create_video_packetizer_mpeg1_2(qtmp4_demuxer_cptr &dmx) {
 
 void
 qtmp4_reader_c::create_video_packetizer_mpeg4_p10(qtmp4_demuxer_cptr &dmx) {
-  if (dmx->frame_offset_table.empty())
+  if (dmx->frame_offset_table.empty() && !m_fragmented)
     mxwarn_tid(m_ti.m_fname, dmx->id,
                Y("The AVC video track is missing the 'CTTS' atom for frame timecode offsets. "
                  "However, AVC/h.264 allows frames to have more than the traditional one (for P frames) or two (for B frames) references to other frames. "
@@ -1471,6 +1738,14 @@ qtmp4_reader_c::create_packetizers() {
 
   for (i = 0; i < m_demuxers.size(); ++i)
     create_packetizer(m_demuxers[i]->id);
+
+  // Don't collect index entries for tracks that aren't read.
+  if (m_fragmented)
+    for (auto &dmx : m_demuxers)
+      if (-1 == dmx->ptzr) {
+        dmx->ok = false;
+        dmx->m_index.clear();
+      }
 }
 
 int
@@ -1478,6 +1753,9 @@ qtmp4_reader_c::get_progress() {
   if (-1 == m_main_dmx)
     return 100;
 
+  if (m_fragmented)
+    return 100 * std::min<uint64_t>(m_next_fragment_pos, m_size) / std::max<uint64_t>(m_size, 1);
+
   qtmp4_demuxer_cptr &dmx = m_demuxers[m_main_dmx];
   unsigned int max_chunks = (0 == dmx->sample_size) ? dmx->sample_table.size() : dmx->chunk_table.size();
 
@@ -1615,6 +1893,11 @@ qtmp4_demuxer_c::calculate_fps() {
       fps = (double)1000000000.0 / (double)to_nsecs(most_common.first);
 
     mxdebug_if(m_debug_fps, boost::format("calculate_fps: case 2: most_common %1% = %2%, fps %3%\n") % most_common.first % most_common.second % fps);
+
+  } else if (0 != m_defaults.sample_duration) {
+    // Fragmented file without samples in the 'moov' atom.
+    fps = (double)time_scale / (double)m_defaults.sample_duration;
+    mxdebug_if(m_debug_fps, boost::format("calculate_fps: case 3: %1%\n") % fps);
   }
 }
 
@@ -1726,6 +2009,12 @@ qtmp4_demuxer_c::min_timecode()
   return timecodes.empty() ? 0 : *brng::min_element(timecodes);
 }
 
+bool
+qtmp4_demuxer_c::has_sample_tables()
+  const {
+  return !chunk_table.empty() || !chunkmap_table.empty() || !durmap_table.empty() || !sample_table.empty();
+}
+
 bool
 qtmp4_demuxer_c::update_tables(int64_t global_m_time_scale) {
   uint64_t last = chunk_table.size();
@@ -1968,6 +2257,64 @@ qtmp4_demuxer_c::build_index_chunk_mode() {
   }
 }
 
+void
+qtmp4_demuxer_c::init_fragment_timeline(int64_t first_composition_offset,
+                                        int64_t global_time_scale) {
+  // Map the fragments' decode times to the presentation timeline the
+  // same way calculate_timecodes_variable_sample_size() and
+  // update_editlist_table() do it for the 'moov' sample tables.
+  bool is_avc          = ('v' == type) && v_is_avc;
+  auto first_offset    = frame_offset_table.empty() ? first_composition_offset : static_cast<int64_t>(frame_offset_table[0]);
+  auto media_start     = first_offset;
+  int64_t empty_offset = 0;
+
+  for (auto &edit : editlist_table) {
+    if (-1 == edit.pos) {
+      empty_offset += edit.duration * time_scale / global_time_scale;
+      continue;
+    }
+
+    media_start = edit.pos;
+    break;
+  }
+
+  m_fragment_shift                = (is_avc ? 0 : first_offset) - media_start + empty_offset;
+  m_fragment_timeline_initialized = true;
+
+  mxdebug_if(m_debug_editlists, boost::format("Track ID %1%: fragment timeline: first composition offset %2% media start %3% empty edit offset %4% shift %5%\n")
+             % id % first_offset % media_start % empty_offset % m_fragment_shift);
+}
+
+void
+qtmp4_demuxer_c::add_fragment_index_entry(int64_t file_pos,
+                                          int64_t size,
+                                          int64_t sample_duration,
+                                          int64_t composition_offset,
+                                          bool is_keyframe,
+                                          int64_t global_time_scale) {
+  if (!m_fragment_timeline_initialized)
+    init_fragment_timeline(composition_offset, global_time_scale);
+
+  bool is_avc       = ('v' == type) && v_is_avc;
+  int64_t timecode  = to_nsecs(m_fragment_dts + (is_avc ? composition_offset : 0) + m_fragment_shift) + constant_editlist_offset_ns;
+  m_fragment_dts   += sample_duration;
+
+  m_index.push_back(qt_index_t(file_pos, size, timecode, to_nsecs(sample_duration), is_keyframe));
+
+  mxdebug_if(m_debug_tables, boost::format("  fragment sample: pos %1% size %2% timecode %3% duration %4% key %5%\n")
+             % file_pos % size % format_timecode(timecode) % format_timecode(m_index.back().duration) % is_keyframe);
+}
+
+void
+qtmp4_demuxer_c::drop_consumed_index_entries() {
+  if (!pos)
+    return;
+
+  m_index.erase(m_index.begin(), m_index.begin() + std::min<size_t>(pos, m_index.size()));
+  m_num_index_entries_dropped += pos;
+  pos                          = 0;
+}
+
 bool
 qtmp4_demuxer_c::read_first_bytes(memory_cptr &buf,
                                   int num_bytes,
@@ -130,6 +130,44 @@ struct qt_index_t {
   }
 };
 
+struct qt_track_defaults_t {
+  uint32_t sample_description_id;
+  uint32_t sample_duration;
+  uint32_t sample_size;
+  uint32_t sample_flags;
+
+  qt_track_defaults_t()
+    : sample_description_id{}
+    , sample_duration{}
+    , sample_size{}
+    , sample_flags{}
+  {
+  }
+};
+
+struct qt_fragment_t {
+  uint32_t track_id;
+  uint32_t sample_description_id;
+  uint32_t sample_duration;
+  uint32_t sample_size;
+  uint32_t sample_flags;
+  uint64_t base_data_offset;
+  uint64_t next_data_offset;
+  bool skip_samples;
+
+  qt_fragment_t()
+    : track_id{}
+    , sample_description_id{}
+    , sample_duration{}
+    , sample_size{}
+    , sample_flags{}
+    , base_data_offset{}
+    , next_data_offset{}
+    , skip_samples{}
+  {
+  }
+};
+
 struct qtmp4_demuxer_c {
   bool ok;
 
@@ -154,6 +192,15 @@ struct qtmp4_demuxer_c {
 
   std::vector<qt_index_t> m_index;
 
+  // Fragmented files: defaults from the 'trex' atom, the decode time
+  // of the next sample in the track's time scale and the offset
+  // mapping it to the presentation timeline.
+  qt_track_defaults_t m_defaults;
+  int64_t m_fragment_dts, m_fragment_shift;
+  bool m_fragment_timeline_initialized, m_sample_description_warning_printed;
+  uint64_t m_num_index_entries_dropped;
+  uint32_t m_num_sample_descriptions;
+
   double fps;
 
   esds_t esds;
@@ -191,6 +238,12 @@ struct qtmp4_demuxer_c {
     , global_duration{0}
     , constant_editlist_offset_ns{0}
     , sample_size{0}
+    , m_fragment_dts{0}
+    , m_fragment_shift{0}
+    , m_fragment_timeline_initialized{false}
+    , m_sample_description_warning_printed{false}
+    , m_num_index_entries_dropped{0}
+    , m_num_sample_descriptions{0}
     , fps{0.0}
     , esds_parsed{false}
     , stsd_non_priv_struct_size{}
@@ -228,6 +281,11 @@ struct qtmp4_demuxer_c {
   void update_editlist_table(int64_t global_time_scale);
 
   void build_index();
+  bool has_sample_tables() const;
+
+  void init_fragment_timeline(int64_t first_composition_offset, int64_t global_time_scale);
+  void add_fragment_index_entry(int64_t file_pos, int64_t size, int64_t sample_duration, int64_t composition_offset, bool is_keyframe, int64_t global_time_scale);
+  void drop_consumed_index_entries();
 
   bool read_first_bytes(memory_cptr &buf, int num_bytes, mm_io_cptr in);
 
@@ -332,9 +390,15 @@ private:
   fourcc_c m_compression_algorithm;
   int m_main_dmx;
 
+  bool m_fragmented;
+  uint64_t m_next_fragment_pos, m_moof_pos, m_fragment_implicit_offset;
+  qt_fragment_t m_fragment;
+  qtmp4_demuxer_c *m_fragment_dmx;
+  std::unordered_map<unsigned int, qt_track_defaults_t> m_track_defaults;
+
   unsigned int m_audio_encoder_delay_samples;
 
-  bool m_debug_chapters, m_debug_headers, m_debug_tables, m_debug_interleaving, m_debug_resync;
+  bool m_debug_chapters, m_debug_headers, m_debug_tables, m_debug_interleaving, m_debug_resync, m_debug_fragments;
 
 public:
   qtmp4_reader_c(const track_info_c &ti, const mm_io_cptr &in);
@@ -360,6 +424,8 @@ protected:
   virtual qt_atom_t read_atom(mm_io_c *read_from = nullptr, bool exit_on_error = true);
   virtual bool resync_to_top_level_atom(uint64_t start_pos);
   virtual void parse_itunsmpb(std::string data);
+  virtual bool parse_next_fragment();
+  virtual bool verify_fragment_defaults(qtmp4_demuxer_c &dmx);
 
   virtual void handle_cmov_atom(qt_atom_t parent, int level);
   virtual void handle_cmvd_atom(qt_atom_t parent, int level);
@@ -371,6 +437,13 @@ protected:
   virtual void handle_minf_atom(qtmp4_demuxer_cptr &new_dmx, qt_atom_t parent, int level);
   virtual void handle_moov_atom(qt_atom_t parent, int level);
   virtual void handle_mvhd_atom(qt_atom_t parent, int level);
+  virtual void handle_mvex_atom(qt_atom_t parent, int level);
+  virtual void handle_trex_atom(qt_atom_t parent, int level);
+  virtual void handle_moof_atom(qt_atom_t parent, int level);
+  virtual void handle_traf_atom(qt_atom_t parent, int level);
+  virtual void handle_tfhd_atom(qt_atom_t parent, int level);
+  virtual void handle_tfdt_atom(qt_atom_t parent, int level);
+  virtual void handle_trun_atom(qt_atom_t parent, int level);
   virtual void handle_udta_atom(qt_atom_t parent, int level);
   virtual void handle_chpl_atom(qt_atom_t parent, int level);
   virtual void handle_meta_atom(qt_atom_t parent, int level);
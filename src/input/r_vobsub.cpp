@@ -17,6 +17,7 @@
 #include "common/iso639.h"
 #include "common/endian.h"
 #include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
 #include "input/r_vobsub.h"
@@ -81,7 +82,10 @@ vobsub_reader_c::read_headers() {
   sub_name += ".sub";
 
   try {
-    m_sub_file = mm_file_io_cptr(new mm_file_io_c(sub_name));
+    // The SPUs are assembled from the PS packets' payload after all
+    // of them have been located. A large buffer keeps both the header
+    // scanning and the seeks back to the payload inside memory.
+    m_sub_file = mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(sub_name), 1 << 17));
   } catch (...) {
     throw mtx::input::extended_x(boost::format(Y("%1%: Could not open the sub file")) % get_format_name());
   }
@@ -330,7 +334,6 @@ vobsub_reader_c::parse_headers() {
   }
 }
 
-#define deliver() deliver_packet(dst_buf, dst_size, timecode, duration, PTZR(track->ptzr));
 int
 vobsub_reader_c::deliver_packet(unsigned char *buf,
                                 int size,
@@ -414,6 +417,36 @@ vobsub_reader_c::deliver_packet(unsigned char *buf,
   return -1;
 }
 
+unsigned char *
+vobsub_reader_c::assemble_spu_packet(std::vector<vobsub_spu_piece_t> const &pieces,
+                                     uint32_t &size) {
+  if (!size)
+    return nullptr;
+
+  // Space for the stop display command and padding
+  auto padding          = hack_engaged(ENGAGE_VOBSUB_SUBPIC_STOP_CMDS) ? 6 : 0;
+  unsigned char *buffer = safemalloc(size + padding);
+  uint32_t offset       = 0;
+
+  memset(buffer + size, 0xff, padding);
+
+  for (auto &piece : pieces) {
+    m_sub_file->setFilePointer(piece.position);
+    auto num_read = m_sub_file->read(buffer + offset, piece.size);
+    offset       += num_read;
+
+    if (num_read != piece.size) {
+      mxwarn(Y("vobsub_reader: sub file read failure"));
+      memset(buffer + offset, 0xff, padding);
+      break;
+    }
+  }
+
+  size = offset;
+
+  return buffer;
+}
+
 // Adopted from mplayer's vobsub.c
 int
 vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
@@ -430,12 +463,23 @@ vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
   uint64_t extraction_end_pos   = track->idx >= track->entries.size() - 1 ? m_sub_file->get_size() : track->entries[track->idx + 1].position;
 
   int64_t pts                   = 0;
-  unsigned char *dst_buf        = nullptr;
   uint32_t dst_size             = 0;
   uint32_t packet_size          = 0;
   unsigned int spu_len          = 0;
   bool spu_len_valid            = false;
 
+  bool fix_spu_len              = false;
+
+  std::vector<vobsub_spu_piece_t> spu_pieces;
+
+  auto deliver = [&]() -> int {
+    auto dst_buf = assemble_spu_packet(spu_pieces, dst_size);
+    if (fix_spu_len && (2 < dst_size))
+      put_uint16_be(dst_buf, dst_size);
+
+    return deliver_packet(dst_buf, dst_size, timecode, duration, PTZR(track->ptzr));
+  };
+
   m_sub_file->setFilePointer(extraction_start_pos);
   track->packet_num++;
 
@@ -445,9 +489,7 @@ vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
         mxverb(3,
                boost::format("r_vobsub.cpp: stddeliver spu_len different from dst_size; pts %5% spu_len %1% dst_size %2% curpos %3% endpos %4%\n")
                % spu_len % dst_size % m_sub_file->getFilePointer() % extraction_end_pos % format_timecode(pts));
-      if (2 < dst_size)
-        put_uint16_be(dst_buf, dst_size);
-
+      fix_spu_len = true;
       return deliver();
     }
     if (m_sub_file->read(buf, 4) != 4)
@@ -562,22 +604,27 @@ vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
             break;
           }
 
-          if (hack_engaged(ENGAGE_VOBSUB_SUBPIC_STOP_CMDS)) {
-            // Space for the stop display command and padding
-            dst_buf = (unsigned char *)saferealloc(dst_buf, dst_size + packet_size + 6);
-            memset(dst_buf + dst_size + packet_size, 0xff, 6);
+          mxverb(3, boost::format("vobsub_reader: sub packet data: aid: %1%, pts: %2%, packet_size: %3%\n") % track->aid % format_timecode(pts, 3) % packet_size);
 
-          } else
-            dst_buf = (unsigned char *)saferealloc(dst_buf, dst_size + packet_size);
+          // Only remember where the payload is. It is read in one go
+          // once the whole SPU has been located.
+          spu_pieces.emplace_back(m_sub_file->getFilePointer(), packet_size);
 
-          mxverb(3, boost::format("vobsub_reader: sub packet data: aid: %1%, pts: %2%, packet_size: %3%\n") % track->aid % format_timecode(pts, 3) % packet_size);
-          if (m_sub_file->read(&dst_buf[dst_size], packet_size) != packet_size) {
-            mxwarn(Y("vobsub_reader: sub file read failure"));
-            return deliver();
-          }
           if (!spu_len_valid) {
-            spu_len       = get_uint16_be(dst_buf);
+            if (m_sub_file->read(buf, 2) != 2) {
+              spu_pieces.pop_back();
+              mxwarn(Y("vobsub_reader: sub file read failure"));
+              return deliver();
+            }
+            spu_len       = get_uint16_be(buf);
             spu_len_valid = true;
+            m_sub_file->setFilePointer(spu_pieces.back().position);
+          }
+
+          if (!m_sub_file->setFilePointer2(packet_size, seek_current)) {
+            spu_pieces.pop_back();
+            mxwarn(Y("vobsub_reader: sub file read failure"));
+            return deliver();
           }
 
           dst_size        += packet_size;
@@ -54,10 +54,21 @@ public:
   }
 };
 
+struct vobsub_spu_piece_t {
+  uint64_t position;
+  uint32_t size;
+
+  vobsub_spu_piece_t(uint64_t p_position, uint32_t p_size)
+    : position(p_position)
+    , size(p_size)
+  {
+  }
+};
+
 class vobsub_reader_c: public generic_reader_c {
 private:
   mm_text_io_cptr m_idx_file;
-  mm_file_io_cptr m_sub_file;
+  mm_io_cptr m_sub_file;
   int version;
   int64_t num_indices, indices_processed, delay;
   std::string idx_data;
@@ -94,6 +105,7 @@ protected:
   virtual int deliver_packet(unsigned char *buf, int size, int64_t timecode, int64_t default_duration, generic_packetizer_c *ptzr);
 
   virtual int extract_one_spu_packet(int64_t track_id);
+  virtual unsigned char *assemble_spu_packet(std::vector<vobsub_spu_piece_t> const &pieces, uint32_t &size);
 };
 
 #endif  // MTX_R_VOBSUB_H
@@ -122,8 +122,7 @@ class wav_dts_demuxer_c: public wav_demuxer_c {
 private:
   bool m_swap_bytes, m_pack_14_16;
   dts_header_t m_dtsheader;
-  memory_cptr m_buf[2];
-  int m_cur_buf;
+  memory_cptr m_buf;
 
 public:
   wav_dts_demuxer_c(wav_reader_c *reader, wave_header *wheader);
@@ -137,7 +136,7 @@ public:
   };
 
   virtual unsigned char *get_buffer() {
-    return m_buf[m_cur_buf]->get_buffer();
+    return m_buf->get_buffer();
   };
 
   virtual void process(int64_t len);
@@ -153,6 +152,7 @@ private:
 class wav_pcm_demuxer_c: public wav_demuxer_c {
 private:
   int m_bps;
+  int64_t m_read_size;
   memory_cptr m_buffer;
   bool ieee_float;
 
@@ -162,7 +162,7 @@ public:
   virtual ~wav_pcm_demuxer_c();
 
   virtual int64_t get_preferred_input_size() {
-    return m_bps;
+    return m_read_size;
   };
 
   virtual unsigned char *get_buffer() {
@@ -311,10 +311,7 @@ wav_dts_demuxer_c::wav_dts_demuxer_c(wav_reader_c *reader,
   wav_demuxer_c(reader, wheader),
   m_swap_bytes(false),
   m_pack_14_16(false),
-  m_cur_buf(0) {
-
-  m_buf[0] = memory_c::alloc(DTS_READ_SIZE);
-  m_buf[1] = memory_c::alloc(DTS_READ_SIZE);
+  m_buf(memory_c::alloc(DTS_READ_SIZE)) {
 }
 
 wav_dts_demuxer_c::~wav_dts_demuxer_c() {
@@ -323,14 +320,14 @@ wav_dts_demuxer_c::~wav_dts_demuxer_c() {
 bool
 wav_dts_demuxer_c::probe(mm_io_cptr &io) {
   io->save_pos();
-  int len = io->read(m_buf[m_cur_buf]->get_buffer(), DTS_READ_SIZE);
+  int len = io->read(m_buf->get_buffer(), DTS_READ_SIZE);
   io->restore_pos();
 
-  if (detect_dts(m_buf[m_cur_buf]->get_buffer(), len, m_pack_14_16, m_swap_bytes)) {
+  if (detect_dts(m_buf->get_buffer(), len, m_pack_14_16, m_swap_bytes)) {
     len     = decode_buffer(len);
-    int pos = find_consecutive_dts_headers(m_buf[m_cur_buf]->get_buffer(), len, 5);
+    int pos = find_consecutive_dts_headers(m_buf->get_buffer(), len, 5);
     if (0 <= pos) {
-      if (0 > find_dts_header(m_buf[m_cur_buf]->get_buffer() + pos, len - pos, &m_dtsheader))
+      if (0 > find_dts_header(m_buf->get_buffer() + pos, len - pos, &m_dtsheader))
         return false;
 
       mxverb(3, boost::format("DTSinWAV: 14->16 %1% swap %2%\n") % m_pack_14_16 % m_swap_bytes);
@@ -343,15 +340,15 @@ wav_dts_demuxer_c::probe(mm_io_cptr &io) {
 
 int
 wav_dts_demuxer_c::decode_buffer(int len) {
-  if (m_swap_bytes) {
-    swab((char *)m_buf[m_cur_buf]->get_buffer(), (char *)m_buf[m_cur_buf ^ 1]->get_buffer(), len);
-    m_cur_buf ^= 1;
-  }
+  // Both conversions work in place on the buffer the data was read
+  // into.
+  if (m_swap_bytes)
+    swap_16bit_words(m_buf->get_buffer(), len);
 
   if (m_pack_14_16) {
-    dts_14_to_dts_16((unsigned short *)m_buf[m_cur_buf]->get_buffer(), len / 2, (unsigned short *)m_buf[m_cur_buf ^ 1]->get_buffer());
-    m_cur_buf ^= 1;
-    len        = len * 7 / 8;
+    auto words = reinterpret_cast<unsigned short *>(m_buf->get_buffer());
+    dts_14_to_dts_16(words, len / 2, words);
+    len = len * 7 / 8;
   }
 
   return len;
@@ -378,7 +375,7 @@ wav_dts_demuxer_c::process(int64_t size) {
     return;
 
   long dec_len = decode_buffer(size);
-  m_ptzr->process(new packet_t(new memory_c(m_buf[m_cur_buf]->get_buffer(), dec_len, false)));
+  m_ptzr->process(new packet_t(new memory_c(m_buf->get_buffer(), dec_len, false)));
 }
 
 // ----------------------------------------------------------
@@ -388,10 +385,12 @@ wav_pcm_demuxer_c::wav_pcm_demuxer_c(wav_reader_c *reader,
                                      bool _float):
   wav_demuxer_c(reader, wheader),
   m_bps(0),
+  m_read_size(0),
   ieee_float(_float) {
 
-  m_bps    = get_uint16_le(&m_wheader->common.wChannels) * get_uint16_le(&m_wheader->common.wBitsPerSample) * get_uint32_le(&m_wheader->common.dwSamplesPerSec) / 8;
-  m_buffer = memory_c::alloc(m_bps);
+  m_bps       = get_uint16_le(&m_wheader->common.wChannels) * get_uint16_le(&m_wheader->common.wBitsPerSample) * get_uint32_le(&m_wheader->common.dwSamplesPerSec) / 8;
+  m_read_size = m_bps;
+  m_buffer    = memory_c::alloc(m_read_size);
 }
 
 wav_pcm_demuxer_c::~wav_pcm_demuxer_c() {
@@ -399,11 +398,19 @@ wav_pcm_demuxer_c::~wav_pcm_demuxer_c() {
 
 generic_packetizer_c *
 wav_pcm_demuxer_c::create_packetizer() {
-  m_ptzr = new pcm_packetizer_c(m_reader, m_ti,
-                                get_uint32_le(&m_wheader->common.dwSamplesPerSec),
-                                get_uint16_le(&m_wheader->common.wChannels),
-                                get_uint16_le(&m_wheader->common.wBitsPerSample),
-                                ieee_float);
+  auto ptzr = new pcm_packetizer_c(m_reader, m_ti,
+                                   get_uint32_le(&m_wheader->common.dwSamplesPerSec),
+                                   get_uint16_le(&m_wheader->common.wChannels),
+                                   get_uint16_le(&m_wheader->common.wBitsPerSample),
+                                   ieee_float);
+  m_ptzr    = ptzr;
+
+  // Read exactly one packet at a time. The packetizer can then use
+  // the buffers as they are without copying them.
+  if (ptzr->get_packet_size()) {
+    m_read_size = ptzr->get_packet_size();
+    m_buffer    = memory_c::alloc(m_read_size);
+  }
 
   show_packetizer_info(0, m_ptzr);
 
@@ -415,7 +422,12 @@ wav_pcm_demuxer_c::process(int64_t len) {
   if (0 >= len)
     return;
 
-  m_ptzr->process(new packet_t(new memory_c(m_buffer->get_buffer(), len, false)));
+  // Hand the buffer itself over to the packetizer and read the next
+  // packet into a fresh one.
+  m_buffer->set_size(len);
+  m_ptzr->process(new packet_t(m_buffer));
+
+  m_buffer = memory_c::alloc(m_read_size);
 }
 
 // ----------------------------------------------------------
@@ -14,6 +14,8 @@
 
 #include "common/common_pch.h"
 
+#include <chrono>
+
 #include "common/ebml.h"
 #include "common/hacks.h"
 #include "common/math.h"
@@ -26,6 +28,7 @@
 
 #include <matroska/KaxBlock.h>
 #include <matroska/KaxBlockData.h>
+#include <matroska/KaxClusterData.h>
 #include <matroska/KaxCuesData.h>
 #include <matroska/KaxSeekHead.h>
 
@@ -54,15 +57,25 @@ cluster_helper_c::cluster_helper_c()
   , m_current_split_point(m_split_points.begin())
   , m_discarding{false}
   , m_splitting_and_processed_fully{false}
+  , m_num_packets_rendered{}
+  , m_rendering_time{}
   , m_debug_splitting{debugging_requested("cluster_helper|splitting")}
   , m_debug_packets{  debugging_requested("cluster_helper|cluster_helper_packets")}
   , m_debug_duration{ debugging_requested("cluster_helper|cluster_helper_duration")}
   , m_debug_rendering{debugging_requested("cluster_helper|cluster_helper_rendering")}
+  , m_debug_rendering_speed{debugging_requested("cluster_helper|cluster_helper_rendering_speed")}
 {
 }
 
 cluster_helper_c::~cluster_helper_c() {
   delete m_cluster;
+
+  // Index 0: rendered with libmatroska, index 1: serialized directly.
+  for (auto directly = 0; 2 > directly; ++directly)
+    mxdebug_if(m_debug_rendering_speed,
+               boost::format("cluster_helper_c: rendering %1%: %2% packets in %3% ms, %4% packets/s\n")
+               % (directly ? "directly" : "with libmatroska") % m_num_packets_rendered[directly] % (m_rendering_time[directly] / 1000)
+               % (m_rendering_time[directly] ? m_num_packets_rendered[directly] * 1000000 / m_rendering_time[directly] : 0));
 }
 
 void
@@ -267,7 +280,15 @@ cluster_helper_c::set_duration(render_groups_c *rg) {
   if (rg->m_durations.empty())
     return;
 
-  kax_block_blob_c *group = rg->m_groups.back().get();
+  auto block_duration = calculate_block_duration(rg);
+  if (-1 != block_duration)
+    rg->m_groups.back()->set_block_duration(block_duration);
+}
+
+// Returns the BlockDuration to set for the render group's last group
+// or -1 if none is needed.
+int64_t
+cluster_helper_c::calculate_block_duration(render_groups_c *rg) {
   int64_t def_duration    = rg->m_source->get_track_default_duration();
   int64_t block_duration  = 0;
 
@@ -282,13 +303,15 @@ cluster_helper_c::set_duration(render_groups_c *rg) {
     if (   (0 == block_duration)
         || (   (0 < block_duration)
             && (block_duration != (static_cast<int64_t>(rg->m_durations.size()) * def_duration))))
-      group->set_block_duration(RND_TIMECODE_SCALE(block_duration));
+      return RND_TIMECODE_SCALE(block_duration);
 
   } else if (   (   g_use_durations
                  || (0 < def_duration))
              && (0 < block_duration)
              && (RND_TIMECODE_SCALE(block_duration) != RND_TIMECODE_SCALE(rg->m_durations.size() * def_duration)))
-    group->set_block_duration(RND_TIMECODE_SCALE(block_duration));
+    return RND_TIMECODE_SCALE(block_duration);
+
+  return -1;
 }
 
 bool
@@ -326,6 +349,36 @@ cluster_helper_c::must_duration_be_set(render_groups_c *rg,
 
 int
 cluster_helper_c::render() {
+  // In sequential output mode the headers are only written once the
+  // first cluster is.
+  write_pending_headers();
+
+  // Splitpoint stuff
+  if ((-1 == m_header_overhead) && splitting())
+    m_header_overhead = m_out->getFilePointer() + g_tags_size;
+
+  // Make sure that we don't have negative/wrapped around timecodes in the output file.
+  // Can happend when we're splitting; so adjust timecode_offset accordingly.
+  m_timecode_offset       = boost::accumulate(m_packets, m_timecode_offset, [](int64_t a, const packet_cptr &p) { return std::min(a, p->assigned_timecode); });
+  int64_t timecode_offset = m_timecode_offset + get_discarded_duration();
+
+  auto directly           = can_render_directly() ? 1 : 0;
+  auto start              = std::chrono::high_resolution_clock::now();
+  auto result             = directly ? render_directly(timecode_offset) : render_with_libmatroska(timecode_offset);
+
+  m_rendering_time[directly]       += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+  m_num_packets_rendered[directly] += m_packets.size();
+
+  // Let whoever reads the output while it is being written see
+  // complete clusters as early as possible.
+  if (g_flush_after_each_cluster)
+    m_out->flush();
+
+  return result;
+}
+
+int
+cluster_helper_c::render_with_libmatroska(int64_t timecode_offset) {
   std::vector<render_groups_cptr> render_groups;
   KaxCues cues;
   cues.SetGlobalTimecodeScale(g_timecode_scale);
@@ -340,15 +393,6 @@ cluster_helper_c::render() {
   int elements_in_cluster = 0;
   bool added_to_cues      = false;
 
-  // Splitpoint stuff
-  if ((-1 == m_header_overhead) && splitting())
-    m_header_overhead = m_out->getFilePointer() + g_tags_size;
-
-  // Make sure that we don't have negative/wrapped around timecodes in the output file.
-  // Can happend when we're splitting; so adjust timecode_offset accordingly.
-  m_timecode_offset       = boost::accumulate(m_packets, m_timecode_offset, [](int64_t a, const packet_cptr &p) { return std::min(a, p->assigned_timecode); });
-  int64_t timecode_offset = m_timecode_offset + get_discarded_duration();
-
   for (auto &pack : m_packets) {
     generic_packetizer_c *source = pack->source;
     bool has_codec_state         = !!pack->codec_state;
@@ -504,6 +548,176 @@ cluster_helper_c::render() {
   return 1;
 }
 
+// Clusters consisting only of blocks whose groups contain nothing
+// but references and durations are serialized directly instead of
+// building libmatroska elements for each block. Everything else is
+// left to libmatroska.
+bool
+cluster_helper_c::can_render_directly()
+  const {
+  if (   m_packets.empty()
+      || discarding()
+      || hack_engaged(ENGAGE_NO_DIRECT_CLUSTER_RENDERING)
+      || hack_engaged(ENGAGE_LACING_XIPH)
+      || hack_engaged(ENGAGE_LACING_EBML))
+    return false;
+
+  int64_t min_cl_timecode = boost::accumulate(m_packets, std::numeric_limits<int64_t>::max(), [](int64_t a, const packet_cptr &p) { return std::min(a, p->assigned_timecode); });
+
+  // Leave timecodes that don't fit into a block's 16bit relative
+  // timecode to libmatroska's checks.
+  for (auto &pack : m_packets)
+    if (   pack->codec_state
+        || !pack->data_adds.empty()
+        || (0 < pack->ref_priority)
+        || pack->source->contains_gap()
+        || !kax_cluster_renderer_c::is_relative_timecode_valid((pack->assigned_timecode - min_cl_timecode) / static_cast<int64_t>(g_timecode_scale)))
+      return false;
+
+  return true;
+}
+
+// Produces the same bytes KaxCluster::Render() would for the clusters
+// accepted by can_render_directly().
+int
+cluster_helper_c::render_directly(int64_t timecode_offset) {
+  // A source's key frames are laced into its previous block just like
+  // render_with_libmatroska() does, even if other sources' blocks
+  // follow that block. Therefore all blocks are assembled before the
+  // first one is serialized.
+  struct block_t {
+    render_groups_c rg;
+    int64_t timecode;
+    bool use_group;
+    kax_cluster_renderer_c::frames_t frames;
+    std::vector<int64_t> references;
+    bool key_frame, discardable;
+
+    block_t(generic_packetizer_c *source)
+      : rg{source}
+      , timecode{}
+      , use_group{}
+      , key_frame{}
+      , discardable{}
+    {
+    }
+  };
+
+  bool use_simpleblock    = !hack_engaged(ENGAGE_NO_SIMPLE_BLOCKS);
+  int64_t min_cl_timecode = boost::accumulate(m_packets, std::numeric_limits<int64_t>::max(), [](int64_t a, const packet_cptr &p) { return std::min(a, p->assigned_timecode); });
+  int64_t cluster_tc      = min_cl_timecode - timecode_offset;
+  int64_t scale           = g_timecode_scale;
+  uint64_t cluster_pos    = m_out->getFilePointer();
+  bool added_to_cues      = false;
+
+  std::vector<block_t> blocks;
+  std::map<generic_packetizer_c *, size_t> lacing_blocks;
+  std::vector<cue_point_t> cue_points;
+  id_timecode_values_t block_positions;
+
+  for (auto &pack : m_packets) {
+    auto source    = pack->source;
+    auto track_num = source->get_track_num();
+    auto block_tc  = pack->assigned_timecode - timecode_offset;
+
+    if (g_video_packetizer == source)
+      m_max_video_timecode_rendered = std::max(pack->assigned_timecode + pack->get_duration(), m_max_video_timecode_rendered);
+
+    auto lacing_block = lacing_blocks.find(source);
+    if (!pack->is_key_frame() && (lacing_blocks.end() != lacing_block)) {
+      lacing_blocks.erase(lacing_block);
+      lacing_block = lacing_blocks.end();
+    }
+
+    auto block_idx = lacing_blocks.end() != lacing_block ? lacing_block->second : blocks.size();
+
+    if (blocks.size() == block_idx) {
+      auto past_ref = pack->has_bref() ? pack->bref - timecode_offset : -1;
+      auto forw_ref = pack->has_fref() ? pack->fref - timecode_offset : -1;
+
+      blocks.emplace_back(source);
+      auto &block       = blocks.back();
+      block.timecode    = block_tc;
+      block.use_group   = !use_simpleblock || must_duration_be_set(&block.rg, pack);
+      block.key_frame   = (-1 == past_ref) && (-1 == forw_ref);
+      block.discardable = ((-1 != forw_ref) && (forw_ref > block_tc)) || ((-1 != past_ref) && (past_ref > block_tc));
+
+      if (0 <= past_ref)
+        block.references.push_back((past_ref - block_tc) / scale);
+      if (0 <= forw_ref)
+        block.references.push_back((forw_ref - block_tc) / scale);
+
+      added_to_cues = false;
+    }
+
+    auto &block = blocks[block_idx];
+    block.frames.push_back(pack->data.get());
+    block.rg.m_durations.push_back(pack->get_unmodified_duration());
+    block.rg.m_duration_mandatory |= pack->duration_mandatory;
+
+    // Same conditions as KaxInternalBlock::AddFrame() returning true
+    // for LACING_AUTO and the checks in render_with_libmatroska().
+    if (   pack->is_key_frame()
+        && source->get_track_entry()->LacingEnabled()
+        && (8 > block.frames.size())
+        && (6 * 0xff > pack->data->get_size()))
+      lacing_blocks[source] = block_idx;
+    else
+      lacing_blocks.erase(source);
+
+    if (g_write_cues && !added_to_cues) {
+      added_to_cues = add_to_cues_maybe(pack);
+      if (added_to_cues)
+        cue_points.push_back({ static_cast<uint64_t>(block.timecode / scale * scale), 0, g_kax_segment->GetRelativePosition(cluster_pos), 0, static_cast<uint32_t>(track_num), 0 });
+    }
+
+    if (-1 == m_first_timecode_in_file)
+      m_first_timecode_in_file = pack->assigned_timecode;
+    if (-1 == m_first_timecode_in_part)
+      m_first_timecode_in_part = pack->assigned_timecode;
+
+    m_max_timecode_in_file      = std::max(pack->assigned_timecode,                        m_max_timecode_in_file);
+    m_max_timecode_and_duration = std::max(pack->assigned_timecode + pack->get_duration(), m_max_timecode_and_duration);
+
+    cues_c::get().set_duration_for_id_timecode(track_num, block_tc, pack->get_duration());
+  }
+
+  m_renderer.start(cluster_tc / scale);
+
+  for (auto &block : blocks) {
+    auto track_num = block.rg.m_source->get_track_num();
+    auto local_tc  = static_cast<int16_t>((block.timecode - cluster_tc) / scale);
+    uint64_t position;
+
+    if (!block.use_group)
+      position = m_renderer.add_simple_block(track_num, local_tc, block.key_frame, block.discardable, block.frames);
+
+    else {
+      auto block_duration = calculate_block_duration(&block.rg);
+      position            = m_renderer.add_block_group(track_num, local_tc, block.frames, block.references, -1 == block_duration ? -1 : block_duration / scale);
+    }
+
+    block_positions.emplace_back(id_timecode_t{ track_num, block.timecode }, position);
+  }
+
+  m_bytes_in_file += m_renderer.finish(*m_out);
+
+  m_cluster->set_element_position(cluster_pos);
+  if (g_kax_sh_cues)
+    g_kax_sh_cues->IndexThis(*m_cluster, *g_kax_segment);
+
+  m_previous_cluster_tc = cluster_tc;
+
+  cues_c::get().postprocess_cues(cue_points, block_positions);
+
+  m_min_timecode_in_cluster = -1;
+  m_max_timecode_in_cluster = -1;
+
+  m_cluster->delete_non_blocks();
+
+  return 1;
+}
+
 bool
 cluster_helper_c::add_to_cues_maybe(packet_cptr &pack) {
   auto &source  = *pack->source;
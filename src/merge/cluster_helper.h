@@ -19,6 +19,7 @@
 #include <matroska/KaxBlock.h>
 #include <matroska/KaxCluster.h>
 
+#include "common/kax_cluster_renderer.h"
 #include "common/split_point.h"
 #include "merge/libmatroska_extensions.h"
 #include "merge/pr_generic.h"
@@ -60,7 +61,10 @@ private:
 
   bool m_discarding, m_splitting_and_processed_fully;
 
-  bool m_debug_splitting, m_debug_packets, m_debug_duration, m_debug_rendering;
+  kax_cluster_renderer_c m_renderer;
+  int64_t m_num_packets_rendered[2], m_rendering_time[2];
+
+  bool m_debug_splitting, m_debug_packets, m_debug_duration, m_debug_rendering, m_debug_rendering_speed;
 
 public:
   cluster_helper_c();
@@ -113,6 +117,7 @@ public:
 
 private:
   void set_duration(render_groups_c *rg);
+  int64_t calculate_block_duration(render_groups_c *rg);
   bool must_duration_be_set(render_groups_c *rg, packet_cptr &new_packet);
 
   void render_before_adding_if_necessary(packet_cptr &packet);
@@ -121,6 +126,10 @@ private:
   void split(packet_cptr &packet);
 
   bool add_to_cues_maybe(packet_cptr &pack);
+
+  int render_with_libmatroska(int64_t timecode_offset);
+  bool can_render_directly() const;
+  int render_directly(int64_t timecode_offset);
 };
 
 extern cluster_helper_c *g_cluster_helper;
@@ -25,6 +25,28 @@
 
 cues_cptr cues_c::s_cues;
 
+// Size of the buffer that rendered cue points are collected in before
+// they're written to the output file
+#define CUES_WRITE_BUFFER_SIZE (64 * 1024)
+
+static void
+sort_id_timecode_values(id_timecode_values_t &values) {
+  std::stable_sort(values.begin(), values.end(), [](id_timecode_values_t::value_type const &a, id_timecode_values_t::value_type const &b) { return a.first < b.first; });
+}
+
+// 'values' must have been sorted with sort_id_timecode_values(). If
+// there are several entries for 'key' the one added last is returned,
+// just like a std::map would have kept the last value assigned.
+static id_timecode_values_t::const_iterator
+find_id_timecode_value(id_timecode_values_t const &values,
+                       id_timecode_t const &key) {
+  auto itr = std::upper_bound(values.begin(), values.end(), key, [](id_timecode_t const &a, id_timecode_values_t::value_type const &b) { return a < b.first; });
+  if ((itr == values.begin()) || ((itr - 1)->first != key))
+    return values.end();
+
+  return itr - 1;
+}
+
 cues_c::cues_c()
   : m_num_cue_points_postprocessed{}
   , m_no_cue_duration{hack_engaged(ENGAGE_NO_CUE_DURATION)}
@@ -39,7 +61,7 @@ cues_c::set_duration_for_id_timecode(uint64_t id,
                                      uint64_t timecode,
                                      uint64_t duration) {
   if (!m_no_cue_duration)
-    m_id_timecode_duration_map[ std::make_pair(id, timecode) ] = duration;
+    m_id_timecode_durations.emplace_back(id_timecode_t{ id, timecode }, duration);
 }
 
 void
@@ -63,11 +85,7 @@ cues_c::add(KaxCuePoint &point) {
     uint64_t track_num = FindChildValue<KaxCueTrack>(*positions);
     assert(track_num <= static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
 
-    m_points.push_back({ timecode, 0, FindChildValue<KaxCueClusterPosition>(*positions), static_cast<uint32_t>(track_num), 0 });
-
-    uint64_t codec_state_position = FindChildValue<KaxCueCodecState>(*positions);
-    if (codec_state_position)
-      m_codec_state_position_map[ id_timecode_t{ track_num, timecode } ] = codec_state_position;
+    m_points.push_back({ timecode, 0, FindChildValue<KaxCueClusterPosition>(*positions), FindChildValue<KaxCueCodecState>(*positions), static_cast<uint32_t>(track_num), 0 });
   }
 }
 
@@ -81,48 +99,39 @@ cues_c::write(mm_io_c &out,
   sort();
   // auto end_sort = get_current_time_millis();
 
-  // Need to write the (empty) cues element so that its position will
-  // be set for indexing in g_kax_sh_main. Necessary because there's
-  // no API function to force the position to a certain value; nor is
-  // there a different API function in KaxSeekHead for adding anything
-  // by ID and position manually.
-  out.save_pos();
+  // Need a cues element with the correct position for indexing in
+  // g_kax_sh_main as there's no API function in KaxSeekHead for adding
+  // anything by ID and position manually. Only its position is set so
+  // that nothing has to be written and overwritten afterwards.
   kax_cues_position_dummy_c cues_dummy;
-  cues_dummy.Render(out);
-  out.restore_pos();
+  cues_dummy.set_element_position(out.getFilePointer());
 
   // Write meta seek information if it is not disabled.
   seek_head.IndexThis(cues_dummy, *g_kax_segment);
 
-  // Forcefully write the correct head and copy its content from the
-  // temporary storage location.
+  // Forcefully write the correct head. The cue points themselves are
+  // serialized directly instead of building libebml elements for
+  // each of them.
   auto total_size = calculate_total_size();
   write_ebml_element_head(out, EBML_ID(KaxCues), total_size);
 
-  for (auto &point : m_points) {
-    KaxCuePoint kc_point;
-
-    GetChild<KaxCueTime>(kc_point).SetValue(point.timecode / g_timecode_scale);
+  std::vector<unsigned char> buffer(CUES_WRITE_BUFFER_SIZE);
+  auto buffer_start = &buffer[0];
+  auto buffer_ptr   = buffer_start;
 
-    auto &positions = GetChild<KaxCueTrackPositions>(kc_point);
-    GetChild<KaxCueTrack>(positions).SetValue(point.track_num);
-    GetChild<KaxCueClusterPosition>(positions).SetValue(point.cluster_position);
-
-    auto codec_state_position = m_codec_state_position_map.find({ point.track_num, point.timecode });
-    if (codec_state_position != m_codec_state_position_map.end())
-      GetChild<KaxCueCodecState>(positions).SetValue(codec_state_position->second);
-
-    if (point.relative_position)
-      GetChild<KaxCueRelativePosition>(positions).SetValue(point.relative_position);
-
-    if (point.duration)
-      GetChild<KaxCueDuration>(positions).SetValue(RND_TIMECODE_SCALE(point.duration) / g_timecode_scale);
+  for (auto &point : m_points) {
+    // One cue point takes less than 128 bytes.
+    if ((buffer_ptr - buffer_start + 128) > CUES_WRITE_BUFFER_SIZE) {
+      out.write(buffer_start, buffer_ptr - buffer_start);
+      buffer_ptr = buffer_start;
+    }
 
-    kc_point.Render(out);
+    buffer_ptr = render_point(buffer_ptr, point);
   }
 
+  out.write(buffer_start, buffer_ptr - buffer_start);
+
   m_points.clear();
-  m_codec_state_position_map.clear();
   m_num_cue_points_postprocessed = 0;
 
   // auto end_all = get_current_time_millis();
@@ -131,30 +140,34 @@ cues_c::write(mm_io_c &out,
 
 void
 cues_c::sort() {
-  brng::sort(m_points, [](cue_point_t const &a, cue_point_t const &b) {
-      if (a.timecode < b.timecode)
-        return true;
-      if (a.timecode > b.timecode)
-        return false;
+  auto compare = [](cue_point_t const &a, cue_point_t const &b) {
+    if (a.timecode < b.timecode)
+      return true;
+    if (a.timecode > b.timecode)
+      return false;
 
-      if (a.track_num < b.track_num)
-        return true;
+    if (a.track_num < b.track_num)
+      return true;
 
-      return false;
-    });
+    return false;
+  };
+
+  // Cue points are usually added in order already.
+  if (!std::is_sorted(m_points.begin(), m_points.end(), compare))
+    brng::sort(m_points, compare);
 }
 
-std::map<id_timecode_t, uint64_t>
+id_timecode_values_t
 cues_c::calculate_block_positions(KaxCluster &cluster)
   const {
 
-  std::map<id_timecode_t, uint64_t> positions;
+  id_timecode_values_t positions;
 
   for (auto child : cluster) {
     auto simple_block = dynamic_cast<KaxSimpleBlock *>(child);
     if (simple_block) {
       simple_block->SetParent(cluster);
-      positions[ id_timecode_t{ simple_block->TrackNum(), simple_block->GlobalTimecode() } ] = simple_block->GetElementPosition();
+      positions.emplace_back(id_timecode_t{ simple_block->TrackNum(), simple_block->GlobalTimecode() }, simple_block->GetElementPosition());
       continue;
     }
 
@@ -167,9 +180,11 @@ cues_c::calculate_block_positions(KaxCluster &cluster)
       continue;
 
     block->SetParent(cluster);
-    positions[ id_timecode_t{ block->TrackNum(), block->GlobalTimecode() } ] = block->GetElementPosition();
+    positions.emplace_back(id_timecode_t{ block->TrackNum(), block->GlobalTimecode() }, block->GetElementPosition());
   }
 
+  sort_id_timecode_values(positions);
+
   return positions;
 }
 
@@ -178,48 +193,73 @@ cues_c::postprocess_cues(KaxCues &cues,
                          KaxCluster &cluster) {
   add(cues);
 
-  if (m_no_cue_duration && m_no_cue_relative_position)
-    return;
+  if (!m_no_cue_relative_position)
+    set_relative_positions(calculate_block_positions(cluster), cluster.GetElementPosition() + cluster.HeadSize());
+
+  set_cue_durations();
+}
+
+// Used if the cluster has been serialized without libmatroska
+// elements. The block positions are relative to the start of the
+// cluster's data.
+void
+cues_c::postprocess_cues(std::vector<cue_point_t> const &points,
+                         id_timecode_values_t &block_positions) {
+  m_points.insert(m_points.end(), points.begin(), points.end());
+
+  if (!m_no_cue_relative_position) {
+    sort_id_timecode_values(block_positions);
+    set_relative_positions(block_positions, 0);
+  }
 
-  auto cluster_data_start_pos = cluster.GetElementPosition() + cluster.HeadSize();
-  auto block_positions        = calculate_block_positions(cluster);
+  set_cue_durations();
+}
 
+void
+cues_c::set_relative_positions(id_timecode_values_t const &block_positions,
+                               uint64_t cluster_data_start_pos) {
   for (auto point = m_points.begin() + m_num_cue_points_postprocessed, end = m_points.end(); point != end; ++point) {
-    // Set CueRelativePosition for all cues.
-    if (!m_no_cue_relative_position) {
-      auto position_itr      = block_positions.find({ point->track_num, point->timecode });
-      auto relative_position = block_positions.end() != position_itr ? std::max(position_itr->second, cluster_data_start_pos) - cluster_data_start_pos : 0ull;
+    auto position_itr      = find_id_timecode_value(block_positions, { point->track_num, point->timecode });
+    auto relative_position = block_positions.end() != position_itr ? std::max(position_itr->second, cluster_data_start_pos) - cluster_data_start_pos : 0ull;
 
-      assert(relative_position <= static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
+    assert(relative_position <= static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
 
-      point->relative_position = relative_position;
+    point->relative_position = relative_position;
 
-      mxdebug_if(m_debug_cue_relative_position,
-                 boost::format("cue_relative_position: looking for <%1%:%2%>: cluster_data_start_pos %3% position %4%\n")
-                 % point->track_num % point->timecode % cluster_data_start_pos % relative_position);
-    }
+    mxdebug_if(m_debug_cue_relative_position,
+               boost::format("cue_relative_position: looking for <%1%:%2%>: cluster_data_start_pos %3% position %4%\n")
+               % point->track_num % point->timecode % cluster_data_start_pos % relative_position);
+  }
+}
 
-    // Set CueDuration if the packetizer wants them.
-    if (m_no_cue_duration)
-      continue;
+void
+cues_c::set_cue_durations() {
+  if (m_no_cue_duration) {
+    m_num_cue_points_postprocessed = m_points.size();
+    return;
+  }
+
+  sort_id_timecode_values(m_id_timecode_durations);
 
-    auto duration_itr = m_id_timecode_duration_map.find({ point->track_num, point->timecode });
+  for (auto point = m_points.begin() + m_num_cue_points_postprocessed, end = m_points.end(); point != end; ++point) {
+    // Set CueDuration if the packetizer wants them.
+    auto duration_itr = find_id_timecode_value(m_id_timecode_durations, { point->track_num, point->timecode });
     auto ptzr         = g_packetizers_by_track_num[point->track_num];
 
     if (!ptzr || !ptzr->wants_cue_duration())
       continue;
 
-    if (m_id_timecode_duration_map.end() != duration_itr)
+    if (m_id_timecode_durations.end() != duration_itr)
       point->duration = duration_itr->second;
 
     mxdebug_if(m_debug_cue_duration,
                boost::format("cue_duration: looking for <%1%:%2%>: %3%\n")
-               % point->track_num % point->timecode % (duration_itr == m_id_timecode_duration_map.end() ? static_cast<int64_t>(-1) : duration_itr->second));
+               % point->track_num % point->timecode % (duration_itr == m_id_timecode_durations.end() ? static_cast<int64_t>(-1) : duration_itr->second));
   }
 
   m_num_cue_points_postprocessed = m_points.size();
 
-  m_id_timecode_duration_map.clear();
+  m_id_timecode_durations.clear();
 }
 
 uint64_t
@@ -241,14 +281,13 @@ uint64_t
 cues_c::calculate_point_size(cue_point_t const &point)
   const {
   uint64_t point_size = EBML_ID_LENGTH(EBML_ID(KaxCuePoint))           + 1
-                      + EBML_ID_LENGTH(EBML_ID(KaxCuePoint))           + 1 + calculate_bytes_for_uint(point.timecode / g_timecode_scale)
+                      + EBML_ID_LENGTH(EBML_ID(KaxCueTime))            + 1 + calculate_bytes_for_uint(point.timecode / g_timecode_scale)
                       + EBML_ID_LENGTH(EBML_ID(KaxCueTrackPositions))  + 1
                       + EBML_ID_LENGTH(EBML_ID(KaxCueTrack))           + 1 + calculate_bytes_for_uint(point.track_num)
                       + EBML_ID_LENGTH(EBML_ID(KaxCueClusterPosition)) + 1 + calculate_bytes_for_uint(point.cluster_position);
 
-  auto codec_state_position = m_codec_state_position_map.find({ point.track_num, point.timecode });
-  if (codec_state_position != m_codec_state_position_map.end())
-    point_size += EBML_ID_LENGTH(EBML_ID(KaxCueCodecState)) + 1 + calculate_bytes_for_uint(codec_state_position->second);
+  if (point.codec_state_position)
+    point_size += EBML_ID_LENGTH(EBML_ID(KaxCueCodecState)) + 1 + calculate_bytes_for_uint(point.codec_state_position);
 
   if (point.relative_position)
     point_size += EBML_ID_LENGTH(EBML_ID(KaxCueRelativePosition)) + 1 + calculate_bytes_for_uint(point.relative_position);
@@ -259,6 +298,65 @@ cues_c::calculate_point_size(cue_point_t const &point)
   return point_size;
 }
 
+static unsigned char *
+put_element_head(unsigned char *buffer,
+                 EbmlId const &id,
+                 uint64_t content_size) {
+  assert(content_size < 127);
+
+  id.Fill(buffer);
+  buffer    += EBML_ID_LENGTH(id);
+  *buffer++  = 0x80 | content_size;
+
+  return buffer;
+}
+
+static unsigned char *
+put_uint_element(unsigned char *buffer,
+                 EbmlId const &id,
+                 uint64_t value,
+                 uint64_t num_bytes) {
+  buffer = put_element_head(buffer, id, num_bytes);
+
+  for (auto idx = num_bytes; 0 < idx; --idx)
+    *buffer++ = value >> ((idx - 1) * 8);
+
+  return buffer;
+}
+
+// Serializes a cue point the same way libebml would render a
+// KaxCuePoint: all sizes are coded in a single byte, and the result is
+// exactly calculate_point_size() bytes long.
+unsigned char *
+cues_c::render_point(unsigned char *buffer,
+                     cue_point_t const &point)
+  const {
+  auto cue_time       = point.timecode / g_timecode_scale;
+  auto cue_time_bytes = calculate_bytes_for_uint(cue_time);
+  auto content_size   = calculate_point_size(point) - EBML_ID_LENGTH(EBML_ID(KaxCuePoint)) - 1;
+  auto positions_size = content_size - (EBML_ID_LENGTH(EBML_ID(KaxCueTime)) + 1 + cue_time_bytes) - (EBML_ID_LENGTH(EBML_ID(KaxCueTrackPositions)) + 1);
+
+  buffer = put_element_head(buffer, EBML_ID(KaxCuePoint), content_size);
+  buffer = put_uint_element(buffer, EBML_ID(KaxCueTime),  cue_time, cue_time_bytes);
+
+  buffer = put_element_head(buffer, EBML_ID(KaxCueTrackPositions), positions_size);
+  buffer = put_uint_element(buffer, EBML_ID(KaxCueTrack),           point.track_num,        calculate_bytes_for_uint(point.track_num));
+  buffer = put_uint_element(buffer, EBML_ID(KaxCueClusterPosition), point.cluster_position, calculate_bytes_for_uint(point.cluster_position));
+
+  if (point.codec_state_position)
+    buffer = put_uint_element(buffer, EBML_ID(KaxCueCodecState), point.codec_state_position, calculate_bytes_for_uint(point.codec_state_position));
+
+  if (point.relative_position)
+    buffer = put_uint_element(buffer, EBML_ID(KaxCueRelativePosition), point.relative_position, calculate_bytes_for_uint(point.relative_position));
+
+  if (point.duration) {
+    auto duration = RND_TIMECODE_SCALE(point.duration) / g_timecode_scale;
+    buffer        = put_uint_element(buffer, EBML_ID(KaxCueDuration), duration, calculate_bytes_for_uint(duration));
+  }
+
+  return buffer;
+}
+
 cues_c &
 cues_c::get() {
   if (!s_cues)
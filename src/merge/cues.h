@@ -24,8 +24,13 @@
 
 typedef std::pair<uint64_t, uint64_t> id_timecode_t;
 
+// Flat list of values per (track number, timecode). Entries are
+// appended and sorted once before they're looked up; this uses far
+// less memory than a std::map for millions of entries.
+typedef std::vector<std::pair<id_timecode_t, uint64_t> > id_timecode_values_t;
+
 struct cue_point_t {
-  uint64_t timecode, duration, cluster_position;
+  uint64_t timecode, duration, cluster_position, codec_state_position;
   uint32_t track_num, relative_position;
 };
 
@@ -35,7 +40,7 @@ typedef std::shared_ptr<cues_c> cues_cptr;
 class cues_c {
 protected:
   std::vector<cue_point_t> m_points;
-  std::map<id_timecode_t, uint64_t> m_id_timecode_duration_map, m_codec_state_position_map;
+  id_timecode_values_t m_id_timecode_durations;
 
   size_t m_num_cue_points_postprocessed;
   bool m_no_cue_duration, m_no_cue_relative_position, m_debug_cue_duration, m_debug_cue_relative_position;
@@ -50,6 +55,7 @@ public:
   void add(KaxCuePoint &point);
   void write(mm_io_c &out, KaxSeekHead &seek_head);
   void postprocess_cues(KaxCues &cues, KaxCluster &cluster);
+  void postprocess_cues(std::vector<cue_point_t> const &points, id_timecode_values_t &block_positions);
   void set_duration_for_id_timecode(uint64_t id, uint64_t timecode, uint64_t duration);
 
 public:
@@ -57,10 +63,13 @@ public:
 
 protected:
   void sort();
-  std::map<id_timecode_t, uint64_t> calculate_block_positions(KaxCluster &cluster) const;
+  void set_relative_positions(id_timecode_values_t const &block_positions, uint64_t cluster_data_start_pos);
+  void set_cue_durations();
+  id_timecode_values_t calculate_block_positions(KaxCluster &cluster) const;
   uint64_t calculate_total_size() const;
   uint64_t calculate_point_size(cue_point_t const &point) const;
   uint64_t calculate_bytes_for_uint(uint64_t value) const;
+  unsigned char *render_point(unsigned char *buffer, cue_point_t const &point) const;
 };
 
 #endif  // MTX_MERGE_CUES_H
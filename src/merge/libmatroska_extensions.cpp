@@ -16,6 +16,7 @@
 
 #include <cassert>
 
+#include "common/mm_io_x.h"
 #include "merge/libmatroska_extensions.h"
 
 kax_reference_block_c::kax_reference_block_c():
@@ -156,3 +157,66 @@ kax_cluster_c::delete_non_blocks() {
 
   RemoveAll();
 }
+
+kax_file_data_c::kax_file_data_c(memory_cptr const &data)
+  : KaxFileData()
+  , m_data(data)
+  , m_offset(0)
+{
+  set_size(m_data->get_size());
+}
+
+kax_file_data_c::kax_file_data_c(std::string const &file_name,
+                                 uint64_t offset,
+                                 uint64_t size)
+  : KaxFileData()
+  , m_file_name(file_name)
+  , m_offset(offset)
+{
+  set_size(size);
+}
+
+void
+kax_file_data_c::set_size(uint64_t size) {
+#if LIBEBML_VERSION < 0x000800
+  Size        = size;
+  bValueIsSet = true;
+#else
+  SetSize_(size);
+  SetValueIsSet();
+#endif
+}
+
+filepos_t
+kax_file_data_c::RenderData(IOCallback &output,
+                            bool,
+                            bool) {
+  uint64_t size = GetSize();
+
+  if (m_data) {
+    output.writeFully(m_data->get_buffer(), size);
+    return size;
+  }
+
+  try {
+    mm_file_io_c in{m_file_name};
+    in.setFilePointer(m_offset);
+
+    auto buffer         = memory_c::alloc(std::min<uint64_t>(size, 1024 * 1024));
+    uint64_t remaining  = size;
+
+    while (remaining) {
+      auto to_copy = std::min<uint64_t>(remaining, buffer->get_size());
+      if (in.read(buffer->get_buffer(), to_copy) != to_copy)
+        throw mtx::mm_io::end_of_file_x{};
+
+      output.writeFully(buffer->get_buffer(), to_copy);
+      remaining -= to_copy;
+    }
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The attachment data could not be read from '%1%': %2%\n")) % m_file_name % ex);
+  }
+
+  return size;
+}
@@ -18,6 +18,7 @@
 #include "common/common_pch.h"
 
 #include <ebml/EbmlVersion.h>
+#include <matroska/KaxAttached.h>
 #include <matroska/KaxBlock.h>
 #include <matroska/KaxBlockData.h>
 #include <matroska/KaxCluster.h>
@@ -44,6 +45,9 @@ public:
   void set_max_timecode(int64_t max_timecode) {
     MaxTimecode = max_timecode;
   }
+  void set_element_position(uint64_t position) {
+    ElementPosition = position;
+  }
 };
 
 class kax_reference_block_c: public KaxReferenceBlock {
@@ -91,9 +95,27 @@ public:
   {
   }
 
-  filepos_t Render(IOCallback &output) {
-    return EbmlElement::Render(output, true, false, true);
+  void set_element_position(uint64_t position) {
+    ElementPosition = position;
   }
 };
 
+class kax_file_data_c: public KaxFileData {
+protected:
+  memory_cptr m_data;
+  std::string m_file_name;
+  uint64_t m_offset;
+
+public:
+  // The attachment's data is only copied from memory or from the
+  // source file when it is rendered.
+  kax_file_data_c(memory_cptr const &data);
+  kax_file_data_c(std::string const &file_name, uint64_t offset, uint64_t size);
+
+  virtual filepos_t RenderData(IOCallback &output, bool bForceRender, bool bSaveDefault = false);
+
+protected:
+  void set_size(uint64_t size);
+};
+
 #endif // MTX_LIBMATROSKA_EXTENSIONS
@@ -76,7 +76,8 @@ set_usage() {
   usage_text += Y(" Global options:\n");
   usage_text += Y("  -v, --verbose            verbose status\n");
   usage_text += Y("  -q, --quiet              suppress status output\n");
-  usage_text += Y("  -o, --output out         Write to the file 'out'.\n");
+  usage_text += Y("  -o, --output out         Write to the file 'out'. Use '-' for writing to\n"
+                  "                           the standard output.\n");
   usage_text += Y("  -w, --webm               Create WebM compliant file.\n");
   usage_text += Y("  --title <title>          Title for this output file.\n");
   usage_text += Y("  --global-tags <file>     Read global tags from a XML file.\n");
@@ -109,6 +110,8 @@ set_usage() {
   usage_text += Y("  --clusters-in-meta-seek  Write meta seek data for clusters.\n");
   usage_text += Y("  --disable-lacing         Do not Use lacing.\n");
   usage_text += Y("  --enable-durations       Enable block durations for all blocks.\n");
+  usage_text += Y("  --sequential-output      Only ever append to the output file; never seek\n"
+                  "                           back in order to update earlier elements.\n");
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
   usage_text +=   "\n";
   usage_text += Y(" File splitting, linking, appending and concatenating (more global options):\n");
@@ -192,6 +195,10 @@ set_usage() {
   usage_text += Y("  -T, --no-track-tags      Don't copy tags for tracks from the source file.\n");
   usage_text += Y("  --no-global-tags         Don't keep global tags from the source file.\n");
   usage_text += Y("  --no-chapters            Don't keep chapters from the source file.\n");
+  usage_text += Y("  --follow <timeout>       The source file is still being written to.\n"
+                  "                           Wait for more data instead of stopping at its\n"
+                  "                           end until it hasn't grown for 'timeout'\n"
+                  "                           seconds (or 'ms' if postfixed with 'ms').\n");
   usage_text += Y("  -y, --sync <TID:d[,o[/p]]>\n"
                   "                           Synchronize, adjust the track's timecodes with\n"
                   "                           the id TID by 'd' ms.\n"
@@ -296,50 +303,6 @@ print_capabilities() {
 #endif
 }
 
-int64_t
-create_track_number(generic_reader_c *reader,
-                    int64_t tid) {
-  // Specs say that track numbers should start at 1.
-  static int s_track_number = 1;
-
-  bool found   = false;
-  int file_num = -1;
-  size_t i;
-  for (i = 0; i < g_files.size(); i++)
-    if (g_files[i].reader == reader) {
-      found = true;
-      file_num = i;
-      break;
-    }
-
-  if (!found)
-    mxerror(boost::format(Y("create_track_number: file_num not found. %1%\n")) % BUGMSG);
-
-  int64_t tnum = -1;
-  found        = false;
-  for (i = 0; i < g_track_order.size(); i++)
-    if ((g_track_order[i].file_id == file_num) &&
-        (g_track_order[i].track_id == tid)) {
-      found = true;
-      tnum = i + 1;
-      break;
-    }
-  if (found) {
-    found = false;
-    for (i = 0; i < g_packetizers.size(); i++)
-      if (g_packetizers[i].packetizer && (g_packetizers[i].packetizer->get_track_num() == tnum)) {
-        tnum = s_track_number;
-        break;
-      }
-  } else
-    tnum = s_track_number;
-
-  if (tnum >= s_track_number)
-    s_track_number = tnum + 1;
-
-  return tnum;
-}
-
 static std::string
 guess_mime_type_and_report(std::string file_name) {
   std::string mime_type = guess_mime_type(file_name, true);
@@ -836,70 +799,6 @@ parse_arg_split_frames(std::string const &arg) {
   }
 }
 
-void
-parse_arg_split_chapters(std::string const &arg) {
-  std::string s = arg;
-
-  if (balg::istarts_with(s, "chapters:"))
-    s.erase(0, 9);
-
-  bool use_all = s == "all";
-  std::unordered_map<unsigned int, bool> chapter_numbers;
-
-  if (!use_all) {
-    std::vector<std::string> numbers = split(s, ",");
-    for (auto &number_str : numbers) {
-      auto number = 0u;
-      if (!parse_number(number_str, number) || !number)
-        mxerror(boost::format(Y("Invalid chapter number '%1%' for '--split' in '--split %2%': %3%\n")) % number_str % arg % Y("Not a valid number or not positive."));
-      chapter_numbers[number] = true;
-    }
-
-    if (chapter_numbers.empty())
-      mxerror(boost::format(Y("No chapter numbers listed after '--split %1%'.\n")) % arg);
-  }
-
-  if (!g_kax_chapters)
-    mxerror(boost::format(Y("No chapters in source files or chapter files found to split by.\n")));
-
-  std::vector<split_point_c> new_split_points;
-  auto current_number = 0u;
-  for (auto element : *g_kax_chapters) {
-    auto edition = dynamic_cast<KaxEditionEntry *>(element);
-    if (!edition)
-      continue;
-
-    for (auto sub_element : *edition) {
-      auto atom = dynamic_cast<KaxChapterAtom *>(sub_element);
-      if (!atom)
-        continue;
-
-
-      ++current_number;
-      if (!use_all && !chapter_numbers[current_number])
-        continue;
-
-      int64_t split_after = FindChildValue<KaxChapterTimeStart, uint64_t>(atom, 0);
-      if (split_after)
-        new_split_points.push_back(split_point_c{split_after, split_point_c::timecode, true});
-    }
-  }
-
-  if (!current_number)
-    mxerror(boost::format(Y("No chapters in source files or chapter files found to split by.\n")));
-
-  for (auto &number : chapter_numbers)
-    if (number.first > current_number)
-      mxerror(boost::format(Y("Invalid chapter number '%1%' for '--split' in '--split %2%': %3%\n"))
-              % number.first % arg
-              % (boost::format(Y("Only %1% chapters found in source files & chapter files.")) % current_number));
-
-  brng::sort(new_split_points);
-
-  for (auto &split_point : new_split_points)
-    g_cluster_helper->add_split_point(split_point);
-}
-
 static void
 parse_arg_split_parts(const std::string &arg,
                       bool frames_fields) {
@@ -1558,8 +1457,9 @@ parse_arg_attach_file(attachment_t &attachment,
     if (0 == io->get_size())
       mxerror(boost::format(Y("The size of attachment '%1%' is 0.\n")) % attachment.name);
 
-    attachment.data = memory_c::alloc(io->get_size());
-    io->read(attachment.data->get_buffer(), attachment.data->get_size());
+    // The content is only read when the output file is written.
+    attachment.source_file_name = attachment.name;
+    attachment.source_size      = io->get_size();
 
   } catch (...) {
     mxerror(boost::format(Y("The attachment '%1%' could not be read.\n")) % attachment.name);
@@ -1852,8 +1752,6 @@ parse_args(std::vector<std::string> args) {
 
   }
 
-  mxinfo(boost::format("%1%\n") % get_version_info("mkvmerge", vif_full));
-
   // Now parse options that are needed right at the beginning.
   mxforeach(sit, args) {
     const std::string &this_arg = *sit;
@@ -1874,11 +1772,22 @@ parse_args(std::vector<std::string> args) {
       set_output_compatibility(OC_WEBM);
   }
 
+  // Writing the output file to the standard output requires all
+  // messages to go elsewhere.
+  if ((g_outfile == "-") && !stdio_redirected())
+    redirect_stdio(mm_io_cptr{ new mm_stream_write_io_c{stderr, "<stderr>"} });
+
+  mxinfo(boost::format("%1%\n") % get_version_info("mkvmerge", vif_full));
+
   if (g_outfile.empty()) {
     mxinfo(Y("Error: no output file name was given.\n\n"));
     usage(2);
   }
 
+  // The standard output cannot seek.
+  if (g_outfile == "-")
+    g_sequential_output = true;
+
   if (!outputting_webm() && is_webm_file_name(g_outfile)) {
     set_output_compatibility(OC_WEBM);
     mxinfo(boost::format(Y("Automatically enabling WebM compliance mode due to output file name extension.\n")));
@@ -1988,6 +1897,9 @@ parse_args(std::vector<std::string> args) {
     else if (this_arg == "--enable-durations")
       g_use_durations = true;
 
+    else if (this_arg == "--sequential-output")
+      g_sequential_output = true;
+
     else if (this_arg == "--attachment-description") {
       if (no_next_arg)
         mxerror(Y("'--attachment-description' lacks the description.\n"));
@@ -2080,7 +1992,23 @@ parse_args(std::vector<std::string> args) {
     } else if (this_arg == "--no-chapters")
       ti->m_no_chapters = true;
 
-    else if ((this_arg == "-M") || (this_arg == "--no-attachments"))
+    else if (this_arg == "--follow") {
+      if (no_next_arg)
+        mxerror(Y("'--follow' lacks the idle timeout.\n"));
+
+      // Frame rates are valid units for parse_number_with_unit() but not
+      // for a timeout.
+      if (!boost::regex_match(next_arg, boost::regex("\\d+\\.?\\d*(s|ms|us|ns)?", boost::regex::perl | boost::regex::icase)))
+        mxerror(boost::format(Y("'%1%' is not a valid %2% in '%3% %4%'.\n")) % next_arg % "idle timeout" % this_arg % next_arg);
+
+      ti->m_follow_timeout = parse_number_with_unit(next_arg, "idle timeout", this_arg);
+      if (0 >= ti->m_follow_timeout)
+        mxerror(boost::format(Y("'%1%' is not a valid %2% in '%3% %4%'.\n")) % next_arg % "idle timeout" % this_arg % next_arg);
+
+      g_flush_after_each_cluster = true;
+      sit++;
+
+    } else if ((this_arg == "-M") || (this_arg == "--no-attachments"))
       ti->m_attach_mode_list.set_none();
 
     else if ((this_arg == "-m") || (this_arg == "--attachments")) {
@@ -2348,6 +2276,9 @@ parse_args(std::vector<std::string> args) {
   if (!g_cluster_helper->splitting() && !g_no_linking)
     mxwarn(Y("'--link' is only useful in combination with '--split'.\n"));
 
+  if ((g_outfile == "-") && g_cluster_helper->split_mode_produces_many_files())
+    mxerror(Y("Splitting into several files is not possible when writing to the standard output.\n"));
+
   delete ti;
 
   if (!inputs_found && g_files.empty())
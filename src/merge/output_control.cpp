@@ -69,6 +69,7 @@
 #include "common/mm_read_buffer_io.h"
 #include "common/mm_write_buffer_io.h"
 #include "common/strings/formatting.h"
+#include "common/strings/parsing.h"
 #include "common/tags/tags.h"
 #include "common/translation.h"
 #include "common/unique_numbers.h"
@@ -111,6 +112,7 @@
 #include "input/r_wavpack.h"
 #include "merge/cluster_helper.h"
 #include "merge/cues.h"
+#include "merge/libmatroska_extensions.h"
 #include "merge/mkvmerge.h"
 #include "merge/output_control.h"
 #include "merge/debugging.h"
@@ -153,6 +155,8 @@ bool g_write_meta_seek_for_clusters         = false;
 bool g_no_lacing                            = false;
 bool g_no_linking                           = true;
 bool g_use_durations                        = false;
+bool g_sequential_output                    = false;
+bool g_flush_after_each_cluster             = false;
 
 double g_timecode_scale                     = TIMECODE_SCALE;
 timecode_scale_mode_e g_timecode_scale_mode = TIMECODE_SCALE_MODE_NORMAL;
@@ -220,6 +224,11 @@ static EbmlVoid *s_void_after_track_headers = nullptr;
 
 static mm_io_cptr s_out;
 
+// Sequential output mode: the file the headers buffered in s_out will
+// be written to, and whether or not that has happened already.
+static mm_io_cptr s_sequential_out;
+static bool s_output_is_append_only         = false;
+
 static bitvalue_c s_seguid_prev(128), s_seguid_current(128), s_seguid_next(128);
 
 static int s_display_files_done           = 0;
@@ -280,6 +289,8 @@ sighandler(int /* signum */) {
            "Ctrl+C). Trying to sanitize the file. If mkvmerge hangs during "
            "this process you'll have to kill it manually.\n"));
 
+  write_pending_headers();
+
   mxinfo(Y("The file is being fixed, part 1/4..."));
   // Render the cues.
   if (g_write_cues && g_cue_writing_requested)
@@ -289,23 +300,27 @@ sighandler(int /* signum */) {
   mxinfo(Y("The file is being fixed, part 2/4..."));
   // Now re-render the kax_duration and fill in the biggest timecode
   // as the file's duration.
-  s_out->save_pos(s_kax_duration->GetElementPosition());
-  s_kax_duration->SetValue(calculate_file_duration());
-  s_kax_duration->Render(*s_out);
-  s_out->restore_pos();
+  if (s_kax_duration) {
+    s_out->save_pos(s_kax_duration->GetElementPosition());
+    s_kax_duration->SetValue(calculate_file_duration());
+    s_kax_duration->Render(*s_out);
+    s_out->restore_pos();
+  }
   mxinfo(Y(" done\n"));
 
   mxinfo(Y("The file is being fixed, part 3/4..."));
   if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
     g_kax_sh_main->UpdateSize();
-    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+    if (s_output_is_append_only)
+      g_kax_sh_main->Render(*s_out);
+    else if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. %1%\n")) % BUGMSG);
   }
   mxinfo(Y(" done\n"));
 
   mxinfo(Y("The file is being fixed, part 4/4..."));
   // Set the correct size for the segment.
-  if (g_kax_segment->ForceSize(s_out->getFilePointer() - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+  if (!s_output_is_append_only && g_kax_segment->ForceSize(s_out->getFilePointer() - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
     g_kax_segment->OverwriteHead(*s_out);
 
   mxinfo(Y(" done\n"));
@@ -585,9 +600,9 @@ add_attachment(attachment_t attachment) {
       if ((   (ex_attachment.id == attachment.id)
            && !hack_engaged(ENGAGE_NO_VARIABLE_DATA))
           ||
-          (   (ex_attachment.name             == attachment.name)
-           && (ex_attachment.description      == attachment.description)
-           && (ex_attachment.data->get_size() == attachment.data->get_size())))
+          (   (ex_attachment.name        == attachment.name)
+           && (ex_attachment.description == attachment.description)
+           && (ex_attachment.get_size()  == attachment.get_size())))
         return attachment.id;
 
     add_unique_number(attachment.id, UNIQUE_ATTACHMENT_IDS);
@@ -601,6 +616,50 @@ add_attachment(attachment_t attachment) {
   return attachment.id;
 }
 
+int64_t
+create_track_number(generic_reader_c *reader,
+                    int64_t tid) {
+  // Specs say that track numbers should start at 1.
+  static int s_track_number = 1;
+
+  bool found   = false;
+  int file_num = -1;
+  size_t i;
+  for (i = 0; i < g_files.size(); i++)
+    if (g_files[i].reader == reader) {
+      found = true;
+      file_num = i;
+      break;
+    }
+
+  if (!found)
+    mxerror(boost::format(Y("create_track_number: file_num not found. %1%\n")) % BUGMSG);
+
+  int64_t tnum = -1;
+  found        = false;
+  for (i = 0; i < g_track_order.size(); i++)
+    if ((g_track_order[i].file_id == file_num) &&
+        (g_track_order[i].track_id == tid)) {
+      found = true;
+      tnum = i + 1;
+      break;
+    }
+  if (found) {
+    found = false;
+    for (i = 0; i < g_packetizers.size(); i++)
+      if (g_packetizers[i].packetizer && (g_packetizers[i].packetizer->get_track_num() == tnum)) {
+        tnum = s_track_number;
+        break;
+      }
+  } else
+    tnum = s_track_number;
+
+  if (tnum >= s_track_number)
+    s_track_number = tnum + 1;
+
+  return tnum;
+}
+
 /** \brief Add a packetizer to the list of packetizers
 */
 void
@@ -680,8 +739,25 @@ render_ebml_head(mm_io_c *out) {
   s_head->Render(*out, true);
 }
 
+static void
+warn_about_headers_changed_after_writing() {
+  static bool s_warning_issued = false;
+
+  if (s_warning_issued)
+    return;
+
+  mxwarn(Y("The headers have to be changed after they have already been written in sequential output mode. "
+           "The changes cannot be stored in the file, and it may not be played back correctly.\n"));
+  s_warning_issued = true;
+}
+
 void
 rerender_ebml_head() {
+  if (s_output_is_append_only) {
+    warn_about_headers_changed_after_writing();
+    return;
+  }
+
   mm_io_c *out = g_cluster_helper->get_output();
   out->save_pos(s_head->GetElementPosition());
   render_ebml_head(out);
@@ -701,13 +777,20 @@ render_headers(mm_io_c *out) {
 
     s_kax_infos = &GetChild<KaxInfo>(*g_kax_segment);
 
-    if (!g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode))
-      s_kax_duration = new KaxMyDuration(EbmlFloat::FLOAT_64);
-    else
-      s_kax_duration = new KaxMyDuration(EbmlFloat::FLOAT_32);
+    // The duration is only known at the very end. It cannot be
+    // written at all if the file must not be modified afterwards.
+    if (g_sequential_output)
+      s_kax_duration = nullptr;
 
-    s_kax_duration->SetValue(0.0);
-    s_kax_infos->PushElement(*s_kax_duration);
+    else {
+      if (!g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode))
+        s_kax_duration = new KaxMyDuration(EbmlFloat::FLOAT_64);
+      else
+        s_kax_duration = new KaxMyDuration(EbmlFloat::FLOAT_32);
+
+      s_kax_duration->SetValue(0.0);
+      s_kax_infos->PushElement(*s_kax_duration);
+    }
 
     if (!hack_engaged(ENGAGE_NO_VARIABLE_DATA)) {
       GetChild<KaxMuxingApp >(s_kax_infos).SetValue(cstrutf8_to_UTFstring(std::string("libebml v") + EbmlCodeVersion + std::string(" + libmatroska v") + KaxCodeVersion));
@@ -807,6 +890,16 @@ render_headers(mm_io_c *out) {
 
     g_kax_segment->WriteHead(*out, 8);
 
+    // The same goes for the segment's size which is marked as unknown
+    // instead.
+    if (g_sequential_output) {
+      static const unsigned char s_unknown_size[8] = { 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+      out->save_pos(g_kax_segment->GetElementPosition() + EBML_ID_LENGTH(EBML_ID(KaxSegment)));
+      out->write(s_unknown_size, 8);
+      out->restore_pos();
+    }
+
     // Reserve some space for the meta seek stuff.
     g_kax_sh_main = new KaxSeekHead();
     s_kax_sh_void = new EbmlVoid();
@@ -923,6 +1016,11 @@ render_void(int64_t new_size) {
 */
 void
 rerender_track_headers() {
+  if (s_output_is_append_only) {
+    warn_about_headers_changed_after_writing();
+    return;
+  }
+
   g_kax_tracks->UpdateSize(false);
 
   int64_t new_void_size       = s_void_after_track_headers->GetElementPosition() + s_void_after_track_headers->ElementSize() - g_kax_tracks->GetElementPosition() - g_kax_tracks->ElementSize();
@@ -1022,7 +1120,8 @@ render_attachments(IOCallback *out) {
       GetChild<KaxFileName>(kax_a).SetValue(cstrutf8_to_UTFstring(name));
       GetChild<KaxFileUID >(kax_a).SetValue(attch.id);
 
-      GetChild<KaxFileData>(*kax_a).CopyBuffer(attch.data->get_buffer(), attch.data->get_size());
+      auto file_data = attch.data ? new kax_file_data_c{attch.data} : new kax_file_data_c{attch.source_file_name, attch.source_offset, attch.source_size};
+      kax_a->PushElement(*file_data);
     }
   }
 
@@ -1276,6 +1375,70 @@ calc_max_chapter_size() {
   }
 }
 
+void
+parse_arg_split_chapters(std::string const &arg) {
+  std::string s = arg;
+
+  if (balg::istarts_with(s, "chapters:"))
+    s.erase(0, 9);
+
+  bool use_all = s == "all";
+  std::unordered_map<unsigned int, bool> chapter_numbers;
+
+  if (!use_all) {
+    std::vector<std::string> numbers = split(s, ",");
+    for (auto &number_str : numbers) {
+      auto number = 0u;
+      if (!parse_number(number_str, number) || !number)
+        mxerror(boost::format(Y("Invalid chapter number '%1%' for '--split' in '--split %2%': %3%\n")) % number_str % arg % Y("Not a valid number or not positive."));
+      chapter_numbers[number] = true;
+    }
+
+    if (chapter_numbers.empty())
+      mxerror(boost::format(Y("No chapter numbers listed after '--split %1%'.\n")) % arg);
+  }
+
+  if (!g_kax_chapters)
+    mxerror(boost::format(Y("No chapters in source files or chapter files found to split by.\n")));
+
+  std::vector<split_point_c> new_split_points;
+  auto current_number = 0u;
+  for (auto element : *g_kax_chapters) {
+    auto edition = dynamic_cast<KaxEditionEntry *>(element);
+    if (!edition)
+      continue;
+
+    for (auto sub_element : *edition) {
+      auto atom = dynamic_cast<KaxChapterAtom *>(sub_element);
+      if (!atom)
+        continue;
+
+
+      ++current_number;
+      if (!use_all && !chapter_numbers[current_number])
+        continue;
+
+      int64_t split_after = FindChildValue<KaxChapterTimeStart, uint64_t>(atom, 0);
+      if (split_after)
+        new_split_points.push_back(split_point_c{split_after, split_point_c::timecode, true});
+    }
+  }
+
+  if (!current_number)
+    mxerror(boost::format(Y("No chapters in source files or chapter files found to split by.\n")));
+
+  for (auto &number : chapter_numbers)
+    if (number.first > current_number)
+      mxerror(boost::format(Y("Invalid chapter number '%1%' for '--split' in '--split %2%': %3%\n"))
+              % number.first % arg
+              % (boost::format(Y("Only %1% chapters found in source files & chapter files.")) % current_number));
+
+  brng::sort(new_split_points);
+
+  for (auto &split_point : new_split_points)
+    g_cluster_helper->add_split_point(split_point);
+}
+
 /** \brief Creates the file readers
 
    For each file the appropriate file reader class is instantiated.
@@ -1288,6 +1451,10 @@ create_readers() {
   for (auto &file : g_files) {
     try {
       mm_io_cptr input_file = open_input_file(file);
+      // The timeout is given in ns but waited for in ms. Round up so
+      // that sub-millisecond values don't turn following off.
+      if (file.ti->m_follow_timeout)
+        input_file->enable_following((file.ti->m_follow_timeout + 999999) / 1000000);
 
       switch (file.type) {
         case FILE_TYPE_AAC:
@@ -1432,9 +1599,9 @@ create_readers() {
 
     // Calculate the size of all attachments for split control.
     for (auto &att : g_attachments) {
-      g_attachment_sizes_first += att.data->get_size();
+      g_attachment_sizes_first += att.get_size();
       if (att.to_all_files)
-        g_attachment_sizes_others += att.data->get_size();
+        g_attachment_sizes_others += att.get_size();
     }
 
     calc_max_chapter_size();
@@ -1551,7 +1718,8 @@ add_tags_from_cue_chapters() {
  */
 static void
 render_chapter_void_placeholder() {
-  if (0 >= s_max_chapter_size)
+  // Chapters are rendered at the end in sequential output mode.
+  if ((0 >= s_max_chapter_size) || g_sequential_output)
     return;
 
   if (outputting_webm()) {
@@ -1616,13 +1784,28 @@ create_next_output_file() {
 
   // Open the output file.
   try {
-    s_out = !g_cluster_helper->discarding() ? mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024) : mm_io_cptr{ new mm_null_io_c{this_outfile} };
+    s_out = g_cluster_helper->discarding() ? mm_io_cptr{ new mm_null_io_c{this_outfile} }
+          : this_outfile == "-"            ? mm_io_cptr{ new mm_write_buffer_io_c{new mm_stream_write_io_c{stdout, this_outfile}, 1024 * 1024} }
+          :                                  mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024);
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % this_outfile % ex);
   }
 
-  if (verbose && !g_cluster_helper->discarding())
-    mxinfo(boost::format(Y("The file '%1%' has been opened for writing.\n")) % this_outfile);
+  // In sequential output mode everything up to the first cluster is
+  // assembled in memory first, see write_pending_headers().
+  s_output_is_append_only = false;
+
+  if (g_sequential_output && !g_cluster_helper->discarding()) {
+    s_sequential_out = s_out;
+    s_out            = mm_io_cptr{ new mm_mem_io_c{nullptr, 0, 64 * 1024} };
+  }
+
+  if (verbose && !g_cluster_helper->discarding()) {
+    if (this_outfile == "-")
+      mxinfo(Y("The output is written to the standard output.\n"));
+    else
+      mxinfo(boost::format(Y("The file '%1%' has been opened for writing.\n")) % this_outfile);
+  }
 
   g_cluster_helper->set_output(s_out.get());
 
@@ -1674,6 +1857,48 @@ add_chapters_for_current_part() {
   sort_ebml_master(s_chapters_in_this_file.get());
 }
 
+/** \brief Writes the headers assembled in memory in sequential output mode
+
+   In sequential output mode the headers are kept in memory until the
+   first cluster is about to be written so that the packetizers can
+   still change them. After that the meta seek element in front is
+   filled with the elements written so far, and the headers are written
+   to the file. From then on the file is only appended to; all
+   elements indexed later on go into a second meta seek element at the
+   end of the file.
+*/
+void
+write_pending_headers() {
+  if (!s_sequential_out)
+    return;
+
+  if (s_kax_as) {
+    g_kax_sh_main->IndexThis(*s_kax_as, *g_kax_segment);
+    delete s_kax_as;
+    s_kax_as = nullptr;
+  }
+
+  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+    g_kax_sh_main->UpdateSize();
+    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+      mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
+             % g_kax_sh_main->ElementSize() % BUGMSG);
+  }
+
+  auto headers = static_cast<mm_mem_io_c *>(s_out.get());
+  headers->setFilePointer(0, seek_end);
+  s_sequential_out->write(headers->get_buffer(), headers->getFilePointer());
+
+  s_out = s_sequential_out;
+  s_sequential_out.reset();
+  s_output_is_append_only = true;
+
+  g_cluster_helper->set_output(s_out.get());
+
+  delete g_kax_sh_main;
+  g_kax_sh_main = new KaxSeekHead;
+}
+
 static void
 render_chapters() {
   bool debug = debugging_requested("splitting_chapters");
@@ -1683,6 +1908,12 @@ render_chapters() {
              % !!s_kax_chapters_void     % (s_kax_chapters_void     ? s_kax_chapters_void    ->ElementSize() : 0)
              % !!s_chapters_in_this_file % (s_chapters_in_this_file ? s_chapters_in_this_file->ElementSize() : 0));
 
+  if (g_sequential_output) {
+    if (s_chapters_in_this_file)
+      s_chapters_in_this_file->Render(*s_out, true);
+    return;
+  }
+
   if (!s_kax_chapters_void)
     return;
 
@@ -1693,42 +1924,13 @@ render_chapters() {
   s_kax_chapters_void = nullptr;
 }
 
-/** \brief Finishes and closes the current file
+/** \brief Updates the segment info in front of the file
 
-   Renders the data that is generated during the muxing run. The cues
-   and meta seek information are rendered at the end. If splitting is
-   active the chapters are stripped to those that actually lie in this
-   file and rendered at the front.  The segment duration and the
-   segment size are set to their actual values.
+   Sets the duration to the file's actual duration and handles the
+   'next segment UID' when splitting.
 */
-void
-finish_file(bool last_file,
-            bool create_new_file,
-            bool previously_discarding) {
-  if (g_kax_chapters && !previously_discarding)
-    add_chapters_for_current_part();
-
-  if (!last_file && !create_new_file)
-    return;
-
-  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
-  if (do_output)
-    mxinfo("\n");
-
-  // Render the track headers a second time if the user has requested that.
-  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
-    auto second_tracks = clone(g_kax_tracks);
-    second_tracks->Render(*s_out);
-    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
-  }
-
-  // Render the cues.
-  if (g_write_cues && g_cue_writing_requested) {
-    if (do_output)
-      mxinfo(Y("The cue entries (the index) are being written...\n"));
-    cues_c::get().write(*s_out, *g_kax_sh_main);
-  }
-
+static void
+update_segment_info(bool last_file) {
   // Now re-render the s_kax_duration and fill in the biggest timecode
   // as the file's duration.
   s_out->save_pos(s_kax_duration->GetElementPosition());
@@ -1779,6 +1981,50 @@ finish_file(bool last_file,
     }
   }
   s_out->restore_pos();
+}
+
+/** \brief Finishes and closes the current file
+
+   Renders the data that is generated during the muxing run. The cues
+   and meta seek information are rendered at the end. If splitting is
+   active the chapters are stripped to those that actually lie in this
+   file and rendered at the front.  The segment duration and the
+   segment size are set to their actual values.
+*/
+void
+finish_file(bool last_file,
+            bool create_new_file,
+            bool previously_discarding) {
+  if (g_kax_chapters && !previously_discarding)
+    add_chapters_for_current_part();
+
+  if (!last_file && !create_new_file)
+    return;
+
+  write_pending_headers();
+
+  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
+  if (do_output)
+    mxinfo("\n");
+
+  // Render the track headers a second time if the user has requested that.
+  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
+    auto second_tracks = clone(g_kax_tracks);
+    second_tracks->Render(*s_out);
+    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
+  }
+
+  // Render the cues.
+  if (g_write_cues && g_cue_writing_requested) {
+    if (do_output)
+      mxinfo(Y("The cue entries (the index) are being written...\n"));
+    cues_c::get().write(*s_out, *g_kax_sh_main);
+  }
+
+  // Neither the duration nor the segment info can be changed in
+  // sequential output mode.
+  if (!g_sequential_output)
+    update_segment_info(last_file);
 
   // Render the segment info a second time if the user has requested that.
   if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
@@ -1829,16 +2075,21 @@ finish_file(bool last_file,
     s_kax_as = nullptr;
   }
 
+  // In sequential output mode the meta seek element in front has
+  // already been written. The remaining entries go into a second one
+  // at the end, and the segment's size stays unknown.
   if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
     g_kax_sh_main->UpdateSize();
-    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+    if (s_output_is_append_only)
+      g_kax_sh_main->Render(*s_out);
+    else if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
              % g_kax_sh_main->ElementSize() % BUGMSG);
   }
 
   // Set the correct size for the segment.
   int64_t final_file_size = s_out->getFilePointer();
-  if (g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+  if (!s_output_is_append_only && g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
     g_kax_segment->OverwriteHead(*s_out);
 
   s_out.reset();
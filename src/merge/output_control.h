@@ -119,18 +119,30 @@ struct attachment_t {
   memory_cptr data;
   int64_t ui_id;
 
+  // If 'data' is not set then the content is located in a file and
+  // only copied from there while the output file is written.
+  std::string source_file_name;
+  uint64_t source_offset, source_size;
+
   attachment_t() {
     clear();
   }
   void clear() {
-    name         = "";
-    stored_name  = "";
-    mime_type    = "";
-    description  = "";
-    id           = 0;
-    ui_id        = 0;
-    to_all_files = false;
+    name             = "";
+    stored_name      = "";
+    mime_type        = "";
+    description      = "";
+    id               = 0;
+    ui_id            = 0;
+    to_all_files     = false;
     data.reset();
+    source_file_name = "";
+    source_offset    = 0;
+    source_size      = 0;
+  }
+
+  uint64_t get_size() const {
+    return data ? data->get_size() : source_size;
   }
 };
 
@@ -200,7 +212,7 @@ extern float g_video_fps;
 extern generic_packetizer_c *g_video_packetizer;
 
 extern bool g_write_cues, g_cue_writing_requested;
-extern bool g_no_lacing, g_no_linking, g_use_durations;
+extern bool g_no_lacing, g_no_linking, g_use_durations, g_sequential_output, g_flush_after_each_cluster;
 
 extern bool g_identifying, g_identify_verbose, g_identify_for_mmg;
 
@@ -231,6 +243,7 @@ void create_next_output_file();
 void finish_file(bool last_file, bool create_new_file = false, bool previously_discarding = false);
 void rerender_track_headers();
 void rerender_ebml_head();
+void write_pending_headers();
 std::string create_output_name();
 
 int64_t add_attachment(attachment_t attachment);
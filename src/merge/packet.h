@@ -16,6 +16,8 @@
 
 #include "common/common_pch.h"
 
+#include <future>
+
 namespace libmatroska {
   class KaxBlock;
   class KaxBlockBlob;
@@ -61,6 +63,11 @@ struct packet_t {
 
   std::vector<packet_extension_cptr> extensions;
 
+  // Valid while 'data' and 'data_adds' are being compressed in the
+  // background. The result contains the compressed 'data' followed by
+  // the compressed 'data_adds'.
+  std::shared_future<std::vector<memory_cptr>> compressed_content;
+
   packet_t()
     : group(nullptr)
     , block(nullptr)
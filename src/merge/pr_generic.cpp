@@ -31,6 +31,7 @@
 #include "common/math.h"
 #include "common/mm_multi_file_io.h"
 #include "common/strings/formatting.h"
+#include "common/thread_pool.h"
 #include "common/unique_numbers.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "merge/mkvmerge.h"
@@ -82,6 +83,7 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
   , m_hvideo_display_width(-1)
   , m_hvideo_display_height(-1)
   , m_hcompression(COMPRESSION_UNSPECIFIED)
+  , m_compress_in_background(false)
   , m_timecode_factory_application_mode(TFA_AUTOMATIC)
   , m_last_cue_timecode(-1)
   , m_has_been_flushed(false)
@@ -775,9 +777,57 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
       && (pack->data_adds.size()  > static_cast<size_t>(m_htrack_max_add_block_ids)))
     pack->data_adds.resize(m_htrack_max_add_block_ids);
 
-  if (m_compressor) {
+  compress_packet(pack);
+
+  pack->source = this;
+
+  m_enqueued_bytes += pack->data->get_size();
+
+  if ((0 > pack->bref) && (0 <= pack->fref)) {
+    int64_t tmp = pack->bref;
+    pack->bref  = pack->fref;
+    pack->fref  = tmp;
+  }
+
+  if (1 != m_connected_to)
+    add_packet2(pack);
+  else
+    m_deferred_packets.push_back(pack);
+}
+
+static void
+log_compression(memory_cptr const &raw,
+                memory_cptr const &compressed) {
+  mxverb(3, boost::format("zlib_compressor_c: Compression from %1% to %2%, %3%%%\n") % raw->get_size() % compressed->get_size() % (compressed->get_size() * 100 / std::max<size_t>(raw->get_size(), 1)));
+}
+
+static thread_pool_c &
+get_compression_thread_pool() {
+  static thread_pool_c s_pool;
+  return s_pool;
+}
+
+void
+generic_packetizer_c::compress_packet(packet_cptr &pack) {
+  static debugging_option_c s_no_background_compression{"no_background_compression"};
+
+  // zlib compression is stateless and, for the large bitmaps of PGS
+  // and VobSub, expensive enough to be worth moving off the muxing
+  // thread. The result is picked up in get_packet() so the packet
+  // order doesn't change.
+  auto in_background = m_compressor
+                    && m_compress_in_background
+                    && (COMPRESSION_ZLIB == m_compressor->get_method())
+                    && (1 < thread_pool_c::get_num_cpu_cores())
+                    && !s_no_background_compression;
+
+  if (m_compressor && !in_background) {
     try {
-      pack->data = m_compressor->compress(pack->data);
+      auto compressed = m_compressor->compress(pack->data);
+      if (COMPRESSION_ZLIB == m_compressor->get_method())
+        log_compression(pack->data, compressed);
+      pack->data = compressed;
+
       size_t i;
       for (i = 0; pack->data_adds.size() > i; ++i)
         pack->data_adds[i] = m_compressor->compress(pack->data_adds[i]);
@@ -787,24 +837,60 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
     }
   }
 
+  // The source buffers may belong to the reader and be reused once
+  // the packet has been added.
   pack->data->grab();
   for (auto &data_add : pack->data_adds)
     data_add->grab();
 
-  pack->source = this;
+  if (!in_background)
+    return;
 
-  m_enqueued_bytes += pack->data->get_size();
+  // The worker drops its references before the result becomes
+  // available. The buffers are therefore always released on this
+  // thread. Any exception the worker throws is rethrown by the future
+  // and reported by finish_background_compression() on this thread,
+  // too.
+  auto compressor = m_compressor;
+  auto data       = pack->data;
+  auto data_adds  = pack->data_adds;
 
-  if ((0 > pack->bref) && (0 <= pack->fref)) {
-    int64_t tmp = pack->bref;
-    pack->bref  = pack->fref;
-    pack->fref  = tmp;
+  std::function<std::vector<memory_cptr>()> task = [compressor, data, data_adds]() mutable -> std::vector<memory_cptr> {
+    std::vector<memory_cptr> content;
+    content.push_back(compressor->compress(data));
+    for (auto &data_add : data_adds)
+      content.push_back(compressor->compress(data_add));
+
+    data.reset();
+    data_adds.clear();
+
+    return content;
+  };
+
+  pack->compressed_content = get_compression_thread_pool().enqueue(task).share();
+}
+
+void
+generic_packetizer_c::finish_background_compression(packet_cptr &pack) {
+  try {
+    auto content = pack->compressed_content.get();
+
+    log_compression(pack->data, content[0]);
+
+    pack->data = content[0];
+    pack->data_adds.assign(content.begin() + 1, content.end());
+
+  } catch (mtx::compression_x &e) {
+    mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Compression failed: %1%\n")) % e.error());
+
+  } catch (std::exception &e) {
+    mxerror_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Compression failed: %1%\n")) % e.what());
+
+  } catch (...) {
+    mxerror_tid(m_ti.m_fname, m_ti.m_id, Y("Compression failed: unknown error\n"));
   }
 
-  if (1 != m_connected_to)
-    add_packet2(pack);
-  else
-    m_deferred_packets.push_back(pack);
+  pack->compressed_content = std::shared_future<std::vector<memory_cptr>>{};
 }
 
 #define ADJUST_TIMECODE(x) (int64_t)((x + m_correction_timecode_offset + m_append_timecode_offset) * m_ti.m_tcsync.numerator / m_ti.m_tcsync.denominator) + m_ti.m_tcsync.displacement
@@ -889,6 +975,9 @@ generic_packetizer_c::get_packet() {
 
   m_enqueued_bytes -= pack->data->get_size();
 
+  if (pack->compressed_content.valid())
+    finish_background_compression(pack);
+
   --m_next_packet_wo_assigned_timecode;
   if (0 > m_next_packet_wo_assigned_timecode)
     m_next_packet_wo_assigned_timecode = 0;
@@ -1494,7 +1583,7 @@ generic_reader_c::add_available_track_id_range(int64_t start,
 
 int
 generic_reader_c::get_progress() {
-  return 100 * m_in->getFilePointer() / m_size;
+  return std::min<int>(100 * m_in->getFilePointer() / m_size, 100);
 }
 
 mm_multi_file_io_c *
@@ -1529,6 +1618,7 @@ track_info_c::track_info_c()
   , m_nalu_size_length(0)
   , m_no_chapters(false)
   , m_no_global_tags(false)
+  , m_follow_timeout(0)
   , m_avi_block_align(0)
   , m_avi_samples_per_sec(0)
   , m_avi_avg_bytes_per_sec(0)
@@ -1616,6 +1706,7 @@ track_info_c::operator =(const track_info_c &src) {
 
   m_no_chapters                = src.m_no_chapters;
   m_no_global_tags             = src.m_no_global_tags;
+  m_follow_timeout             = src.m_follow_timeout;
 
   m_chapter_charset            = src.m_chapter_charset;
   m_chapter_language           = src.m_chapter_language;
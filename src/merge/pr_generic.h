@@ -302,6 +302,10 @@ public:
 
   bool m_no_chapters, m_no_global_tags;
 
+  // Wait this long (in ns) for a growing source file to grow further
+  // before treating its end as the end of the file. 0 = don't.
+  int64_t m_follow_timeout;
+
   // Some file formats can contain chapters, but for some the charset
   // cannot be identified unambiguously (*cough* OGM *cough*).
   std::string m_chapter_charset, m_chapter_language;
@@ -465,6 +469,7 @@ protected:
 
   compression_method_e m_hcompression;
   compressor_ptr m_compressor;
+  bool m_compress_in_background;
 
   timecode_factory_cptr m_timecode_factory;
   timecode_factory_application_e m_timecode_factory_application_mode;
@@ -499,6 +504,8 @@ public:
   virtual void process_deferred_packets();
 
   virtual packet_cptr get_packet();
+  virtual void compress_packet(packet_cptr &packet);
+  virtual void finish_background_compression(packet_cptr &packet);
   inline bool packet_available() {
     return !m_packet_queue.empty() && m_packet_queue.front()->factory_applied;
   }
@@ -602,6 +609,13 @@ public:
       m_hcompression = method;
   }
 
+  // Lets zlib compress this track's packets on a worker thread. Only
+  // worth it for tracks with large, expensive to compress frames that
+  // are compressed by default, e.g. PGS and VobSub.
+  virtual void enable_background_compression() {
+    m_compress_in_background = true;
+  }
+
   virtual void force_duration_on_last_packet();
 
   virtual translatable_string_c get_format_name() const = 0;
@@ -6,7 +6,7 @@
 #include "common/stereo_mode.h"
 #include "mkvtoolnix-gui/merge_widget/merge_widget.h"
 #include "mkvtoolnix-gui/forms/merge_widget.h"
-#include "mkvtoolnix-gui/util/file_identifier.h"
+#include "mkvtoolnix-gui/util/file_identification_pool.h"
 #include "mkvtoolnix-gui/util/file_type_filter.h"
 #include "mkvtoolnix-gui/util/settings.h"
 #include "mkvtoolnix-gui/util/util.h"
@@ -455,17 +455,22 @@ MergeWidget::addOrAppendFiles(bool append) {
   if (fileNames.empty())
     return;
 
-  QList<SourceFilePtr> identifiedFiles;
-  for (auto &fileName : fileNames) {
-    FileIdentifier identifier{ this, fileName };
-    if (identifier.identify())
-      identifiedFiles << identifier.file();
-  }
+  // The files are identified concurrently; they're added to the
+  // model in batches as soon as their predecessors are done.
+  auto pool = new FileIdentificationPool{this, fileNames};
+  pool->setProperty("append", append);
 
-  if (identifiedFiles.isEmpty())
-    return;
+  connect(pool, SIGNAL(filesIdentified(QList<SourceFilePtr> const &)), this, SLOT(onFilesIdentified(QList<SourceFilePtr> const &)));
+  connect(pool, SIGNAL(finished()),                                     pool, SLOT(deleteLater()));
+
+  pool->start();
+}
+
+void
+MergeWidget::onFilesIdentified(QList<SourceFilePtr> const &files) {
+  auto append = sender()->property("append").toBool();
 
-  m_filesModel->addOrAppendFilesAndTracks(selectedSourceFile(), identifiedFiles, append);
+  m_filesModel->addOrAppendFilesAndTracks(selectedSourceFile(), files, append);
   reinitFilesTracksControls();
 }
 
@@ -87,6 +87,7 @@ public slots:
   virtual void onSubtitleCharacterSetChanged(int newValue);
   virtual void onCuesChanged(int newValue);
   virtual void onUserDefinedTrackOptionsEdited(QString newValue);
+  virtual void onFilesIdentified(QList<SourceFilePtr> const &files);
 
   virtual void resizeFilesColumnsToContents() const;
   virtual void resizeTracksColumnsToContents() const;
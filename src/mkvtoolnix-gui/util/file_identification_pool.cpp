@@ -0,0 +1,97 @@
+#include "common/common_pch.h"
+
+#include <QThread>
+
+#include "mkvtoolnix-gui/util/file_identification_pool.h"
+#include "mkvtoolnix-gui/util/file_identifier.h"
+#include "mkvtoolnix-gui/util/settings.h"
+
+FileIdentificationPool::FileIdentificationPool(QWidget *parent,
+                                               QStringList const &fileNames)
+  : QObject{parent}
+  , m_parent(parent)
+  , m_fileNames(fileNames)
+  , m_processes(fileNames.size())
+  , m_done(fileNames.size(), false)
+  , m_maxConcurrent(std::max(QThread::idealThreadCount(), 1))
+  , m_nextToStart(0)
+  , m_nextToReport(0)
+  , m_reporting(false)
+{
+}
+
+FileIdentificationPool::~FileIdentificationPool() {
+  for (auto &process : m_processes)
+    if (process)
+      disconnect(process.get(), nullptr, this, nullptr);
+}
+
+void
+FileIdentificationPool::start() {
+  startProcesses();
+
+  // Nothing to do at all.
+  if (isFinished())
+    emit finished();
+}
+
+bool
+FileIdentificationPool::isFinished()
+  const {
+  return m_nextToReport >= m_fileNames.size();
+}
+
+void
+FileIdentificationPool::startProcesses() {
+  while ((m_running.size() < m_maxConcurrent) && (m_nextToStart < m_fileNames.size())) {
+    auto idx     = m_nextToStart++;
+    auto process = Process::create(Settings::get().m_mkvmergeExe, FileIdentifier::identificationArguments(m_fileNames[idx]));
+
+    m_processes[idx]         = process;
+    m_running[process.get()] = idx;
+
+    connect(process.get(), SIGNAL(finished()), this, SLOT(processFinished()));
+    process->start();
+  }
+}
+
+void
+FileIdentificationPool::processFinished() {
+  auto process = static_cast<Process *>(sender());
+  if (!m_running.contains(process))
+    return;
+
+  m_done[m_running.take(process)] = true;
+
+  startProcesses();
+  reportResults();
+}
+
+void
+FileIdentificationPool::reportResults() {
+  // Evaluating a result may open a message box whose event loop
+  // delivers further results. Those are picked up by the loop below.
+  if (m_reporting)
+    return;
+
+  m_reporting = true;
+
+  QList<SourceFilePtr> files;
+
+  while ((m_nextToReport < m_fileNames.size()) && m_done[m_nextToReport]) {
+    auto idx     = m_nextToReport++;
+    auto process = m_processes[idx];
+
+    FileIdentifier identifier{ m_parent, m_fileNames[idx] };
+    if (identifier.handleIdentificationResult(process->process().exitCode(), process->output()))
+      files << identifier.file();
+  }
+
+  m_reporting = false;
+
+  if (!files.isEmpty())
+    emit filesIdentified(files);
+
+  if (isFinished())
+    emit finished();
+}
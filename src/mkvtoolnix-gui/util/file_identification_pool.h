@@ -0,0 +1,49 @@
+#ifndef MTX_MMGQT_FILE_IDENTIFICATION_POOL_H
+#define MTX_MMGQT_FILE_IDENTIFICATION_POOL_H
+
+#include "common/common_pch.h"
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include <QWidget>
+
+#include "mkvtoolnix-gui/source_file.h"
+#include "mkvtoolnix-gui/util/process.h"
+
+// Identifies several files by running a number of mkvmerge processes
+// concurrently. The results are reported in the order the file names
+// were given in as soon as they're available.
+class FileIdentificationPool: public QObject {
+  Q_OBJECT;
+
+private:
+  QWidget *m_parent;
+  QStringList m_fileNames;
+  QVector<ProcessPtr> m_processes;
+  QVector<bool> m_done;
+  QHash<Process *, int> m_running;
+  int m_maxConcurrent, m_nextToStart, m_nextToReport;
+  bool m_reporting;
+
+public:
+  FileIdentificationPool(QWidget *parent, QStringList const &fileNames);
+  virtual ~FileIdentificationPool();
+
+  virtual void start();
+  virtual bool isFinished() const;
+
+signals:
+  void filesIdentified(QList<SourceFilePtr> const &files);
+  void finished();
+
+public slots:
+  virtual void processFinished();
+
+protected:
+  virtual void startProcesses();
+  virtual void reportResults();
+};
+
+#endif // MTX_MMGQT_FILE_IDENTIFICATION_POOL_H
@@ -25,12 +25,16 @@ FileIdentifier::identify() {
   if (m_fileName.isEmpty())
     return false;
 
-  QStringList args;
-  args << "--output-charset" << "utf-8" << "--identify-for-mmg" << m_fileName;
+  auto process = Process::execute(Settings::get().m_mkvmergeExe, identificationArguments(m_fileName));
+
+  return handleIdentificationResult(process->process().exitCode(), process->output());
+}
 
-  auto process  = Process::execute(Settings::get().m_mkvmergeExe, args);
-  auto exitCode = process->process().exitCode();
-  m_output      = process->output();
+bool
+FileIdentifier::handleIdentificationResult(int exitCode,
+                                           QStringList const &output) {
+  m_exitCode = exitCode;
+  m_output   = output;
 
   if (0 == exitCode)
     return parseOutput();
@@ -49,6 +53,14 @@ FileIdentifier::identify() {
   return false;
 }
 
+QStringList
+FileIdentifier::identificationArguments(QString const &fileName) {
+  QStringList args;
+  args << "--output-charset" << "utf-8" << "--identify-for-mmg" << fileName;
+
+  return args;
+}
+
 QString const &
 FileIdentifier::fileName()
   const {
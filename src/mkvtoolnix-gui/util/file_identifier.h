@@ -23,6 +23,7 @@ public:
   virtual ~FileIdentifier();
 
   virtual bool identify();
+  virtual bool handleIdentificationResult(int exitCode, QStringList const &output);
   virtual bool parseOutput();
   virtual QHash<QString, QString> parseProperties(QString const &line) const;
   virtual void parseAttachmentLine(QString const &line);
@@ -39,6 +40,8 @@ public:
   virtual QStringList const &output() const;
 
   virtual SourceFilePtr const &file() const;
+
+  static QStringList identificationArguments(QString const &fileName);
 };
 
 #endif // MTX_MMGQT_FILE_IDENTIFIER_H
@@ -1,7 +1,6 @@
 #include "common/common_pch.h"
 
 #include <QRegExp>
-#include <QTemporaryFile>
 
 #include "common/qt.h"
 #include "mkvtoolnix-gui/util/process.h"
@@ -11,7 +10,9 @@ Process::Process(QString const &command,
   : m_command(command)
   , m_args(args)
 {
-  connect(&m_process, SIGNAL(readyReadStandardOutput()), this, SLOT(dataAvailable()));
+  connect(&m_process, SIGNAL(readyReadStandardOutput()),          this, SLOT(dataAvailable()));
+  connect(&m_process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(processFinished()));
+  connect(&m_process, SIGNAL(error(QProcess::ProcessError)),       this, SLOT(processError(QProcess::ProcessError)));
 }
 
 Process::~Process() {
@@ -23,6 +24,13 @@ Process::run() {
   m_process.waitForFinished(-1);
 }
 
+// Starts the process without waiting for it. finished() is emitted
+// once it has exited or if it could not be started at all.
+void
+Process::start() {
+  m_process.start(m_command, m_args);
+}
+
 QStringList
 Process::output()
   const {
@@ -41,31 +49,50 @@ Process::dataAvailable() {
   m_output += QString::fromUtf8(output);
 }
 
-ProcessPtr
-Process::execute(QString const &command,
-                 QStringList const &args,
-                 bool useTempFile) {
-  auto runner = [](QString const &commandToUse, QStringList const &argsToUse) {
-    auto pr = std::make_shared<Process>( commandToUse, argsToUse );
-    pr->run();
-    return pr;
-  };
+void
+Process::processFinished() {
+  dataAvailable();
+  emit finished();
+}
+
+void
+Process::processError(QProcess::ProcessError error) {
+  if (QProcess::FailedToStart == error)
+    emit finished();
+}
 
+ProcessPtr
+Process::create(QString const &command,
+                QStringList const &args,
+                bool useTempFile) {
   if (!useTempFile)
-    return runner(command, args);
+    return std::make_shared<Process>(command, args);
 
-  QTemporaryFile optFile;
+  auto optFile = std::unique_ptr<QTemporaryFile>(new QTemporaryFile);
 
-  if (!optFile.open())
-    throw ProcessX{ to_utf8(QY("Error creating a temporary file (reason: %1).").arg(optFile.errorString())) };
+  if (!optFile->open())
+    throw ProcessX{ to_utf8(QY("Error creating a temporary file (reason: %1).").arg(optFile->errorString())) };
 
   static const unsigned char utf8_bom[3] = {0xef, 0xbb, 0xbf};
-  optFile.write(reinterpret_cast<char const *>(utf8_bom), 3);
+  optFile->write(reinterpret_cast<char const *>(utf8_bom), 3);
   for (auto &arg : args)
-    optFile.write(QString{"%1\n"}.arg(arg).toUtf8());
-  optFile.close();
+    optFile->write(QString{"%1\n"}.arg(arg).toUtf8());
+  optFile->close();
 
   QStringList argsToUse;
-  argsToUse << QString{"@%1"}.arg(optFile.fileName());
-  return runner(command, argsToUse);
+  argsToUse << QString{"@%1"}.arg(optFile->fileName());
+
+  auto pr       = std::make_shared<Process>(command, argsToUse);
+  pr->m_optFile = std::move(optFile);
+
+  return pr;
+}
+
+ProcessPtr
+Process::execute(QString const &command,
+                 QStringList const &args,
+                 bool useTempFile) {
+  auto pr = create(command, args, useTempFile);
+  pr->run();
+  return pr;
 }
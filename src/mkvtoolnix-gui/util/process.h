@@ -5,6 +5,7 @@
 
 #include <QProcess>
 #include <QString>
+#include <QTemporaryFile>
 
 class ProcessX : public mtx::exception {
 protected:
@@ -28,6 +29,7 @@ private:
   QProcess m_process;
   QString m_command, m_output;
   QStringList m_args;
+  std::unique_ptr<QTemporaryFile> m_optFile;
 
 public:
   Process(QString const &command, QStringList const &args);
@@ -36,11 +38,18 @@ public:
   virtual QStringList output() const;
   virtual QProcess const &process() const;
   virtual void run();
+  virtual void start();
+
+signals:
+  void finished();
 
 public slots:
   virtual void dataAvailable();
+  virtual void processFinished();
+  virtual void processError(QProcess::ProcessError error);
 
 public:
+  static ProcessPtr create(QString const &command, QStringList const &args, bool useTempFile = true);
   static ProcessPtr execute(QString const &command, QStringList const &args, bool useTempFile = true);
 };
 
@@ -104,6 +104,8 @@ cli_options_dlg::init_cli_option_list() {
                                            Z("Disables lacing for all tracks. This will increase the file's size, especially if there are many audio tracks. Use only for testing.")));
   all_cli_options.push_back(cli_option_t(wxU("--enable-durations"),
                                            Z("Write durations for all blocks. This will increase file size and does not offer any additional value for players at the moment.")));
+  all_cli_options.push_back(cli_option_t(wxU("--sequential-output"),
+                                           Z("Only ever appends to the output file instead of going back and updating elements written earlier. The segment size and duration will not be written.")));
   all_cli_options.push_back(cli_option_t(  Z("--timecode-scale REPLACEME"),
                                            Z("Forces the timecode scale factor to REPLACEME. You have to replace REPLACEME with a value between 1000 and 10000000 or with -1. "
                                              "Normally mkvmerge will use a value of 1000000 which means that timecodes and durations will have a precision of 1ms. "
@@ -152,6 +154,8 @@ cli_options_dlg::init_cli_option_list() {
                                            Z("Causes mkvmerge not to write 'CueDuration' elemenets in the cues.")));
   all_cli_options.push_back(cli_option_t(wxU("--engage no_cue_relative_position"),
                                            Z("Causes mkvmerge not to write 'CueRelativePosition' elemenets in the cues.")));
+  all_cli_options.push_back(cli_option_t(wxU("--engage no_direct_cluster_rendering"),
+                                           Z("Causes mkvmerge to always use libmatroska for rendering clusters instead of serializing them directly.")));
   all_cli_options.push_back(cli_option_t(wxU("--engage cow"),
                                            Z("No help available.")));
 }
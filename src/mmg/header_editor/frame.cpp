@@ -253,6 +253,9 @@ header_editor_frame_c::open_file(wxFileName file_name) {
 
   m_analyzer = wx_kax_analyzer_cptr(new wx_kax_analyzer_c(this, wxMB(file_name.GetFullPath())));
 
+  if (mdlg->options.header_editor_index_cache)
+    m_analyzer->enable_index_cache();
+
   if (!m_analyzer->process(kax_analyzer_c::parse_mode_fast)) {
     wxMessageBox(Z("This file could not be opened or parsed."), Z("File parsing failed"), wxOK | wxCENTER | wxICON_ERROR);
     m_analyzer.reset();
@@ -543,6 +546,11 @@ header_editor_frame_c::on_file_save(wxCommandEvent &) {
       display_update_element_result(result);
   }
 
+  if (mdlg->options.header_editor_index_cache) {
+    m_analyzer->close_file();
+    m_analyzer->save_index_cache();
+  }
+
   open_file(m_file_name);
 }
 
@@ -17,6 +17,7 @@
 #include <wx/clipbrd.h>
 #include <wx/confbase.h>
 #include <wx/file.h>
+#include <wx/filename.h>
 #include <wx/fileconf.h>
 #include <wx/listctrl.h>
 #include <wx/notebook.h>
@@ -42,11 +43,14 @@ job_run_dialog::job_run_dialog(wxWindow *,
                                std::vector<int> &n_jobs_to_start)
   : wxDialog(nullptr, -1, Z("mkvmerge is running"), wxDefaultPosition, wxSize(700, 700), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER | wxMINIMIZE_BOX | wxMAXIMIZE_BOX)
   , t_update(new wxTimer(this, 1))
-  , out(nullptr)
-  , process(nullptr)
   , abort(false)
   , jobs_to_start(n_jobs_to_start)
-  , current_job(-1)
+  , m_job_started(n_jobs_to_start.size(), false)
+  , m_num_started(0)
+  , m_num_finished(0)
+  , m_loaded_job_id(-1)
+  , m_max_concurrent_jobs(std::max<uint64_t>(mdlg->options.max_concurrent_jobs, 1))
+  , m_max_concurrent_jobs_per_volume(std::max<uint64_t>(mdlg->options.max_concurrent_jobs_per_volume, 1))
   , m_progress(0)
 #if defined(SYS_WINDOWS)
   , m_taskbar_progress(nullptr)
@@ -114,76 +118,192 @@ job_run_dialog::job_run_dialog(wxWindow *,
 
   m_start_time_total                 = get_current_time_millis();
   m_next_remaining_time_update_total = m_start_time_total + 8000;
+  m_next_remaining_time_update       = m_start_time_total + 8000;
 
-  start_next_job();
+  start_jobs();
 
   ShowModal();
 }
 
+// Identifies the volume a file resides on. Files that don't exist yet
+// (e.g. the output file) are looked up via their directory.
+static wxString
+get_volume_key(wxString const &file_name) {
+  if (file_name.IsEmpty())
+    return wxEmptyString;
+
+  wxStructStat st;
+  if (   (0 != wxStat(file_name, &st))
+      && (0 != wxStat(wxFileName{file_name}.GetPath(), &st)))
+    return wxEmptyString;
+
+  return wxString::Format(wxT("%lu"), static_cast<unsigned long>(st.st_dev));
+}
+
 void
-job_run_dialog::start_next_job() {
-  t_update->Stop();
+job_run_dialog::start_jobs() {
+  while (!abort && !cb_abort_after_current->IsChecked() && (m_running_jobs.size() < m_max_concurrent_jobs)) {
+    int slot = find_job_to_start();
+    if (-1 == slot)
+      break;
 
-  ++current_job;
+    start_job(slot);
+  }
 
-  if ((static_cast<int>(jobs_to_start.size()) <= current_job) || cb_abort_after_current->IsChecked() || abort) {
-    if (   abort
-        || (   cb_abort_after_current->IsChecked()
-            && (current_job < static_cast<int>(jobs_to_start.size()))))
-      add_to_log(wxString::Format(Z("Aborted processing on %s"), format_date_time(wxGetUTCTime()).c_str()));
-    else
-      add_to_log(wxString::Format(Z("Finished processing on %s"), format_date_time(wxGetUTCTime()).c_str()));
+  if (m_running_jobs.empty()) {
+    finish_processing();
+    return;
+  }
 
-    b_abort->Enable(false);
-    cb_abort_after_current->Enable(false);
-    b_ok->Enable(true);
-    b_ok->SetFocus();
-    SetTitle(Z("mkvmerge has finished"));
+  update_status_labels();
+  update_progress();
 
-    st_remaining_time->SetLabel(wxT("---"));
-    st_remaining_time_total->SetLabel(wxT("---"));
+  t_update->Start(100);
+}
+
+void
+job_run_dialog::finish_processing() {
+  t_update->Stop();
+
+  if (   abort
+      || (   cb_abort_after_current->IsChecked()
+          && (m_num_started < static_cast<int>(jobs_to_start.size()))))
+    add_to_log(wxString::Format(Z("Aborted processing on %s"), format_date_time(wxGetUTCTime()).c_str()));
+  else
+    add_to_log(wxString::Format(Z("Finished processing on %s"), format_date_time(wxGetUTCTime()).c_str()));
+
+  b_abort->Enable(false);
+  cb_abort_after_current->Enable(false);
+  b_ok->Enable(true);
+  b_ok->SetFocus();
+  SetTitle(Z("mkvmerge has finished"));
+
+  st_remaining_time->SetLabel(wxT("---"));
+  st_remaining_time_total->SetLabel(wxT("---"));
 
 #if defined(SYS_WINDOWS)
-    if (m_taskbar_progress)
-      m_taskbar_progress->set_state(TBPF_NOPROGRESS);
+  if (m_taskbar_progress)
+    m_taskbar_progress->set_state(TBPF_NOPROGRESS);
 #endif
+}
 
-    return;
+/** \brief Find the next job that can be started right now
+
+   Jobs are considered in queue order. If other jobs are running then
+   a job is only started if each volume it reads from or writes to is
+   used by fewer running jobs than the configured maximum per volume.
+   That way jobs on different drives overlap while jobs on the same
+   drive don't compete for it more than allowed.
+
+   Returns the job's index into \c jobs_to_start or -1 if no job can
+   be started.
+*/
+int
+job_run_dialog::find_job_to_start() {
+  std::map<wxString, size_t> jobs_per_volume;
+  for (auto &job : m_running_jobs)
+    for (auto &volume : job->volumes)
+      ++jobs_per_volume[volume];
+
+  for (int slot = 0; static_cast<int>(jobs_to_start.size()) > slot; ++slot) {
+    if (m_job_started[slot])
+      continue;
+
+    if (m_running_jobs.empty())
+      return slot;
+
+    auto &volumes = get_job_volumes(slot);
+    auto is_busy  = std::any_of(volumes.begin(), volumes.end(), [this, &jobs_per_volume](wxString const &volume) {
+      auto itr = jobs_per_volume.find(volume);
+      return (jobs_per_volume.end() != itr) && (itr->second >= m_max_concurrent_jobs_per_volume);
+    });
+
+    if (!is_busy)
+      return slot;
   }
 
-  m_start_time                 = get_current_time_millis();
-  m_next_remaining_time_update = m_start_time + 8000;
-  st_remaining_time->SetLabel(Z("is being estimated"));
+  return -1;
+}
 
-#if defined(SYS_WINDOWS)
-  if (m_taskbar_progress) {
-    m_taskbar_progress->set_state(TBPF_NORMAL);
-    m_taskbar_progress->set_value(current_job * 100, jobs_to_start.size() * 100);
+void
+job_run_dialog::load_job(int slot) {
+  int id = jobs[jobs_to_start[slot]].id;
+  if (id == m_loaded_job_id)
+    return;
+
+  mdlg->load(wxString::Format(wxT("%s/%d.mmg"), app->get_jobs_folder().c_str(), id), true);
+  m_loaded_job_id = id;
+}
+
+/** \brief Determine the volumes a job reads from and writes to
+
+   The file names are read from the stored job file directly so that
+   the GUI's current settings aren't touched.
+*/
+std::vector<wxString> const &
+job_run_dialog::get_job_volumes(int slot) {
+  int id   = jobs[jobs_to_start[slot]].id;
+  auto itr = m_job_volumes.find(id);
+  if (m_job_volumes.end() != itr)
+    return itr->second;
+
+  std::vector<wxString> volumes;
+  auto add_volume = [&volumes](wxString const &file_name) {
+    auto volume = get_volume_key(file_name);
+    if (!volume.IsEmpty() && (volumes.end() == std::find(volumes.begin(), volumes.end(), volume)))
+      volumes.push_back(volume);
+  };
+
+  wxFileConfig cfg(wxT("mkvmerge GUI"), wxT("Moritz Bunkus"), wxString::Format(wxT("%s/%d.mmg"), app->get_jobs_folder().c_str(), id));
+  cfg.SetExpandEnvVars(false);
+
+  wxString s;
+  cfg.SetPath(wxT("/mkvmergeGUI"));
+  if (cfg.Read(wxT("output_file_name"), &s))
+    add_volume(s);
+
+  int num_files = 0;
+  cfg.SetPath(wxT("/input"));
+  cfg.Read(wxT("number_of_files"), &num_files);
+
+  for (int fidx = 0; num_files > fidx; ++fidx) {
+    cfg.SetPath(wxString::Format(wxT("/input/file %d"), fidx));
+    if (cfg.Read(wxT("file_name"), &s))
+      add_volume(s);
+
+    if (cfg.Read(wxT("other_files"), &s) && !s.IsEmpty())
+      for (auto &other_file_name : split(s, wxU(":::")))
+        add_volume(other_file_name);
   }
-#endif
 
-  int ndx = jobs_to_start[current_job];
-  st_jobs->SetLabel(wxString::Format(Z("Processing job %d/%d"), current_job + 1, (int)jobs_to_start.size()));
-  st_current->SetLabel(wxString::Format(Z("Current job ID %d:"), jobs[ndx].id));
+  m_job_volumes[id] = volumes;
 
-  mdlg->load(wxString::Format(wxT("%s/%d.mmg"), app->get_jobs_folder().c_str(), jobs[ndx].id), true);
+  return m_job_volumes[id];
+}
+
+bool
+job_run_dialog::start_job(int slot) {
+  m_job_started[slot] = true;
+  ++m_num_started;
+
+  int ndx      = jobs_to_start[slot];
+  auto job     = std::make_shared<running_job_t>(slot);
+  job->volumes = get_job_volumes(slot);
 
-  opt_file_name.Printf(wxT("%smmg-mkvmerge-options-%d-%d"), get_temp_dir().c_str(), (int)wxGetProcessId(), (int)wxGetUTCTime());
+  load_job(slot);
+
+  job->opt_file_name.Printf(wxT("%smmg-mkvmerge-options-%d-%d-%d"), get_temp_dir().c_str(), (int)wxGetProcessId(), jobs[ndx].id, (int)wxGetUTCTime());
 
   wxFile *opt_file;
   try {
-    opt_file = new wxFile(opt_file_name, wxFile::write);
+    opt_file = new wxFile(job->opt_file_name, wxFile::write);
   } catch (...) {
     jobs[ndx].log->Printf(Z("Could not create a temporary file for mkvmerge's command line option called '%s' (error code %d, %s)."),
-                          opt_file_name.c_str(), errno, wxUCS(strerror(errno)));
+                          job->opt_file_name.c_str(), errno, wxUCS(strerror(errno)));
     jobs[ndx].status = JOBS_FAILED;
     mdlg->save_job_queue();
-    if (process) {
-      delete process;
-      process = nullptr;
-    }
-    start_next_job();
-    return;
+    ++m_num_finished;
+    return false;
   }
 
   static const unsigned char utf8_bom[3] = {0xef, 0xbb, 0xbf};
@@ -204,15 +324,21 @@ job_run_dialog::start_next_job() {
   }
   delete opt_file;
 
-  process = new wxProcess(this, 1);
-  process->Redirect();
-  wxString command_line = wxString::Format(wxT("\"%s\" \"@%s\""), (*arg_list)[0].c_str(), opt_file_name.c_str());
-  pid = wxExecute(command_line, wxEXEC_ASYNC, process);
-  if (0 == pid) {
+  job->process = new wxProcess(this, 1);
+  job->process->Redirect();
+  wxString command_line = wxString::Format(wxT("\"%s\" \"@%s\""), (*arg_list)[0].c_str(), job->opt_file_name.c_str());
+  job->pid = wxExecute(command_line, wxEXEC_ASYNC, job->process);
+  if (0 == job->pid) {
     wxLogError(wxT("Execution of '%s' failed."), command_line.c_str());
-    return;
+    delete job->process;
+    wxRemoveFile(job->opt_file_name);
+    jobs[ndx].status = JOBS_FAILED;
+    mdlg->save_job_queue();
+    ++m_num_finished;
+    return false;
   }
-  out = process->GetInputStream();
+  job->out        = job->process->GetInputStream();
+  job->start_time = get_current_time_millis();
 
   *jobs[ndx].log        = wxEmptyString;
   jobs[ndx].started_on  = wxGetUTCTime();
@@ -220,25 +346,35 @@ job_run_dialog::start_next_job() {
 
   add_to_log(wxString::Format(Z("Starting job ID %d (%s) on %s"), jobs[ndx].id, jobs[ndx].description->c_str(), format_date_time(jobs[ndx].started_on).c_str()));
 
-  t_update->Start(100);
+  m_running_jobs.push_back(job);
+
+  return true;
 }
 
 void
 job_run_dialog::process_input() {
-  if (!process)
+  for (auto &job : m_running_jobs)
+    process_input(*job);
+
+  update_remaining_time();
+}
+
+void
+job_run_dialog::process_input(running_job_t &job) {
+  if (!job.process)
     return;
 
-  while (process->IsInputAvailable()) {
+  while (job.process->IsInputAvailable()) {
     bool got_char = false;
     char c        = 0;
 
-    if (!out->Eof()) {
-      c = out->GetC();
+    if (!job.out->Eof()) {
+      c = job.out->GetC();
       got_char = true;
     }
 
-    if (got_char && ((c == '\n') || (c == '\r') || out->Eof())) {
-      wxString wx_line = wxU(line);
+    if (got_char && ((c == '\n') || (c == '\r') || job.out->Eof())) {
+      wxString wx_line = wxU(job.line);
       if (wx_line.Find(Z("Progress")) == 0) {
         int percent_pos = wx_line.Find(wxT("%"));
         if (0 < percent_pos) {
@@ -248,30 +384,54 @@ job_run_dialog::process_input() {
           long value;
           tmp.ToLong(&value);
           if ((value >= 0) && (value <= 100))
-            set_progress_value(value);
+            set_progress_value(job, value);
         }
       } else if (wx_line.Length() > 0)
-        *jobs[jobs_to_start[current_job]].log += wx_line + wxT("\n");
-      line = "";
+        *jobs[jobs_to_start[job.slot]].log += wx_line + wxT("\n");
+      job.line = "";
     } else if ((unsigned char)c != 0xff)
-      line += c;
-
-    update_remaining_time();
+      job.line += c;
 
-    if (out->Eof())
+    if (job.out->Eof())
       break;
   }
 }
 
 void
-job_run_dialog::set_progress_value(long value) {
-  m_progress = current_job * 100 + value;
-  g_progress->SetValue(value);
+job_run_dialog::set_progress_value(running_job_t &job,
+                                   long value) {
+  job.progress = value;
+  update_progress();
+}
+
+void
+job_run_dialog::update_progress() {
+  int running_progress = 0;
+  for (auto &job : m_running_jobs)
+    running_progress += job->progress;
+
+  m_progress = m_num_finished * 100 + running_progress;
+  g_progress->SetValue(m_running_jobs.empty() ? 0 : running_progress / static_cast<int>(m_running_jobs.size()));
   g_jobs->SetValue(m_progress);
 
 #if defined(SYS_WINDOWS)
   if (m_taskbar_progress)
-    m_taskbar_progress->set_value(current_job * 100 + value, jobs_to_start.size() * 100);
+    m_taskbar_progress->set_value(m_progress, jobs_to_start.size() * 100);
+#endif
+}
+
+void
+job_run_dialog::update_status_labels() {
+  st_jobs->SetLabel(wxString::Format(Z("Processing job %d/%d"), m_num_started, (int)jobs_to_start.size()));
+
+  if (1 == m_running_jobs.size())
+    st_current->SetLabel(wxString::Format(Z("Current job ID %d:"), jobs[jobs_to_start[m_running_jobs.front()->slot]].id));
+  else
+    st_current->SetLabel(wxString::Format(Z("%d jobs running:"), (int)m_running_jobs.size()));
+
+#if defined(SYS_WINDOWS)
+  if (m_taskbar_progress)
+    m_taskbar_progress->set_state(TBPF_NORMAL);
 #endif
 }
 
@@ -282,12 +442,22 @@ job_run_dialog::update_remaining_time() {
 
   int64_t now = get_current_time_millis();
 
-  if ((0 != (m_progress % 100)) && (now >= m_next_remaining_time_update)) {
-    int64_t total_time           = (now - m_start_time) * 100 / (m_progress % 100);
-    int64_t remaining_time       = total_time - now + m_start_time;
-    m_next_remaining_time_update = now + 1000;
+  if (now >= m_next_remaining_time_update) {
+    // With several jobs running the one that will take longest
+    // determines the time shown.
+    int64_t remaining_time = -1;
+    for (auto &job : m_running_jobs) {
+      if ((0 == job->progress) || (100 == job->progress) || ((job->start_time + 8000) > now))
+        continue;
+
+      int64_t total_time = (now - job->start_time) * 100 / job->progress;
+      remaining_time     = std::max(remaining_time, total_time - now + job->start_time);
+    }
 
-    st_remaining_time->SetLabel(wxU(create_minutes_seconds_time_string(static_cast<unsigned int>(remaining_time / 1000))));
+    if (-1 != remaining_time) {
+      m_next_remaining_time_update = now + 1000;
+      st_remaining_time->SetLabel(wxU(create_minutes_seconds_time_string(static_cast<unsigned int>(remaining_time / 1000))));
+    }
   }
 
   if (now >= m_next_remaining_time_update_total) {
@@ -315,20 +485,31 @@ job_run_dialog::on_idle(wxIdleEvent &) {
 void
 job_run_dialog::on_abort(wxCommandEvent &) {
   abort = true;
+  for (auto &job : m_running_jobs) {
+#if defined(SYS_WINDOWS)
+    wxKill(job->pid, wxSIGKILL);
+#else
+    wxKill(job->pid, wxSIGTERM);
+#endif
+  }
+
 #if defined(SYS_WINDOWS)
-  wxKill(pid, wxSIGKILL);
   if (m_taskbar_progress)
     m_taskbar_progress->set_state(TBPF_ERROR);
-#else
-  wxKill(pid, wxSIGTERM);
 #endif
 }
 
 void
 job_run_dialog::on_end_process(wxProcessEvent &evt) {
-  process_input();
+  auto itr = std::find_if(m_running_jobs.begin(), m_running_jobs.end(), [&evt](running_job_cptr const &job) { return job->pid == evt.GetPid(); });
+  if (m_running_jobs.end() == itr)
+    return;
+
+  auto job = *itr;
+  process_input(*job);
+  m_running_jobs.erase(itr);
 
-  int ndx         = jobs_to_start[current_job];
+  int ndx         = jobs_to_start[job->slot];
   int exit_code   = evt.GetExitCode();
   bool remove_job;
   wxString status;
@@ -363,16 +544,16 @@ job_run_dialog::on_end_process(wxProcessEvent &evt) {
   }
 
   mdlg->save_job_queue();
-  delete process;
-  process = nullptr;
-  out     = nullptr;
+  delete job->process;
+  job->process = nullptr;
+  job->out     = nullptr;
 
-  wxRemoveFile(opt_file_name);
+  wxRemoveFile(job->opt_file_name);
 
   if (!abort)
-    g_jobs->SetValue((current_job + 1) * 100);
+    ++m_num_finished;
 
-  start_next_job();
+  start_jobs();
 }
 
 void
@@ -64,6 +64,29 @@ public:
   void on_save(wxCommandEvent &evt);
 };
 
+struct running_job_t {
+  int slot;                     // index into job_run_dialog::jobs_to_start
+  wxProcess *process;
+  wxInputStream *out;
+  std::string line;
+  wxString opt_file_name;
+  long pid;
+  int progress;
+  int64_t start_time;
+  std::vector<wxString> volumes;
+
+  running_job_t(int p_slot)
+    : slot(p_slot)
+    , process(nullptr)
+    , out(nullptr)
+    , pid(0)
+    , progress(0)
+    , start_time(0)
+  {
+  }
+};
+typedef std::shared_ptr<running_job_t> running_job_cptr;
+
 class job_run_dialog: public wxDialog {
   DECLARE_CLASS(job_run_dialog);
   DECLARE_EVENT_TABLE();
@@ -75,17 +98,16 @@ protected:
   wxTextCtrl *tc_log;
 
   wxTimer *t_update;
-  wxInputStream *out;
-  std::string line;
-  wxProcess *process;
-  wxString opt_file_name;
   bool abort;
-  long pid;
   std::vector<int> jobs_to_start;
-  int current_job;
+  std::vector<bool> m_job_started;
+  std::vector<running_job_cptr> m_running_jobs;
+  std::map<int, std::vector<wxString> > m_job_volumes;
+  int m_num_started, m_num_finished, m_loaded_job_id;
+  size_t m_max_concurrent_jobs, m_max_concurrent_jobs_per_volume;
 
   int m_progress;
-  int64_t m_next_remaining_time_update, m_next_remaining_time_update_total, m_start_time, m_start_time_total;
+  int64_t m_next_remaining_time_update, m_next_remaining_time_update_total, m_start_time_total;
 
 #if defined(SYS_WINDOWS)
   taskbar_progress_c *m_taskbar_progress;
@@ -99,10 +121,18 @@ public:
   void on_timer(wxTimerEvent &evt);
   void on_idle(wxIdleEvent &evt);
 
-  void start_next_job();
+  void start_jobs();
+  bool start_job(int slot);
+  void finish_processing();
+  int find_job_to_start();
+  void load_job(int slot);
+  std::vector<wxString> const &get_job_volumes(int slot);
   void process_input();
+  void process_input(running_job_t &job);
   void add_to_log(wxString text);
-  void set_progress_value(long value);
+  void set_progress_value(running_job_t &job, long value);
+  void update_progress();
+  void update_status_labels();
   void update_remaining_time();
 };
 
@@ -212,7 +212,7 @@ struct mmg_options_t {
   clear_job_after_run_mode_e clear_job_after_run_mode;
   bool ask_before_overwriting, unique_output_file_name_suggestions;
   scan_directory_for_playlists_e scan_directory_for_playlists;
-  uint64_t min_playlist_duration;
+  uint64_t min_playlist_duration, max_concurrent_jobs, max_concurrent_jobs_per_volume;
   bool on_top;
   bool filenew_after_add_to_jobqueue;
   bool filenew_after_successful_mux;
@@ -220,6 +220,7 @@ struct mmg_options_t {
   bool gui_debugging;
   bool set_delay_from_filename;
   bool check_for_updates;
+  bool header_editor_index_cache;
   wxString priority;
   wxArrayString popular_languages;
   wxString default_cli_options;
@@ -232,6 +233,8 @@ struct mmg_options_t {
     , unique_output_file_name_suggestions{true}
     , scan_directory_for_playlists{SDP_ALWAYS_ASK}
     , min_playlist_duration{120}
+    , max_concurrent_jobs{1}
+    , max_concurrent_jobs_per_volume{2}
     , on_top(false)
     , filenew_after_add_to_jobqueue(false)
     , filenew_after_successful_mux(false)
@@ -239,6 +242,7 @@ struct mmg_options_t {
     , gui_debugging(false)
     , set_delay_from_filename(false)
     , check_for_updates(true)
+    , header_editor_index_cache(false)
   {
     init_popular_languages();
   }
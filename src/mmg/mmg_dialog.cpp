@@ -1613,10 +1613,13 @@ mmg_dialog::save_preferences() {
   cfg->Write(wxU("gui_debugging"),                       options.gui_debugging);
   cfg->Write(wxU("set_delay_from_filename"),             options.set_delay_from_filename);
   cfg->Write(wxU("check_for_updates"),                   options.check_for_updates);
+  cfg->Write(wxU("header_editor_index_cache"),           options.header_editor_index_cache);
   cfg->Write(wxU("popular_languages"),                   join(wxU(" "), options.popular_languages));
   cfg->Write(wxU("default_cli_options"),                 options.default_cli_options);
   cfg->Write(wxU("scan_directory_for_playlists"),        static_cast<int>(options.scan_directory_for_playlists));
   cfg->Write(wxU("min_playlist_duration"),               static_cast<long>(options.min_playlist_duration));
+  cfg->Write(wxU("max_concurrent_jobs"),                 static_cast<long>(options.max_concurrent_jobs));
+  cfg->Write(wxU("max_concurrent_jobs_per_volume"),      static_cast<long>(options.max_concurrent_jobs_per_volume));
 
   cfg->Flush();
 }
@@ -1656,12 +1659,17 @@ mmg_dialog::load_preferences() {
   cfg->Read(wxU("gui_debugging"),                       &options.gui_debugging,                       false);
   cfg->Read(wxU("set_delay_from_filename"),             &options.set_delay_from_filename,             true);
   cfg->Read(wxU("check_for_updates"),                   &options.check_for_updates,                   true);
+  cfg->Read(wxU("header_editor_index_cache"),           &options.header_editor_index_cache,           false);
   cfg->Read(wxU("popular_languages"),                   &s,                                           wxEmptyString);
   cfg->Read(wxU("default_cli_options"),                 &options.default_cli_options,                 wxEmptyString);
   cfg->Read(wxU("scan_directory_for_playlists"),        &value_long,                                  SDP_ALWAYS_ASK);
   options.scan_directory_for_playlists = static_cast<scan_directory_for_playlists_e>(value_long);
   cfg->Read(wxU("min_playlist_duration"),               &value_long,                                  120);
   options.min_playlist_duration        = value_long;
+  cfg->Read(wxU("max_concurrent_jobs"),                 &value_long,                                  1);
+  options.max_concurrent_jobs          = std::max(value_long, 1l);
+  cfg->Read(wxU("max_concurrent_jobs_per_volume"),      &value_long,                                  2);
+  options.max_concurrent_jobs_per_volume = std::max(value_long, 1l);
 
   options.init_popular_languages(s);
   options.validate();
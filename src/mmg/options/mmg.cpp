@@ -83,6 +83,10 @@ optdlg_mmg_tab::optdlg_mmg_tab(wxWindow *parent,
                                        "No information is transmitted to the server."));
 #endif  // defined(HAVE_CURL_EASY_H)
 
+  cb_header_editor_index_cache = new wxCheckBox(this, ID_CB_HEADER_EDITOR_INDEX_CACHE, Z("Cache the element index of files opened in the header editor"));
+  cb_header_editor_index_cache->SetToolTip(TIP("If checked the header editor stores the positions of all top level elements in a file next to the Matroska file. "
+                                               "Opening the same file again does not require scanning it completely as long as it hasn't been modified by another program."));
+
   cb_gui_debugging = new wxCheckBox(this, ID_CB_GUI_DEBUGGING, Z("Show mmg's debug window"));
   cb_gui_debugging->SetToolTip(TIP("Shows mmg's debug window in which debug messages will appear. "
                                    "This is only useful if you're helping the author debug a problem in mmg."));
@@ -132,6 +136,16 @@ optdlg_mmg_tab::optdlg_mmg_tab(wxWindow *parent,
   tc_min_playlist_duration->SetToolTip(TIP("Only playlists whose duration are at least this long are considered and offered to the user for selection."));
   tc_min_playlist_duration->SetValidator(wxTextValidator(wxFILTER_NUMERIC));
 
+  auto st_max_concurrent_jobs = new wxStaticText(this, -1, Z("Maximum number of jobs to run at the same time:"));
+  tc_max_concurrent_jobs = new wxTextCtrl(this, -1, wxU(boost::format("%1%") % m_options.max_concurrent_jobs));
+  tc_max_concurrent_jobs->SetToolTip(TIP("When the job queue is run this many jobs may be run in parallel."));
+  tc_max_concurrent_jobs->SetValidator(wxTextValidator(wxFILTER_NUMERIC));
+
+  auto st_max_concurrent_jobs_per_volume = new wxStaticText(this, -1, Z("Maximum number of jobs using the same drive:"));
+  tc_max_concurrent_jobs_per_volume = new wxTextCtrl(this, -1, wxU(boost::format("%1%") % m_options.max_concurrent_jobs_per_volume));
+  tc_max_concurrent_jobs_per_volume->SetToolTip(TIP("A job is only started if fewer than this many running jobs read from or write to each of the drives it uses."));
+  tc_max_concurrent_jobs_per_volume->SetValidator(wxTextValidator(wxFILTER_NUMERIC));
+
   // Set the defaults.
 
   cb_on_top->SetValue(m_options.on_top);
@@ -140,6 +154,7 @@ optdlg_mmg_tab::optdlg_mmg_tab(wxWindow *parent,
   cb_warn_usage->SetValue(m_options.warn_usage);
   cb_gui_debugging->SetValue(m_options.gui_debugging);
   cb_set_delay_from_filename->SetValue(m_options.set_delay_from_filename);
+  cb_header_editor_index_cache->SetValue(m_options.header_editor_index_cache);
 
   cb_clear_job_after_run->SetValue(m_options.clear_job_after_run_mode != CJAR_NEVER);
   set_combobox_selection(cob_clear_job_after_run_mode, std::max(static_cast<int>(m_options.clear_job_after_run_mode), 1) - 1);
@@ -206,6 +221,9 @@ optdlg_mmg_tab::optdlg_mmg_tab(wxWindow *parent,
   siz_all->AddSpacer(5);
 #endif  // defined(HAVE_CURL_EASY_H)
 
+  siz_all->Add(cb_header_editor_index_cache, 0, wxLEFT, 5);
+  siz_all->AddSpacer(5);
+
   siz_all->Add(cb_gui_debugging, 0, wxLEFT, 5);
   siz_all->AddSpacer(5);
 
@@ -223,6 +241,20 @@ optdlg_mmg_tab::optdlg_mmg_tab(wxWindow *parent,
   siz_all->Add(siz_line, 0, wxLEFT | wxGROW, 5);
   siz_all->AddSpacer(5);
 
+  siz_line = new wxBoxSizer(wxHORIZONTAL);
+  siz_line->Add(st_max_concurrent_jobs, 0, wxALIGN_CENTER_VERTICAL,                             0);
+  siz_line->Add(tc_max_concurrent_jobs, 1, wxALIGN_CENTER_VERTICAL | wxLEFT | wxRIGHT | wxGROW, 5);
+
+  siz_all->Add(siz_line, 0, wxLEFT | wxGROW, 5);
+  siz_all->AddSpacer(5);
+
+  siz_line = new wxBoxSizer(wxHORIZONTAL);
+  siz_line->Add(st_max_concurrent_jobs_per_volume, 0, wxALIGN_CENTER_VERTICAL,                             0);
+  siz_line->Add(tc_max_concurrent_jobs_per_volume, 1, wxALIGN_CENTER_VERTICAL | wxLEFT | wxRIGHT | wxGROW, 5);
+
+  siz_all->Add(siz_line, 0, wxLEFT | wxGROW, 5);
+  siz_all->AddSpacer(5);
+
   SetSizer(siz_all);
 }
 
@@ -248,6 +280,7 @@ optdlg_mmg_tab::save_options() {
   m_options.warn_usage                    = cb_warn_usage->IsChecked();
   m_options.gui_debugging                 = cb_gui_debugging->IsChecked();
   m_options.set_delay_from_filename       = cb_set_delay_from_filename->IsChecked();
+  m_options.header_editor_index_cache     = cb_header_editor_index_cache->IsChecked();
   m_options.clear_job_after_run_mode      = cb_clear_job_after_run->IsChecked() ? static_cast<clear_job_after_run_mode_e>(cob_clear_job_after_run_mode->GetSelection() + 1) : CJAR_NEVER;
 #if defined(HAVE_CURL_EASY_H)
   m_options.check_for_updates             = cb_check_for_updates->IsChecked();
@@ -255,6 +288,10 @@ optdlg_mmg_tab::save_options() {
   m_options.scan_directory_for_playlists  = static_cast<scan_directory_for_playlists_e>(cob_scan_directory_for_playlists->GetSelection());
   if (!parse_number(to_utf8(tc_min_playlist_duration->GetValue()), m_options.min_playlist_duration))
     m_options.min_playlist_duration = 0;
+  if (!parse_number(to_utf8(tc_max_concurrent_jobs->GetValue()), m_options.max_concurrent_jobs) || !m_options.max_concurrent_jobs)
+    m_options.max_concurrent_jobs = 1;
+  if (!parse_number(to_utf8(tc_max_concurrent_jobs_per_volume->GetValue()), m_options.max_concurrent_jobs_per_volume) || !m_options.max_concurrent_jobs_per_volume)
+    m_options.max_concurrent_jobs_per_volume = 2;
 
 #if defined(HAVE_LIBINTL_H)
   std::string new_ui_locale = get_selected_ui_language();
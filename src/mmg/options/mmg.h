@@ -32,6 +32,7 @@
 #define ID_COB_CLEAR_JOB_AFTER_RUN_MODE 15120
 #define ID_CB_CLEAR_JOB_AFTER_RUN       15121
 #define ID_COB_SCAN_DIRECTORY_FOR_PLAYLISTS 15124
+#define ID_CB_HEADER_EDITOR_INDEX_CACHE 15125
 
 class optdlg_mmg_tab: public optdlg_base_tab {
   DECLARE_CLASS(optdlg_mmg_tab);
@@ -42,12 +43,13 @@ public:
   wxCheckBox *cb_filenew_after_successful_mux;
   wxCheckBox *cb_warn_usage, *cb_gui_debugging;
   wxCheckBox *cb_set_delay_from_filename;
+  wxCheckBox *cb_header_editor_index_cache;
 #if defined(HAVE_CURL_EASY_H)
   wxCheckBox *cb_check_for_updates;
 #endif  // defined(HAVE_CURL_EASY_H)
   wxCheckBox *cb_clear_job_after_run;
   wxMTX_COMBOBOX_TYPE *cob_clear_job_after_run_mode, *cob_scan_directory_for_playlists;
-  wxTextCtrl *tc_min_playlist_duration;
+  wxTextCtrl *tc_min_playlist_duration, *tc_max_concurrent_jobs, *tc_max_concurrent_jobs_per_volume;
 
 #if defined(HAVE_LIBINTL_H)
   wxMTX_COMBOBOX_TYPE *cob_ui_language;
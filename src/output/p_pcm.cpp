@@ -81,18 +81,49 @@ pcm_packetizer_c::process(packet_cptr packet) {
   if (packet->has_timecode())
     return process_packaged(packet);
 
-  m_buffer.add(packet->data->get_buffer(), packet->data->get_size());
+  // Readers that know the packet size deliver exactly one packet's
+  // worth of data per call. Such buffers are passed on as they are.
+  if (!m_buffer.get_size() && (packet->data->get_size() == m_packet_size)) {
+    add_pcm_packet(packet->data);
+    return FILE_STATUS_MOREDATA;
+  }
+
+  auto data  = packet->data->get_buffer();
+  auto size  = packet->data->get_size();
+  size_t pos = 0;
+
+  // Complete a packet left over from the previous call first. Whole
+  // packets are then copied straight out of the input, and only the
+  // remainder is kept for the next call.
+  if (m_buffer.get_size()) {
+    auto to_copy = std::min<size_t>(size, m_packet_size - m_buffer.get_size());
+    m_buffer.add(data, to_copy);
+    pos += to_copy;
 
-  while (m_buffer.get_size() >= m_packet_size) {
-    add_packet(new packet_t(memory_c::clone(m_buffer.get_buffer(), m_packet_size), m_samples_output * m_s2tc, m_samples_per_packet * m_s2tc));
+    if (m_buffer.get_size() < m_packet_size)
+      return FILE_STATUS_MOREDATA;
+
+    add_pcm_packet(memory_c::clone(m_buffer.get_buffer(), m_packet_size));
+    m_buffer.clear();
+  }
 
-    m_buffer.remove(m_packet_size);
-    m_samples_output += m_samples_per_packet;
+  while ((size - pos) >= m_packet_size) {
+    add_pcm_packet(memory_c::clone(data + pos, m_packet_size));
+    pos += m_packet_size;
   }
 
+  if (pos < size)
+    m_buffer.add(data + pos, size - pos);
+
   return FILE_STATUS_MOREDATA;
 }
 
+void
+pcm_packetizer_c::add_pcm_packet(memory_cptr const &data) {
+  add_packet(new packet_t(data, m_samples_output * m_s2tc, m_samples_per_packet * m_s2tc));
+  m_samples_output += m_samples_per_packet;
+}
+
 int
 pcm_packetizer_c::process_packaged(packet_cptr packet) {
   int64_t samples_here = m_buffer.get_size() * 8 / m_channels / m_bits_per_sample;
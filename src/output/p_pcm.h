@@ -35,6 +35,10 @@ public:
   virtual int process(packet_cptr packet);
   virtual void set_headers();
 
+  size_t get_packet_size() const {
+    return m_packet_size;
+  }
+
   virtual translatable_string_c get_format_name() const {
     return YT("PCM");
   }
@@ -42,6 +46,7 @@ public:
 
 protected:
   virtual int process_packaged(packet_cptr packet);
+  virtual void add_pcm_packet(memory_cptr const &data);
   virtual void flush_impl();
 };
 
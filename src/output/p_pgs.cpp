@@ -26,9 +26,11 @@ pgs_packetizer_c::pgs_packetizer_c(generic_reader_c *p_reader,
                                    track_info_c &p_ti)
   : generic_packetizer_c(p_reader, p_ti)
   , m_aggregate_packets(false)
+  , m_aggregated_size(0)
 {
   set_track_type(track_subtitle);
   set_default_compression_method(COMPRESSION_ZLIB);
+  enable_background_compression();
 }
 
 pgs_packetizer_c::~pgs_packetizer_c() {
@@ -50,17 +52,34 @@ pgs_packetizer_c::process(packet_cptr packet) {
     return FILE_STATUS_MOREDATA;
   }
 
-  if (!m_aggregated) {
+  if (!m_aggregated)
     m_aggregated = packet;
-    m_aggregated->data->grab();
 
-  } else
-    m_aggregated->data->add(packet->data);
+  // Only remember the segments for now and join them once the display
+  // set is complete instead of growing the buffer with each segment.
+  packet->data->grab();
+  m_aggregated_segments.push_back(packet->data);
+  m_aggregated_size += packet->data->get_size();
 
   if (   (0                      != packet->data->get_size())
       && (PGSSUP_DISPLAY_SEGMENT == packet->data->get_buffer()[0])) {
+    if (1 < m_aggregated_segments.size()) {
+      auto data   = memory_c::alloc(m_aggregated_size);
+      auto buffer = data->get_buffer();
+
+      for (auto &segment : m_aggregated_segments) {
+        memcpy(buffer, segment->get_buffer(), segment->get_size());
+        buffer += segment->get_size();
+      }
+
+      m_aggregated->data = data;
+    }
+
     add_packet(m_aggregated);
+
     m_aggregated.reset();
+    m_aggregated_segments.clear();
+    m_aggregated_size = 0;
   }
 
   return FILE_STATUS_MOREDATA;
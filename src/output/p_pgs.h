@@ -23,6 +23,8 @@ class pgs_packetizer_c: public generic_packetizer_c {
 protected:
   bool m_aggregate_packets;
   packet_cptr m_aggregated;
+  std::vector<memory_cptr> m_aggregated_segments;
+  size_t m_aggregated_size;
 
 public:
   pgs_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti);
@@ -29,6 +29,7 @@ vobsub_packetizer_c::vobsub_packetizer_c(generic_reader_c *reader,
 {
   set_track_type(track_subtitle);
   set_default_compression_method(COMPRESSION_ZLIB);
+  enable_background_compression();
 }
 
 vobsub_packetizer_c::~vobsub_packetizer_c() {
@@ -14,6 +14,7 @@
 #include <matroska/KaxTag.h>
 #include <matroska/KaxTags.h>
 
+#include "common/strings/parsing.h"
 #include "propedit/chapter_target.h"
 #include "propedit/options.h"
 #include "propedit/propedit.h"
@@ -23,6 +24,8 @@
 
 options_c::options_c()
   : m_show_progress(false)
+  , m_use_index_cache(false)
+  , m_num_jobs(1)
   , m_parse_mode(kax_analyzer_c::parse_mode_fast)
 {
 }
@@ -97,10 +100,41 @@ options_c::add_attachment_command(attachment_target_c::command_e command,
 
 void
 options_c::set_file_name(const std::string &file_name) {
-  if (!m_file_name.empty())
-    mxerror(boost::format(Y("More than one file name has been given ('%1%' and '%2%').\n")) % m_file_name % file_name);
+  static boost::regex s_matroska_extension_re("\\.(mkv|mka|mks|mk3d|webm)$", boost::regex::perl | boost::regex::icase);
 
-  m_file_name = file_name;
+  if (!boost::filesystem::is_directory(file_name))
+    m_file_names.push_back(file_name);
+
+  else {
+    // All Matroska files in a directory are processed in batch mode.
+    std::vector<std::string> directory_file_names;
+    for (boost::filesystem::directory_iterator entry(file_name), end; entry != end; ++entry)
+      if (   boost::filesystem::is_regular_file(entry->path())
+          && boost::regex_search(entry->path().filename().string(), s_matroska_extension_re))
+        directory_file_names.push_back(entry->path().string());
+
+    if (directory_file_names.empty())
+      mxerror(boost::format(Y("The directory '%1%' does not contain any Matroska files.\n")) % file_name);
+
+    brng::sort(directory_file_names);
+    m_file_names.insert(m_file_names.end(), directory_file_names.begin(), directory_file_names.end());
+  }
+
+  if (m_file_name.empty())
+    m_file_name = m_file_names.front();
+}
+
+bool
+options_c::is_batch_mode()
+  const
+{
+  return 1 < m_file_names.size();
+}
+
+void
+options_c::set_num_jobs(const std::string &num_jobs) {
+  if (!parse_number(num_jobs, m_num_jobs) || !m_num_jobs)
+    throw false;
 }
 
 void
@@ -122,10 +156,14 @@ options_c::dump_info()
   mxinfo(boost::format("options:\n"
                        "  file_name:     %1%\n"
                        "  show_progress: %2%\n"
-                       "  parse_mode:    %3%\n")
+                       "  parse_mode:    %3%\n"
+                       "  num_files:     %4%\n"
+                       "  num_jobs:      %5%\n")
          % m_file_name
          % m_show_progress
-         % static_cast<int>(m_parse_mode));
+         % static_cast<int>(m_parse_mode)
+         % m_file_names.size()
+         % m_num_jobs);
 
   for (auto &target : m_targets)
     target->dump_info();
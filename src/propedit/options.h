@@ -22,8 +22,10 @@
 class options_c {
 public:
   std::string m_file_name;
+  std::vector<std::string> m_file_names, m_action_args;
   std::vector<target_cptr> m_targets;
-  bool m_show_progress;
+  bool m_show_progress, m_use_index_cache;
+  unsigned int m_num_jobs;
   kax_analyzer_c::parse_mode_e m_parse_mode;
 
 public:
@@ -38,6 +40,8 @@ public:
   void add_attachment_command(attachment_target_c::command_e command, std::string const &spec, attachment_target_c::options_t const &options);
   void set_file_name(const std::string &file_name);
   void set_parse_mode(const std::string &parse_mode);
+  void set_num_jobs(const std::string &num_jobs);
+  bool is_batch_mode() const;
   void dump_info() const;
   bool has_changes() const;
 
@@ -10,6 +10,14 @@
 
 #include "common/common_pch.h"
 
+#if !defined(SYS_WINDOWS)
+# include <errno.h>
+# include <signal.h>
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
 #include <matroska/KaxChapters.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxTags.h>
@@ -17,10 +25,27 @@
 
 #include "common/command_line.h"
 #include "common/mm_io_x.h"
+#include "common/strings/editing.h"
 #include "common/unique_numbers.h"
 #include "common/version.h"
 #include "propedit/propedit_cli_parser.h"
 
+namespace {
+
+class batch_file_failed_x: public mtx::exception {
+protected:
+  std::string m_message;
+public:
+  batch_file_failed_x(std::string const &message) : m_message(message) { }
+  virtual ~batch_file_failed_x() throw() { }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+}
+
 static void
 display_update_element_result(const EbmlCallbacks &callbacks,
                               kax_analyzer_c::update_element_result_e result) {
@@ -79,8 +104,9 @@ write_changes(options_cptr &options,
 }
 
 static void
-run(options_cptr &options) {
+process_file(options_cptr &options) {
   console_kax_analyzer_cptr analyzer;
+  bool show_info = !options->is_batch_mode();
 
   try {
     if (!kax_analyzer_c::probe(options->m_file_name))
@@ -91,9 +117,13 @@ run(options_cptr &options) {
     mxerror(boost::format("The file '%1%' could not be opened for reading and writing: %1.\n") % options->m_file_name % ex);
   }
 
-  mxinfo(boost::format("%1%\n") % Y("The file is being analyzed."));
+  if (show_info)
+    mxinfo(boost::format("%1%\n") % Y("The file is being analyzed."));
+
+  analyzer->set_show_progress(options->m_show_progress && show_info);
 
-  analyzer->set_show_progress(options->m_show_progress);
+  if (options->m_use_index_cache)
+    analyzer->enable_index_cache();
 
   bool ok = false;
   try {
@@ -116,15 +146,290 @@ run(options_cptr &options) {
 
   options->execute();
 
-  mxinfo(Y("The changes are written to the file.\n"));
+  if (show_info)
+    mxinfo(Y("The changes are written to the file.\n"));
 
   write_changes(options, analyzer.get());
 
+  if (options->m_use_index_cache) {
+    analyzer->close_file();
+    analyzer->save_index_cache();
+  }
+}
+
+static void
+run(options_cptr &options) {
+  process_file(options);
+
   mxinfo(Y("Done.\n"));
 
   mxexit(0);
 }
 
+/** \brief Applies the changes to a single file in batch mode
+
+   Processing a file modifies the targets. Therefore each file starts
+   with fresh targets: only the actions recorded while parsing the
+   command line are parsed again together with the file's name, not
+   the whole list of file names.
+
+   Errors are reported via exceptions instead of terminating the
+   program (see \c run_batch()). All of them are caught here so that a
+   problem with one file only fails that file.
+*/
+static bool
+process_file_in_batch(options_cptr const &batch_options,
+                      std::string const &file_name) {
+  std::string error;
+
+  try {
+    clear_list_of_unique_numbers(UNIQUE_ALL_IDS);
+
+    auto args = batch_options->m_action_args;
+    args.push_back(file_name);
+
+    auto options         = propedit_cli_parser_c(args).run();
+    options->m_file_name = file_name;
+
+    process_file(options);
+
+    return true;
+
+  } catch (batch_file_failed_x &ex) {
+    error = ex.what();
+
+  } catch (mtx::exception &ex) {
+    error = ex.error();
+
+  } catch (std::exception &ex) {
+    error = ex.what();
+
+  } catch (...) {
+    error = Y("An unknown error occured.");
+  }
+
+  strip_back(error, true);
+  mxmsg(MXMSG_ERROR, (boost::format(Y("'%1%': %2%\n")) % file_name % error).str());
+
+  return false;
+}
+
+#if !defined(SYS_WINDOWS)
+static bool
+read_from_pipe(int fd,
+               void *buffer,
+               size_t size) {
+  auto dst = static_cast<unsigned char *>(buffer);
+
+  while (size) {
+    auto num_read = read(fd, dst, size);
+    if ((0 > num_read) && (EINTR == errno))
+      continue;
+    if (0 >= num_read)
+      return false;
+
+    dst  += num_read;
+    size -= num_read;
+  }
+
+  return true;
+}
+
+static bool
+write_to_pipe(int fd,
+              void const *buffer,
+              size_t size) {
+  auto src = static_cast<unsigned char const *>(buffer);
+
+  while (size) {
+    auto num_written = write(fd, src, size);
+    if ((0 > num_written) && (EINTR == errno))
+      continue;
+    if (0 >= num_written)
+      return false;
+
+    src  += num_written;
+    size -= num_written;
+  }
+
+  return true;
+}
+
+/** \brief Processes files in a worker process
+
+   Reads the indexes of the files to process from \c task_fd until the
+   parent closes it and reports the result for each file via \c
+   result_fd. A result consists of the worker's number, the file's
+   index and 1 for success or 0 for failure. It's small enough to be
+   written atomically even though all workers share that pipe.
+*/
+static void
+run_batch_worker(options_cptr const &options,
+                 uint32_t worker,
+                 int task_fd,
+                 int result_fd) {
+  uint32_t idx = 0;
+
+  while (read_from_pipe(task_fd, &idx, sizeof(idx))) {
+    uint32_t result[3] = { worker, idx, process_file_in_batch(options, options->m_file_names[idx]) ? 1u : 0u };
+
+    g_mm_stdio->flush();
+
+    if (!write_to_pipe(result_fd, result, sizeof(result)))
+      break;
+  }
+
+  mxexit(0);
+}
+
+/** \brief Processes the files with a pool of worker processes
+
+   The workers are forked once from the already initialized program.
+   This avoids the start-up costs while keeping the global state of
+   the batch separate from the parent's. The parent hands out the next
+   file whenever a worker reports a result. Files whose worker dies
+   without reporting a result are counted as failed.
+
+   \returns \c false if no worker could be started. The caller
+     processes the files itself in that case.
+*/
+static bool
+run_batch_with_workers(options_cptr const &options,
+                       std::function<void(size_t, bool)> const &report) {
+  auto &file_names = options->m_file_names;
+  int result_pipe[2];
+
+  if (0 != pipe(result_pipe))
+    return false;
+
+  signal(SIGPIPE, SIG_IGN);
+
+  std::vector<int> task_fds;
+  auto num_workers = std::min<size_t>(options->m_num_jobs, file_names.size());
+
+  while (task_fds.size() < num_workers) {
+    int task_pipe[2];
+    if (0 != pipe(task_pipe))
+      break;
+
+    g_mm_stdio->flush();
+
+    pid_t pid = fork();
+    if (0 == pid) {
+      close(task_pipe[1]);
+      close(result_pipe[0]);
+      for (auto fd : task_fds)
+        close(fd);
+
+      run_batch_worker(options, task_fds.size(), task_pipe[0], result_pipe[1]);
+    }
+
+    close(task_pipe[0]);
+
+    if (0 > pid) {
+      close(task_pipe[1]);
+      break;
+    }
+
+    task_fds.push_back(task_pipe[1]);
+  }
+
+  close(result_pipe[1]);
+
+  if (task_fds.empty()) {
+    close(result_pipe[0]);
+    return false;
+  }
+
+  std::vector<boost::optional<size_t>> in_progress(task_fds.size());
+  size_t next_idx = 0;
+
+  auto hand_out_next_file = [&](size_t worker) {
+    uint32_t idx = next_idx;
+    if ((next_idx < file_names.size()) && write_to_pipe(task_fds[worker], &idx, sizeof(idx))) {
+      in_progress[worker] = idx;
+      ++next_idx;
+      return;
+    }
+
+    close(task_fds[worker]);
+    task_fds[worker] = -1;
+  };
+
+  for (size_t worker = 0; worker < task_fds.size(); ++worker)
+    hand_out_next_file(worker);
+
+  uint32_t result[3];
+  while (read_from_pipe(result_pipe[0], result, sizeof(result))) {
+    auto worker = result[0];
+    if ((worker >= task_fds.size()) || !in_progress[worker] || (*in_progress[worker] != result[1]))
+      continue;
+
+    in_progress[worker].reset();
+    report(result[1], 1 == result[2]);
+    hand_out_next_file(worker);
+  }
+
+  close(result_pipe[0]);
+
+  // All workers have exited once the result pipe has been closed on
+  // their side.
+  for (size_t worker = 0; worker < task_fds.size(); ++worker) {
+    if (in_progress[worker])
+      report(*in_progress[worker], false);
+    if (-1 != task_fds[worker])
+      close(task_fds[worker]);
+  }
+
+  while ((0 < waitpid(-1, nullptr, 0)) || (EINTR == errno))
+    ;
+
+  // Files that couldn't be handed out because their worker had died
+  // already are processed here.
+  for (; next_idx < file_names.size(); ++next_idx)
+    report(next_idx, process_file_in_batch(options, file_names[next_idx]));
+
+  return true;
+}
+#endif  // !SYS_WINDOWS
+
+static void
+run_batch(options_cptr &options) {
+  set_mxmsg_handler(MXMSG_ERROR, [](unsigned int, std::string const &error) { throw batch_file_failed_x{error}; });
+
+  auto &file_names  = options->m_file_names;
+  size_t num_failed = 0;
+
+  auto report = [&file_names, &num_failed](size_t idx, bool ok) {
+    mxinfo(boost::format(Y("'%1%': %2%\n")) % file_names[idx] % (ok ? Y("done") : Y("failed")));
+    if (!ok)
+      ++num_failed;
+  };
+
+#if defined(SYS_WINDOWS)
+  if (1 < options->m_num_jobs) {
+    mxwarn(Y("Processing files in parallel is not supported on Windows. The files will be processed one after the other.\n"));
+    options->m_num_jobs = 1;
+  }
+#endif
+
+  mxinfo(boost::format(Y("Applying the changes to %1% files using %2% parallel job(s).\n")) % file_names.size() % options->m_num_jobs);
+
+  auto processed_by_workers = false;
+#if !defined(SYS_WINDOWS)
+  if (1 < options->m_num_jobs)
+    processed_by_workers = run_batch_with_workers(options, report);
+#endif
+
+  if (!processed_by_workers)
+    for (size_t idx = 0; idx < file_names.size(); ++idx)
+      report(idx, process_file_in_batch(options, file_names[idx]));
+
+  mxinfo(boost::format(Y("%1% file(s) processed successfully, %2% file(s) failed.\n")) % (file_names.size() - num_failed) % num_failed);
+
+  mxexit(num_failed ? 2 : 0);
+}
+
 static
 void setup() {
   mtx_common_init("mkvpropedit");
@@ -143,14 +448,18 @@ main(int argc,
      char **argv) {
   setup();
 
-  options_cptr options = propedit_cli_parser_c(command_line_utf8(argc, argv)).run();
+  auto args             = command_line_utf8(argc, argv);
+  options_cptr options = propedit_cli_parser_c(args).run();
 
   if (debugging_requested("dump_options")) {
     mxinfo("\nDumping options after parsing the command line\n\n");
     options->dump_info();
   }
 
-  run(options);
+  if (options->is_batch_mode())
+    run_batch(options);
+  else
+    run(options);
 
   mxexit();
 }
@@ -34,6 +34,20 @@ propedit_cli_parser_c::set_parse_mode() {
   }
 }
 
+void
+propedit_cli_parser_c::set_num_jobs() {
+  try {
+    m_options->set_num_jobs(m_next_arg);
+  } catch (...) {
+    mxerror(boost::format(Y("Invalid number of jobs in '%1% %2%'.\n")) % m_current_arg % m_next_arg);
+  }
+}
+
+void
+propedit_cli_parser_c::set_index_cache() {
+  m_options->m_use_index_cache = true;
+}
+
 void
 propedit_cli_parser_c::add_target() {
   try {
@@ -180,6 +194,7 @@ propedit_cli_parser_c::list_property_names_for_table(const std::vector<property_
 void
 propedit_cli_parser_c::set_file_name() {
   m_options->set_file_name(m_current_arg);
+  m_file_name_arg_indexes.push_back(m_current_arg_idx);
 }
 
 #define OPT(spec, func, description) add_option(spec, std::bind(&propedit_cli_parser_c::func, this), description)
@@ -187,10 +202,14 @@ propedit_cli_parser_c::set_file_name() {
 void
 propedit_cli_parser_c::init_parser() {
   add_information(YT("mkvpropedit [options] <file> <actions>"));
+  add_information(YT("mkvpropedit [options] <file1|directory1> [<file2|directory2> ...] <actions>"));
 
   add_section_header(YT("Options"));
   OPT("l|list-property-names",      list_property_names, YT("List all valid property names and exit"));
   OPT("p|parse-mode=<mode>",        set_parse_mode,      YT("Sets the Matroska parser mode to 'fast' (default) or 'full'"));
+  OPT("index-cache",                set_index_cache,     YT("Keep the positions of the file's level 1 elements in a cache file next to it "
+                                                            "('<file>.mtxidx') so that repeated edits do not have to scan the file again"));
+  OPT("j|jobs=<n>",                 set_num_jobs,        YT("Process up to 'n' files in parallel if more than one file or a directory has been given (default: 1). Not supported on Windows where the files are always processed one after the other."));
 
   add_section_header(YT("Actions for handling properties"));
   OPT("e|edit=<selector>",          add_target,          YT("Sets the Matroska file section that all following add/set/delete "
@@ -220,6 +239,8 @@ propedit_cli_parser_c::init_parser() {
 
   add_separator();
   add_information(YT("The order of the various options is not important."));
+  add_information(YT("If more than one file name or a directory is given then the same actions are applied to each file (batch mode). "
+                     "All Matroska files directly inside a given directory are processed."));
 
   add_section_header(YT("Edit selectors for properties"), 0);
   add_section_header(YT("Segment information"), 1);
@@ -261,6 +282,16 @@ propedit_cli_parser_c::run() {
   parse_args();
   validate();
 
+  // Batch mode parses the actions again for each file without
+  // expanding all file names and directories each time.
+  auto file_name_idx = m_file_name_arg_indexes.begin();
+  for (size_t idx = 0; m_args.size() > idx; ++idx) {
+    if ((m_file_name_arg_indexes.end() != file_name_idx) && (*file_name_idx == idx))
+      ++file_name_idx;
+    else
+      m_options->m_action_args.push_back(m_args[idx]);
+  }
+
   m_options->options_parsed();
   m_options->validate();
 
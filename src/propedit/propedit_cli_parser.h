@@ -22,6 +22,7 @@ protected:
   options_cptr m_options;
   target_cptr m_target;
   attachment_target_c::options_t m_attachment;
+  std::vector<size_t> m_file_name_arg_indexes;
 
 public:
   propedit_cli_parser_c(const std::vector<std::string> &args);
@@ -37,6 +38,8 @@ protected:
   void add_tags();
   void add_chapters();
   void set_parse_mode();
+  void set_index_cache();
+  void set_num_jobs();
   void set_file_name();
 
   void set_attachment_name();
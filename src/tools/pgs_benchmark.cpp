@@ -0,0 +1,324 @@
+/*
+   pgs_benchmark - Measure how fast PGS subtitles are compressed and muxed
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <chrono>
+
+#include "common/compression.h"
+#include "common/endian.h"
+#include "common/fs_sys_helpers.h"
+#include "common/mm_io.h"
+#include "common/pgssup.h"
+#include "common/strings/parsing.h"
+#include "common/thread_pool.h"
+#include "common/translation.h"
+
+static unsigned int g_opt_num_tracks       = 40;
+static unsigned int g_opt_num_display_sets = 250;
+static unsigned int g_opt_num_threads      = 0;
+static std::string g_opt_mkvmerge;
+
+static void
+show_help() {
+  mxinfo("pgs_benchmark [options]\n"
+         "\n"
+         "Creates synthetic PGS display sets for a number of tracks and compresses\n"
+         "them with zlib once on the calling thread and once with a thread pool\n"
+         "the way mkvmerge does.\n"
+         "\n"
+         "With '--mkvmerge' the display sets are also written to one .sup file per\n"
+         "track. They're muxed by the given mkvmerge executable once with and once\n"
+         "without background compression. This measures the whole muxing path\n"
+         "including reading, packet assembly and writing.\n"
+         "\n"
+         "Options:\n"
+         "\n"
+         "  -t, --tracks <n>         Number of tracks (default: 40)\n"
+         "  -d, --display-sets <n>   Number of display sets per track (default: 250)\n"
+         "  -j, --threads <n>        Number of worker threads (default: one per core)\n"
+         "  -m, --mkvmerge <path>    Also time muxing the tracks with this mkvmerge\n"
+         "\n"
+         "General options:\n"
+         "\n"
+         "  -h, --help               This help text\n"
+         "  -V, --version            Print version information\n");
+  mxexit(0);
+}
+
+static void
+show_version() {
+  mxinfo("pgs_benchmark v" VERSION "\n");
+  mxexit(0);
+}
+
+static unsigned int
+parse_count(std::vector<std::string> const &args,
+            size_t &idx) {
+  unsigned int value;
+
+  if (((idx + 1) >= args.size()) || !parse_number(args[idx + 1], value))
+    mxerror(boost::format(Y("Missing or invalid argument to '%1%'.\n")) % args[idx]);
+
+  ++idx;
+
+  return value;
+}
+
+static void
+parse_args(std::vector<std::string> const &args) {
+  for (size_t idx = 0; idx < args.size(); ++idx) {
+    auto &arg = args[idx];
+
+    if ((arg == "-h") || (arg == "--help"))
+      show_help();
+
+    else if ((arg == "-V") || (arg == "--version"))
+      show_version();
+
+    else if ((arg == "-t") || (arg == "--tracks"))
+      g_opt_num_tracks = std::max(parse_count(args, idx), 1u);
+
+    else if ((arg == "-d") || (arg == "--display-sets"))
+      g_opt_num_display_sets = std::max(parse_count(args, idx), 1u);
+
+    else if ((arg == "-j") || (arg == "--threads"))
+      g_opt_num_threads = parse_count(args, idx);
+
+    else if ((arg == "-m") || (arg == "--mkvmerge")) {
+      if ((idx + 1) >= args.size())
+        mxerror(boost::format(Y("Missing or invalid argument to '%1%'.\n")) % arg);
+      g_opt_mkvmerge = args[++idx];
+    }
+
+    else
+      mxerror(boost::format(Y("Unknown option '%1%'.\n")) % arg);
+  }
+}
+
+static memory_cptr
+create_segment(unsigned char type,
+               std::string const &payload) {
+  auto segment = memory_c::alloc(3 + payload.size());
+  auto buffer  = segment->get_buffer();
+
+  buffer[0] = type;
+  put_uint16_be(&buffer[1], payload.size());
+  memcpy(&buffer[3], payload.c_str(), payload.size());
+
+  return segment;
+}
+
+static void
+add_run(std::string &rle,
+        unsigned int color,
+        unsigned int length) {
+  if (!color && (64 > length))
+    rle += std::string{ '\0', static_cast<char>(length) };
+
+  else if (!color)
+    rle += std::string{ '\0', static_cast<char>(0x40 | (length >> 8)), static_cast<char>(length & 0xff) };
+
+  else if (3 > length)
+    rle += std::string(length, static_cast<char>(color));
+
+  else if (64 > length)
+    rle += std::string{ '\0', static_cast<char>(0x80 | length), static_cast<char>(color) };
+
+  else
+    rle += std::string{ '\0', static_cast<char>(0xc0 | (length >> 8)), static_cast<char>(length & 0xff), static_cast<char>(color) };
+}
+
+// A display set looks roughly like one line of rendered text: a
+// transparent frame with runs of outline and fill colors in the
+// middle. The run lengths vary from set to set so that the zlib
+// compressor sees realistic data instead of repeating patterns.
+static std::vector<memory_cptr>
+create_display_set(unsigned int seed) {
+  unsigned int const width = 1920, height = 120;
+
+  std::string rle;
+  for (auto line = 0u; line < height; ++line) {
+    auto position = 0u;
+
+    while (position < width) {
+      seed        = seed * 1103515245 + 12345;
+      auto length = std::min<unsigned int>(1 + (seed >> 16) % ((line % 3) ? 24 : 300), width - position);
+      auto color  = (position < 200) || (position > (width - 200)) ? 0 : (seed >> 8) % 4;
+
+      add_run(rle, color, length);
+      position += length;
+    }
+
+    rle += std::string(2, '\0');
+  }
+
+  std::vector<memory_cptr> segments;
+  segments.push_back(create_segment(PGSSUP_PRESENTATION_SEGMENT, std::string(19, '\x01')));
+  segments.push_back(create_segment(PGSSUP_WINDOW_SEGMENT,       std::string(10, '\x02')));
+  segments.push_back(create_segment(PGSSUP_PALETTE_SEGMENT,      std::string(2 + 4 * 5, '\x80')));
+  segments.push_back(create_segment(PGSSUP_PICTURE_SEGMENT,      std::string(11, '\0') + rle));
+  segments.push_back(create_segment(PGSSUP_DISPLAY_SEGMENT,      std::string{}));
+
+  return segments;
+}
+
+static memory_cptr
+aggregate(std::vector<memory_cptr> const &segments) {
+  auto size = 0u;
+  for (auto &segment : segments)
+    size += segment->get_size();
+
+  auto data   = memory_c::alloc(size);
+  auto buffer = data->get_buffer();
+
+  for (auto &segment : segments) {
+    memcpy(buffer, segment->get_buffer(), segment->get_size());
+    buffer += segment->get_size();
+  }
+
+  return data;
+}
+
+static double
+seconds_since(std::chrono::steady_clock::time_point const &start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Writes each track's display sets to its own PGS elementary stream
+// file. Display sets are one second apart.
+static std::vector<std::string>
+write_sup_files(std::vector<std::vector<memory_cptr>> const &display_sets,
+                bfs::path const &directory) {
+  std::vector<std::string> file_names;
+  std::vector<mm_io_cptr> files;
+
+  for (auto track_idx = 0u; track_idx < g_opt_num_tracks; ++track_idx) {
+    file_names.push_back((directory / (boost::format("track-%1%.sup") % track_idx).str()).string());
+    files.push_back(mm_file_io_c::open(file_names.back(), MODE_CREATE));
+  }
+
+  for (auto idx = 0u; idx < display_sets.size(); ++idx) {
+    auto &file   = *files[idx % g_opt_num_tracks];
+    uint32_t pts = (idx / g_opt_num_tracks) * 90000;
+
+    for (auto &segment : display_sets[idx]) {
+      file.write_uint16_be(PGSSUP_FILE_MAGIC);
+      file.write_uint32_be(pts);
+      file.write_uint32_be(0);
+      file.write(segment);
+    }
+  }
+
+  return file_names;
+}
+
+static double
+time_mkvmerge(std::vector<std::string> const &sup_files,
+              bfs::path const &output_file_name,
+              std::string const &extra_args) {
+  auto command = (boost::format("\"%1%\" -q %2% -o \"%3%\"") % g_opt_mkvmerge % extra_args % output_file_name.string()).str();
+  for (auto &file_name : sup_files)
+    command += " \"" + file_name + "\"";
+
+  auto start  = std::chrono::steady_clock::now();
+  auto result = mtx::system(command);
+
+  if (0 != result)
+    mxerror(boost::format(Y("Running '%1%' failed (result %2%).\n")) % command % result);
+
+  return seconds_since(start);
+}
+
+static void
+run_mkvmerge_benchmark(std::vector<std::vector<memory_cptr>> const &display_sets) {
+  auto directory = bfs::temp_directory_path() / bfs::unique_path("pgs_benchmark-%%%%-%%%%-%%%%");
+  bfs::create_directories(directory);
+
+  auto sup_files         = write_sup_files(display_sets, directory);
+  auto output_file_name  = directory / "output.mkv";
+
+  auto serial_duration   = time_mkvmerge(sup_files, output_file_name, "--debug no_background_compression");
+  auto serial_size       = bfs::file_size(output_file_name);
+  auto parallel_duration = time_mkvmerge(sup_files, output_file_name, "");
+  auto parallel_size     = bfs::file_size(output_file_name);
+
+  boost::system::error_code ec;
+  bfs::remove_all(directory, ec);
+
+  if (serial_size != parallel_size)
+    mxerror(Y("The files muxed with and without background compression differ in size.\n"));
+
+  mxinfo(boost::format("mkvmerge without background compression: %|1$.3f|s\n") % serial_duration);
+  mxinfo(boost::format("mkvmerge with background compression:    %|1$.3f|s, speedup %|2$.2f|\n") % parallel_duration % (serial_duration / parallel_duration));
+}
+
+static void
+run_benchmark() {
+  // Interleave the tracks the same way the muxer sees them.
+  std::vector<std::vector<memory_cptr>> display_sets;
+  uint64_t total_size = 0;
+
+  for (auto set_idx = 0u; set_idx < g_opt_num_display_sets; ++set_idx)
+    for (auto track_idx = 0u; track_idx < g_opt_num_tracks; ++track_idx) {
+      display_sets.push_back(create_display_set(set_idx * g_opt_num_tracks + track_idx));
+      for (auto &segment : display_sets.back())
+        total_size += segment->get_size();
+    }
+
+  mxinfo(boost::format("%1% tracks, %2% display sets, %3% bytes\n") % g_opt_num_tracks % display_sets.size() % total_size);
+
+  auto compressor = compressor_c::create(COMPRESSION_ZLIB);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<memory_cptr> serial;
+  uint64_t compressed_size = 0;
+
+  for (auto &display_set : display_sets) {
+    serial.push_back(compressor->compress(aggregate(display_set)));
+    compressed_size += serial.back()->get_size();
+  }
+
+  auto serial_duration = seconds_since(start);
+  mxinfo(boost::format("serial:   %|1$.3f|s (%|2$.1f| MB/s), compressed to %3% bytes\n") % serial_duration % (total_size / serial_duration / 1048576) % compressed_size);
+
+  thread_pool_c pool(g_opt_num_threads);
+
+  start = std::chrono::steady_clock::now();
+  std::deque<std::future<memory_cptr>> pending;
+
+  for (auto &display_set : display_sets) {
+    auto data = aggregate(display_set);
+    pending.push_back(pool.enqueue(std::function<memory_cptr()>{[compressor, data]() { return compressor->compress(data); }}));
+  }
+
+  auto idx = 0u;
+  for (auto &result : pending)
+    if (*result.get() != *serial[idx++])
+      mxerror(Y("The results of serial and parallel compression differ.\n"));
+
+  auto parallel_duration = seconds_since(start);
+  mxinfo(boost::format("parallel: %|1$.3f|s (%|2$.1f| MB/s) with %3% threads, speedup %|4$.2f|\n")
+         % parallel_duration % (total_size / parallel_duration / 1048576) % pool.get_num_threads() % (serial_duration / parallel_duration));
+
+  if (!g_opt_mkvmerge.empty())
+    run_mkvmerge_benchmark(display_sets);
+}
+
+int
+main(int argc,
+     char **argv) {
+  mtx_common_init("pgs_benchmark");
+
+  parse_args(command_line_utf8(argc, argv));
+  run_benchmark();
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/ruby -w
+
+# T_396mkvinfo_fast_scan
+describe "mkvinfo / --fast-scan shows the same elements and statistics as the normal mode"
+
+# Cluster children that the fast scan mode doesn't parse itself must be
+# shown anyway: ClusterPosition, PrevSize, SilentTracks, EbmlVoid and
+# block groups with ReferencePriority, BlockAdditions and Slices.
+ebml = lambda do |id, *children|
+  content = children.join('')
+  [ id ].pack('H*') + [ 0x0100000000000000 | content.bytesize ].pack('Q>') + content
+end
+
+uint  = lambda { |id, value| ebml.call(id, [ value ].pack('Q>').sub(/^\0+(?=.)/m, '')) }
+block = lambda { |id, track, timecode, flags, data| ebml.call(id, [ 0x80 | track, timecode, flags ].pack('Cs>C'), data) }
+
+file_name = "#{tmp}-all-cluster-children.mkv"
+
+setup do
+  cluster = ebml.call('1f43b675',
+                      uint.call('e7', 1000),
+                      uint.call('a7', 0),
+                      uint.call('ab', 0),
+                      ebml.call('5854', uint.call('58d7', 2)),
+                      block.call('a3', 1, 0, 0x80, 'simple'),
+                      ebml.call('a0', block.call('a1', 1, 40, 0, 'group'), uint.call('9b', 40), uint.call('fa', 1), ebml.call('fb', [ 0xd8 ].pack('C'))),
+                      ebml.call('a0',
+                                block.call('a1', 2, 80, 0, 'additions'),
+                                ebml.call('75a1', ebml.call('a6', uint.call('ee', 1), ebml.call('a5', 'more'))),
+                                ebml.call('8e',   ebml.call('e8', uint.call('cc', 0), uint.call('cd', 0)))),
+                      ebml.call('ec', "\0" * 4),
+                      block.call('a3', 2, 120, 0x81, 'discardable'))
+
+  tracks = [ 1, 2 ].collect { |num| ebml.call('ae', uint.call('d7', num), uint.call('73c5', num), uint.call('83', 0x11), ebml.call('86', 'S_TEXT/UTF8')) }
+
+  File.open(file_name, 'wb') do |file|
+    file.write ebml.call('1a45dfa3', uint.call('4286', 1), uint.call('42f7', 1), uint.call('42f2', 4), uint.call('42f3', 8), ebml.call('4282', 'matroska'), uint.call('4287', 2), uint.call('4285', 2))
+    file.write ebml.call('18538067',
+                         ebml.call('1549a966', uint.call('2ad7b1', 1000000), ebml.call('4d80', 'test'), ebml.call('5741', 'test')),
+                         ebml.call('1654ae6b', *tracks),
+                         cluster)
+  end
+end
+
+expected_elements = [ 'Cluster position', 'Cluster previous size', 'Silent Track Number', 'Reference priority', 'Additions', 'Slices', 'EbmlVoid' ]
+
+[ '-v -v -v -t', '-s -t', '-s -v' ].each do |args|
+  test "#{args} #{file_name}" do
+    normal = info("#{args} #{file_name}",             :output => :return).join('')
+    fast   = info("--fast-scan #{args} #{file_name}", :output => :return).join('')
+
+    # Checksums are only calculated in the normal mode.
+    normal.gsub!(/, adler 0x\h{8}/, '')
+
+    shown = /-s/.match(args) || expected_elements.all? { |element| fast.include? element }
+
+    [ normal == fast ? 'ok' : 'BAD', shown ? 'ok' : 'BAD' ].join('+')
+  end
+end
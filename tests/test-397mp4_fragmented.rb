@@ -0,0 +1,95 @@
+#!/usr/bin/ruby -w
+
+# T_397mp4_fragmented
+describe "mkvmerge / fragmented MP4 files"
+
+# A fragmented file with one 16bit stereo PCM track. The second
+# fragment contains data of an unknown track in front of the PCM
+# samples whose position must therefore be derived from the end of
+# the previous track fragment's data. The third fragment refers to a
+# sample description the track doesn't use; its samples are skipped.
+atom      = lambda { |type, *children| content = children.join(''); [ content.bytesize + 8 ].pack('N') + type + content }
+full_atom = lambda { |type, version_flags, *children| atom.call(type, [ version_flags ].pack('N'), *children) }
+payload   = lambda { |size, seed| (0...size).collect { |idx| (idx * 7 + seed) & 0xff }.pack('C*') }
+
+# A 'moof' atom whose data offsets depend on the size of the 'moof'
+# atom itself; its size doesn't depend on the offsets' values.
+moof      = lambda { |builder| builder.call(builder.call(0).bytesize) }
+
+file_name = "#{tmp}-fragmented.mp4"
+samples   = [ 960, 960, 960, 960, 480, 960, 1920 ].each_with_index.collect { |size, idx| payload.call(size, idx) }
+
+setup do
+  sowt = atom.call('sowt', "\0" * 6, [ 1, 0, 0, 0, 2, 16, 0, 0, 48000 << 16 ].pack('nnnNnnnnN'))
+  stbl = atom.call('stbl',
+                   full_atom.call('stsd', 0, [ 1 ].pack('N'), sowt),
+                   full_atom.call('stts', 0, [ 0 ].pack('N')),
+                   full_atom.call('stsc', 0, [ 0 ].pack('N')),
+                   full_atom.call('stsz', 0, [ 0, 0 ].pack('NN')),
+                   full_atom.call('stco', 0, [ 0 ].pack('N')))
+
+  trak = atom.call('trak',
+                   full_atom.call('tkhd', 7, [ 0, 0, 1, 0, 0 ].pack('NNNNN'), "\0" * 8, [ 0, 0, 0x100, 0 ].pack('nnnn'), "\0" * 36, [ 0, 0 ].pack('NN')),
+                   atom.call('mdia',
+                             full_atom.call('mdhd', 0, [ 0, 0, 48000, 0, 0x55c4, 0 ].pack('NNNNnn')),
+                             full_atom.call('hdlr', 0, 'mhlr', 'soun', [ 0, 0, 0 ].pack('NNN'), "\0"),
+                             atom.call('minf', stbl)))
+
+  moov = atom.call('moov',
+                   full_atom.call('mvhd', 0, [ 0, 0, 48000, 0, 0x10000 ].pack('NNNNN'), [ 0x100 ].pack('n'), "\0" * 46, [ 0, 0, 0, 0, 0, 0, 2 ].pack('N*')),
+                   trak,
+                   atom.call('mvex', full_atom.call('trex', 0, [ 1, 1, 240, 0, 0 ].pack('NNNNN'))))
+
+  # Default base is 'moof', default duration and size, explicit data offset
+  moof1 = moof.call(lambda do |size|
+    atom.call('moof',
+              full_atom.call('mfhd', 0, [ 1 ].pack('N')),
+              atom.call('traf',
+                        full_atom.call('tfhd', 0x020018, [ 1, 240, 960 ].pack('NNN')),
+                        full_atom.call('tfdt', 0x01000000, [ 0 ].pack('Q>')),
+                        full_atom.call('trun', 0x000001, [ 4, size + 8 ].pack('NN'))))
+  end)
+
+  # Unknown track first, then implicit offset and per-sample sizes
+  moof2 = moof.call(lambda do |size|
+    atom.call('moof',
+              full_atom.call('mfhd', 0, [ 2 ].pack('N')),
+              atom.call('traf',
+                        full_atom.call('tfhd', 0x020018, [ 7, 240, 100 ].pack('NNN')),
+                        full_atom.call('trun', 0x000001, [ 1, size + 8 ].pack('NN'))),
+              atom.call('traf',
+                        full_atom.call('tfhd', 0, [ 1 ].pack('N')),
+                        full_atom.call('tfdt', 0, [ 960 ].pack('N')),
+                        full_atom.call('trun', 0x000200, [ 3, 480, 960, 1920 ].pack('NNNNN'))))
+  end)
+
+  # Sample description 2 doesn't exist
+  moof3 = moof.call(lambda do |size|
+    atom.call('moof',
+              full_atom.call('mfhd', 0, [ 3 ].pack('N')),
+              atom.call('traf',
+                        full_atom.call('tfhd', 0x02001a, [ 1, 2, 240, 960 ].pack('NNNN')),
+                        full_atom.call('tfdt', 0, [ 1680 ].pack('N')),
+                        full_atom.call('trun', 0x000001, [ 2, size + 8 ].pack('NN'))))
+  end)
+
+  File.open(file_name, 'wb') do |file|
+    file.write atom.call('ftyp', 'iso6', [ 0 ].pack('N'), 'iso6', 'dash')
+    file.write moov
+    file.write moof1, atom.call('mdat', *samples[0..3])
+    file.write moof2, atom.call('mdat', payload.call(100, 99), *samples[4..6])
+    file.write moof3, atom.call('mdat', payload.call(960, 98), payload.call(960, 97))
+  end
+end
+
+test "identification" do
+  /Track ID 0: audio \(sowt\)/.match(identify(file_name, :verbose => false).join('')) ? 'ok' : 'BAD'
+end
+
+test "merging and extraction" do
+  merge file_name, :exit_code => :warning
+  extract tmp, 0 => "#{tmp}-x"
+
+  content = IO.read("#{tmp}-x", :mode => 'rb')
+  content.end_with?(samples.join('')) ? 'ok' : 'BAD'
+end
@@ -0,0 +1,111 @@
+#include "common/common_pch.h"
+
+#include "common/byte_buffer.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<unsigned char>
+make_pattern(size_t size,
+             size_t start = 0) {
+  std::vector<unsigned char> pattern(size);
+  for (auto idx = 0u; idx < size; ++idx)
+    pattern[idx] = (start + idx) % 251;
+
+  return pattern;
+}
+
+TEST(ByteBuffer, AddAndRemove) {
+  byte_buffer_c b{16};
+  auto pattern = make_pattern(100);
+
+  EXPECT_EQ(0u, b.get_size());
+
+  b.add(&pattern[0], 10);
+  b.add(&pattern[10], 90);
+  ASSERT_EQ(100u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[0], 100));
+
+  b.remove(33);
+  ASSERT_EQ(67u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[33], 67));
+
+  b.remove(67);
+  EXPECT_EQ(0u, b.get_size());
+}
+
+TEST(ByteBuffer, ContiguousAfterManySmallOperations) {
+  byte_buffer_c b{64};
+  auto pattern    = make_pattern(100000);
+  size_t added    = 0;
+  size_t removed  = 0;
+
+  while (added < pattern.size()) {
+    auto to_add = std::min<size_t>(pattern.size() - added, 37);
+    b.add(&pattern[added], to_add);
+    added += to_add;
+
+    auto to_remove = std::min<size_t>(b.get_size(), 29);
+    b.remove(to_remove);
+    removed += to_remove;
+
+    ASSERT_EQ(added - removed, b.get_size());
+    ASSERT_EQ(0, memcmp(b.get_buffer(), &pattern[removed], b.get_size()));
+  }
+}
+
+TEST(ByteBuffer, LargeBacklogSmallRemoves) {
+  byte_buffer_c b{1024};
+  auto pattern = make_pattern(1024 * 1024);
+
+  b.add(&pattern[0], pattern.size());
+
+  for (size_t removed = 0; removed < pattern.size(); removed += 1000) {
+    auto to_remove = std::min<size_t>(1000, b.get_size());
+    ASSERT_EQ(pattern[removed], b.get_buffer()[0]);
+    b.remove(to_remove);
+  }
+
+  EXPECT_EQ(0u, b.get_size());
+}
+
+TEST(ByteBuffer, ReserveAndCommit) {
+  byte_buffer_c b{16};
+  auto pattern = make_pattern(300);
+
+  b.add(&pattern[0], 10);
+  b.remove(4);
+
+  auto dst = b.reserve(200);
+  memcpy(dst, &pattern[10], 150);
+  b.commit(150);
+
+  ASSERT_EQ(156u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[4], 156));
+
+  b.reserve(100);
+  b.commit(0);
+  EXPECT_EQ(156u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[4], 156));
+}
+
+TEST(ByteBuffer, ClearAndChunkSize) {
+  byte_buffer_c b{16};
+  auto pattern = make_pattern(200);
+
+  b.add(&pattern[0], 200);
+  b.remove(50);
+  b.set_chunk_size(1024);
+  ASSERT_EQ(150u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[50], 150));
+
+  b.clear();
+  EXPECT_EQ(0u, b.get_size());
+
+  b.add(&pattern[0], 5);
+  ASSERT_EQ(5u, b.get_size());
+  EXPECT_EQ(0, memcmp(b.get_buffer(), &pattern[0], 5));
+}
+
+}
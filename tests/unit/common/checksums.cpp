@@ -0,0 +1,98 @@
+#include "common/common_pch.h"
+
+#include "common/bswap.h"
+#include "common/checksums.h"
+#include "common/cpu_kernels.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+unsigned char const *
+as_bytes(char const *string) {
+  return reinterpret_cast<unsigned char const *>(string);
+}
+
+TEST(Checksums, Adler32KnownValues) {
+  EXPECT_EQ(0x00000001u, calc_adler32(as_bytes(""),          0));
+  EXPECT_EQ(0x11e60398u, calc_adler32(as_bytes("Wikipedia"), 9));
+}
+
+TEST(Checksums, Adler32KernelsAgree) {
+  auto data    = mtxut::make_random_data(300000);
+  auto &kernel = mtx::checksums::adler32_kernel();
+
+  // Sizes above 5552 bytes make the unreduced sums wrap around.
+  for (auto size : std::vector<size_t>{ 0, 1, 15, 16, 17, 63, 64, 65, 5552, 5553, 100000, 299990 })
+    for (auto offset : std::vector<size_t>{ 0, 1, 3 }) {
+      auto expected = kernel.get_reference().function(&data[offset], size);
+
+      for (auto &implementation : kernel.get_implementations()) {
+        if (!implementation.is_usable())
+          continue;
+
+        EXPECT_EQ(expected, implementation.function(&data[offset], size)) << implementation.name << " size " << size << " offset " << offset;
+      }
+
+      EXPECT_EQ(expected, calc_adler32(&data[offset], size)) << "size " << size << " offset " << offset;
+    }
+}
+
+TEST(Checksums, CrcKnownValues) {
+  auto check = as_bytes("123456789");
+
+  EXPECT_EQ(0xf4u,       crc_calc(crc_get_table(CRC_8_ATM),                0, check, 9));
+  EXPECT_EQ(0xfee8u,     bswap_16(crc_calc(crc_get_table(CRC_16_ANSI),     0, check, 9)));
+  EXPECT_EQ(0x31c3u,     bswap_16(crc_calc(crc_get_table(CRC_16_CCITT),    0, check, 9)));
+  EXPECT_EQ(0xcbf43926u, 0xffffffff ^ crc_calc(crc_get_table(CRC_32_IEEE_LE), 0xffffffff, check, 9));
+  EXPECT_EQ(0x0376e6e7u, crc_calc_mpeg2(const_cast<unsigned char *>(check), 9));
+}
+
+TEST(Checksums, CrcKernelsAgree) {
+  auto data = mtxut::make_random_data(100000);
+
+  for (int crc_id = 0; crc_id < CRC_MAX; ++crc_id) {
+    auto table = crc_get_table(static_cast<crc_type_e>(crc_id));
+
+    for (auto size : std::vector<size_t>{ 0, 1, 7, 8, 9, 63, 64, 65, 99990 })
+      for (auto offset : std::vector<size_t>{ 0, 1, 5 }) {
+        auto expected = mtx::checksums::crc_bytewise(table, 0x1234, &data[offset], size);
+
+        EXPECT_EQ(expected, mtx::checksums::crc_slicing_by_8(static_cast<crc_type_e>(crc_id), 0x1234, &data[offset], size)) << "CRC " << crc_id << " size " << size << " offset " << offset;
+        EXPECT_EQ(expected, crc_calc(table, 0x1234, &data[offset], size))                                                   << "CRC " << crc_id << " size " << size << " offset " << offset;
+      }
+  }
+}
+
+// Throughput comparison of the kernels. Run with
+// --gtest_also_run_disabled_tests --gtest_filter=ChecksumsBenchmark.*
+template<typename T>
+void
+benchmark(std::string const &name,
+          std::vector<unsigned char> const &data,
+          T const &kernel) {
+  auto const num_runs = 100u;
+  uint32_t result     = 0;
+  auto speed          = mtxut::megabytes_per_second(num_runs * data.size(), [&]() {
+    for (auto run = 0u; run < num_runs; ++run)
+      result += kernel(&data[0], data.size());
+  });
+
+  std::cout << (boost::format("%|1$-24s| %|2$8.1f| MB/s (result 0x%|3$08x|)\n") % name % speed % result).str();
+}
+
+TEST(ChecksumsBenchmark, DISABLED_Throughput) {
+  auto data  = mtxut::make_random_data(4 * 1024 * 1024);
+  auto table = crc_get_table(CRC_32_IEEE_LE);
+
+  for (auto &implementation : mtx::checksums::adler32_kernel().get_implementations())
+    if (implementation.is_usable())
+      benchmark("adler32 " + implementation.name, data, implementation.function);
+
+  benchmark("CRC-32 byte-wise",      data, [table](unsigned char const *buffer, size_t size) { return mtx::checksums::crc_bytewise(table, 0, buffer, size); });
+  benchmark("CRC-32 slicing-by-8",   data, [](unsigned char const *buffer, size_t size) { return mtx::checksums::crc_slicing_by_8(CRC_32_IEEE_LE, 0, buffer, size); });
+  benchmark("CRC-16 slicing-by-8",   data, [](unsigned char const *buffer, size_t size) { return mtx::checksums::crc_slicing_by_8(CRC_16_ANSI, 0, buffer, size); });
+}
+
+}
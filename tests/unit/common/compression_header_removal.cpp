@@ -0,0 +1,49 @@
+#include "common/common_pch.h"
+
+#include "common/compression/header_removal.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(HeaderRemovalCompression, StripAndRestoreWithoutCopying) {
+  auto bytes = memory_c::clone("\x00\x00\x01", 3);
+  header_removal_compressor_c compressor;
+  compressor.set_bytes(bytes);
+
+  auto data     = memory_c::clone("\x00\x00\x01\xb6" "Bacon", 8);
+  auto payload  = data->get_buffer() + 3;
+  auto stripped = compressor.compress(data);
+  data.reset();
+
+  ASSERT_EQ(5u, stripped->get_size());
+  EXPECT_EQ(payload, stripped->get_buffer());
+  EXPECT_EQ(0, memcmp(stripped->get_buffer(), "\xb6" "Bacon", 5));
+
+  auto restored = compressor.decompress(stripped);
+  ASSERT_EQ(8u, restored->get_size());
+  EXPECT_EQ(payload - 3, restored->get_buffer());
+  EXPECT_EQ(0, memcmp(restored->get_buffer(), "\x00\x00\x01\xb6" "Bacon", 8));
+}
+
+TEST(HeaderRemovalCompression, SharedBuffersAreCopied) {
+  auto bytes = memory_c::clone("\x00\x00\x01", 3);
+  header_removal_compressor_c compressor;
+  compressor.set_bytes(bytes);
+
+  auto data      = memory_c::clone("\x00\x00\x01\xb6", 4);
+  auto reference = data;
+  auto stripped  = compressor.compress(data);
+
+  ASSERT_EQ(1u, stripped->get_size());
+  EXPECT_NE(data->get_buffer() + 3, stripped->get_buffer());
+  EXPECT_EQ(4u, data->get_size());
+
+  auto restored = compressor.decompress(data);
+  ASSERT_EQ(7u, restored->get_size());
+  EXPECT_EQ(0, memcmp(restored->get_buffer(), "\x00\x00\x01\x00\x00\x01\xb6", 7));
+
+  EXPECT_THROW(compressor.compress(memory_c::clone("\x00\x01\x01\xb6", 4)), mtx::compression_x);
+}
+
+}
@@ -0,0 +1,122 @@
+#include "common/common_pch.h"
+
+#include "common/checksums.h"
+#include "common/cpu_features.h"
+#include "common/cpu_kernels.h"
+#include "common/endian.h"
+#include "common/mpeg4_p10.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(CpuFeatures, FormatFeatures) {
+  EXPECT_EQ("none",            mtx::cpu::format_features(mtx::cpu::FEATURE_NONE));
+  EXPECT_EQ("sse2",            mtx::cpu::format_features(mtx::cpu::FEATURE_SSE2));
+  EXPECT_EQ("sse2 ssse3 avx2", mtx::cpu::format_features(mtx::cpu::FEATURE_SSE2 | mtx::cpu::FEATURE_SSSE3 | mtx::cpu::FEATURE_AVX2));
+}
+
+TEST(CpuFeatures, ForceScalar) {
+  auto &kernel = mtx::checksums::adler32_kernel();
+
+  mtx::cpu::force_scalar(true);
+  EXPECT_EQ(mtx::cpu::FEATURE_NONE, mtx::cpu::get_usable_features());
+  EXPECT_FALSE(mtx::cpu::has(mtx::cpu::FEATURE_SSE2));
+  EXPECT_EQ("scalar", kernel.get_selected().name);
+
+  mtx::cpu::force_scalar(false);
+  EXPECT_EQ(mtx::cpu::get_detected_features(), mtx::cpu::get_usable_features());
+  EXPECT_TRUE(kernel.get_selected().is_usable());
+
+  // The last usable implementation is the best one.
+  for (auto &implementation : kernel.get_implementations()) {
+    if (!implementation.is_usable())
+      continue;
+
+    EXPECT_LE(implementation.required_features, kernel.get_selected().required_features);
+  }
+}
+
+TEST(CpuFeatures, Swap16BitWordsKernelsAgree) {
+  auto data    = mtxut::make_random_data(1000);
+  auto &kernel = mtx::endian::swap_16bit_words_kernel();
+
+  for (auto size : std::vector<size_t>{ 0, 1, 2, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 998 })
+    for (auto offset : std::vector<size_t>{ 0, 1 }) {
+      auto expected = data;
+      kernel.get_reference().function(&expected[offset], size);
+
+      for (auto &implementation : kernel.get_implementations()) {
+        if (!implementation.is_usable())
+          continue;
+
+        auto actual = data;
+        implementation.function(&actual[offset], size);
+        EXPECT_EQ(expected, actual) << implementation.name << " size " << size << " offset " << offset;
+      }
+    }
+}
+
+std::vector<unsigned char>
+nalu_to_rbsp(mpeg4::p10::nalu_to_rbsp_fn *function,
+             std::vector<unsigned char> const &nalu) {
+  std::vector<unsigned char> rbsp(nalu.size());
+  rbsp.resize(function(nalu.data(), nalu.size(), rbsp.data()));
+
+  return rbsp;
+}
+
+TEST(CpuFeatures, NaluToRbspKernelsKnownValues) {
+  typedef std::vector<unsigned char> bytes_t;
+
+  std::vector<std::pair<bytes_t, bytes_t>> const tests{
+    { bytes_t{ 0x00, 0x00, 0x03 },                                     bytes_t{ 0x00, 0x00 }                                     },
+    { bytes_t{ 0x00, 0x00, 0x03, 0x01, 0x00, 0x03 },                   bytes_t{ 0x00, 0x00, 0x01, 0x00, 0x03 }                   },
+    { bytes_t{ 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x00 }, bytes_t{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }       },
+    { bytes_t{ 0x42, 0x00, 0x03, 0x00, 0x00, 0x02 },                   bytes_t{ 0x42, 0x00, 0x03, 0x00, 0x00, 0x02 }             },
+  };
+
+  for (auto &implementation : mpeg4::p10::nalu_to_rbsp_kernel().get_implementations()) {
+    if (!implementation.is_usable())
+      continue;
+
+    for (auto &test : tests) {
+      // Place the interesting bytes both at the start and after a
+      // block of 16 non-zero bytes.
+      auto prefix = bytes_t(16, 0x55);
+      auto nalu   = prefix;
+      auto rbsp   = prefix;
+      nalu.insert(nalu.end(), test.first.begin(),  test.first.end());
+      rbsp.insert(rbsp.end(), test.second.begin(), test.second.end());
+
+      EXPECT_EQ(test.second, nalu_to_rbsp(implementation.function, test.first)) << implementation.name;
+      EXPECT_EQ(rbsp,        nalu_to_rbsp(implementation.function, nalu))       << implementation.name;
+    }
+  }
+}
+
+TEST(CpuFeatures, NaluToRbspKernelsAgree) {
+  auto &kernel = mpeg4::p10::nalu_to_rbsp_kernel();
+
+  // Only a few distinct byte values so that emulation prevention
+  // sequences occur frequently, and more values for realistic data.
+  for (auto num_values : std::vector<unsigned int>{ 2, 4, 256 }) {
+    auto data = mtxut::make_random_data(5000, num_values);
+
+    for (auto size : std::vector<size_t>{ 0, 1, 2, 3, 15, 16, 17, 18, 31, 32, 33, 4990 })
+      for (auto offset : std::vector<size_t>{ 0, 1, 5 }) {
+        auto nalu     = std::vector<unsigned char>(data.begin() + offset, data.begin() + offset + size);
+        auto expected = nalu_to_rbsp(kernel.get_reference().function, nalu);
+
+        for (auto &implementation : kernel.get_implementations()) {
+          if (!implementation.is_usable())
+            continue;
+
+          EXPECT_EQ(expected, nalu_to_rbsp(implementation.function, nalu)) << implementation.name << " values " << num_values << " size " << size << " offset " << offset;
+        }
+      }
+  }
+}
+
+}
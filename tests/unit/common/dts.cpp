@@ -0,0 +1,137 @@
+#include "common/common_pch.h"
+
+#include "common/bit_cursor.h"
+#include "common/dts.h"
+#include "common/endian.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// A core only stream with frames of 1024 bytes, 48 kHz, 5 channels.
+std::vector<unsigned char>
+make_dts_stream(size_t num_frames) {
+  size_t const frame_size = 1024;
+  std::vector<unsigned char> stream(num_frames * frame_size, 0);
+
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    bit_writer_c bw(&stream[frame * frame_size], frame_size);
+
+    bw.put_bits(16, DTS_HEADER_MAGIC >> 16);
+    bw.put_bits(16, DTS_HEADER_MAGIC & 0xffff);
+    bw.put_bits(1,  1);                 // frame type: normal
+    bw.put_bits(5,  31);                // deficit sample count
+    bw.put_bits(1,  0);                 // CRC present
+    bw.put_bits(7,  15);                // number of PCM sample blocks - 1
+    bw.put_bits(14, frame_size - 1);    // frame byte size - 1
+    bw.put_bits(6,  9);                 // channel arrangement
+    bw.put_bits(4,  13);                // sampling frequency: 48 kHz
+    bw.put_bits(5,  15);                // transmission bit rate
+    bw.put_bits(5,  0);                 // down mix … HDCD master
+    bw.put_bits(3,  0);                 // extension audio descriptor
+    bw.put_bits(1,  0);                 // extended coding
+    bw.put_bits(1,  0);                 // audio sync word in sub-sub frame
+    bw.put_bits(2,  1);                 // LFE type
+    bw.put_bits(1,  0);                 // predictor history
+    bw.put_bits(1,  0);                 // multirate interpolator
+    bw.put_bits(4,  7);                 // encoder software revision
+    bw.put_bits(2,  0);                 // copy history
+    bw.put_bits(3,  0);                 // source PCM resolution: 16 bits
+    bw.put_bits(2,  0);                 // front/surround sum difference
+    bw.put_bits(4,  0);                 // dialog normalization gain
+
+    for (size_t idx = 32; idx < frame_size; ++idx)
+      stream[frame * frame_size + idx] = idx * 7 + frame;
+  }
+
+  return stream;
+}
+
+// Reference implementation: splits the bit stream into 14-bit values
+// and stores each of them sign extended in a big endian 16-bit word.
+std::vector<unsigned char>
+pack_14_bits(std::vector<unsigned char> const &src) {
+  bit_reader_c bc(&src[0], src.size());
+  std::vector<unsigned char> dst;
+
+  for (size_t num_words = src.size() * 8 / 14; 0 < num_words; --num_words) {
+    unsigned int value = bc.get_bits(14);
+    if (value & 0x2000)
+      value |= 0xc000;
+
+    dst.push_back(value >> 8);
+    dst.push_back(value & 0xff);
+  }
+
+  return dst;
+}
+
+std::vector<unsigned char>
+swapped(std::vector<unsigned char> data) {
+  for (size_t idx = 0; (idx + 1) < data.size(); idx += 2)
+    std::swap(data[idx], data[idx + 1]);
+
+  return data;
+}
+
+TEST(Dts, Swap16BitWords) {
+  for (size_t size : { 0u, 1u, 2u, 7u, 8u, 9u, 16u, 31u, 1000u }) {
+    std::vector<unsigned char> data(size);
+    for (size_t idx = 0; idx < size; ++idx)
+      data[idx] = idx * 13 + 1;
+
+    auto expected = swapped(data);
+    swap_16bit_words(data.data(), size);
+
+    EXPECT_EQ(expected, data) << "size " << size;
+  }
+}
+
+TEST(Dts, Convert14To16) {
+  auto stream = make_dts_stream(4);
+  auto packed = pack_14_bits(stream);
+
+  ASSERT_EQ(0u, packed.size() % 8);
+
+  std::vector<unsigned char> converted(packed.size() * 7 / 8);
+  dts_14_to_dts_16(reinterpret_cast<unsigned short const *>(packed.data()), packed.size() / 2, reinterpret_cast<unsigned short *>(converted.data()));
+
+  EXPECT_EQ(0, memcmp(converted.data(), stream.data(), converted.size()));
+
+  // In place
+  auto words = reinterpret_cast<unsigned short *>(packed.data());
+  dts_14_to_dts_16(words, packed.size() / 2, words);
+
+  EXPECT_EQ(0, memcmp(packed.data(), stream.data(), converted.size()));
+}
+
+TEST(Dts, DetectAllVariants) {
+  auto stream = make_dts_stream(16);
+  bool dts14_to_16, swap_bytes;
+
+  std::vector<unsigned char> garbage(100, 0x55);
+  garbage.insert(garbage.end(), stream.begin(), stream.end());
+  ASSERT_TRUE(detect_dts(garbage.data(), garbage.size(), dts14_to_16, swap_bytes));
+  EXPECT_FALSE(dts14_to_16);
+  EXPECT_FALSE(swap_bytes);
+
+  auto packed = pack_14_bits(stream);
+  ASSERT_TRUE(detect_dts(packed.data(), packed.size(), dts14_to_16, swap_bytes));
+  EXPECT_TRUE(dts14_to_16);
+  EXPECT_FALSE(swap_bytes);
+
+  auto swapped_stream = swapped(stream);
+  ASSERT_TRUE(detect_dts(swapped_stream.data(), swapped_stream.size(), dts14_to_16, swap_bytes));
+  EXPECT_FALSE(dts14_to_16);
+  EXPECT_TRUE(swap_bytes);
+
+  auto swapped_packed = swapped(packed);
+  ASSERT_TRUE(detect_dts(swapped_packed.data(), swapped_packed.size(), dts14_to_16, swap_bytes));
+  EXPECT_TRUE(dts14_to_16);
+  EXPECT_TRUE(swap_bytes);
+
+  std::vector<unsigned char> no_dts(16384, 0x42);
+  EXPECT_FALSE(detect_dts(no_dts.data(), no_dts.size(), dts14_to_16, swap_bytes));
+}
+
+}
@@ -0,0 +1,82 @@
+#include "common/common_pch.h"
+
+#include "common/checksums.h"
+#include "common/flac.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+#if defined(HAVE_FLAC_FORMAT_H)
+
+namespace {
+
+typedef std::vector<unsigned char> bytes_t;
+
+// A frame with a valid header (fixed block size of 4096 samples,
+// 44.1 kHz, stereo, 16 bits, frame number 0), random content and a
+// matching CRC-16.
+bytes_t
+make_frame(size_t content_size) {
+  auto frame = bytes_t{ 0xff, 0xf8, 0xc9, 0x18, 0x00 };
+  frame.push_back(crc_calc(crc_get_table(CRC_8_ATM), 0, &frame[0], frame.size()));
+
+  auto content = mtxut::make_random_data(content_size);
+  frame.insert(frame.end(), content.begin(), content.end());
+
+  auto crc = crc_calc(crc_get_table(CRC_16_ANSI), 0, &frame[0], frame.size());
+  frame.push_back(crc & 0xff);
+  frame.push_back(crc >> 8);
+
+  return frame;
+}
+
+TEST(Flac, FrameCrc) {
+  auto frame = make_frame(1000);
+
+  EXPECT_EQ(6u, flac_get_frame_header_size(&frame[0], frame.size()));
+  EXPECT_TRUE(flac_is_frame_crc_valid(&frame[0], frame.size()));
+
+  frame[100] ^= 0x01;
+  EXPECT_FALSE(flac_is_frame_crc_valid(&frame[0], frame.size()));
+}
+
+TEST(Flac, ReservedSampleSizes) {
+  for (auto sample_size_code : std::vector<unsigned char>{ 3, 4, 7 }) {
+    auto header = bytes_t{ 0xff, 0xf8, 0xc9, static_cast<unsigned char>(0x10 | (sample_size_code << 1)), 0x00 };
+    header.push_back(crc_calc(crc_get_table(CRC_8_ATM), 0, &header[0], header.size()));
+
+    EXPECT_EQ(4 == sample_size_code ? 6u : 0u, flac_get_frame_header_size(&header[0], header.size()));
+  }
+}
+
+TEST(Flac, LongestValidFrameWithTrailer) {
+  auto frame = make_frame(1000);
+  EXPECT_EQ(frame.size(), flac_find_longest_valid_frame(&frame[0], frame.size()));
+
+  // ID3v1 tag
+  auto with_tag = frame;
+  with_tag.insert(with_tag.end(), { 'T', 'A', 'G' });
+  with_tag.resize(frame.size() + 128, ' ');
+  EXPECT_EQ(frame.size(), flac_find_longest_valid_frame(&with_tag[0], with_tag.size()));
+
+  // Other trailing data that doesn't start with a frame header
+  auto trailer      = mtxut::make_random_data(3000, 256, 4711);
+  auto with_trailer = frame;
+  with_trailer.insert(with_trailer.end(), trailer.begin(), trailer.end());
+  with_trailer[frame.size()] = 0x00;
+
+  EXPECT_EQ(frame.size(), flac_find_longest_valid_frame(&with_trailer[0], with_trailer.size()));
+
+  // Zero padding
+  auto with_padding = frame;
+  with_padding.resize(frame.size() + 500, 0x00);
+  EXPECT_EQ(frame.size(), flac_find_longest_valid_frame(&with_padding[0], with_padding.size()));
+
+  // A damaged frame
+  frame[100] ^= 0x01;
+  EXPECT_EQ(0u, flac_find_longest_valid_frame(&frame[0], frame.size()));
+}
+
+}
+
+#endif  // HAVE_FLAC_FORMAT_H
@@ -0,0 +1,43 @@
+#include "common/common_pch.h"
+
+#include "common/fs_sys_helpers.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void
+write_file(std::string const &file_name,
+           std::string const &content) {
+  auto out = fopen(file_name.c_str(), "wb");
+  ASSERT_NE(nullptr, out);
+  fwrite(content.c_str(), 1, content.size(), out);
+  fclose(out);
+}
+
+TEST(FsSysHelpers, FileIdentity) {
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path()).string();
+  uint64_t file_id, mtime, new_file_id, new_mtime;
+
+  EXPECT_FALSE(get_file_identity(file_name, file_id, mtime));
+
+  write_file(file_name, "0123456789");
+  ASSERT_TRUE(get_file_identity(file_name, file_id, mtime));
+
+  EXPECT_TRUE(get_file_identity(file_name, new_file_id, new_mtime));
+  EXPECT_EQ(file_id, new_file_id);
+  EXPECT_EQ(mtime,   new_mtime);
+
+  // Rewriting the file with the same size within the same second must
+  // be noticed.
+  sleep_millis(20);
+  write_file(file_name, "9876543210");
+
+  EXPECT_TRUE(get_file_identity(file_name, new_file_id, new_mtime));
+  EXPECT_EQ(file_id, new_file_id);
+  EXPECT_NE(mtime,   new_mtime);
+
+  bfs::remove(file_name);
+}
+
+}
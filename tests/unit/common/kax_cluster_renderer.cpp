@@ -0,0 +1,174 @@
+#include "common/common_pch.h"
+
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxBlockData.h>
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+#include <matroska/KaxTracks.h>
+
+#include "common/kax_cluster_renderer.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+using namespace libmatroska;
+
+namespace {
+
+int64_t const s_timecode_scale = 1000000;
+
+struct test_block_t {
+  unsigned int track_num;
+  int16_t relative_timecode;
+  bool group, key_frame, discardable;
+  std::vector<int64_t> references;
+  int64_t duration;
+  std::vector<size_t> sizes;
+};
+
+// Blocks with several frames use fixed, Xiph and EBML lacing in that
+// order.
+std::vector<test_block_t> const s_blocks{
+  //  track    tc  group  key    disc.  refs        dur    sizes
+  {     1,      0, false, true,  false, {},          -1,    { 100 } },
+  {     1,     40, false, false, false, {},          -1,    { 200 } },
+  {     1,     80, false, false, true,  {},          -1,    { 20 } },
+  {   200,     10, false, true,  false, {},          -1,    { 300 } },
+  {     4,     20, false, true,  false, {},          -1,    { 100, 100, 100 } },
+  {     4,     30, false, true,  false, {},          -1,    { 10, 120, 10 } },
+  {   400,     40, false, true,  false, {},          -1,    { 600, 610, 5, 1400, 300, 301, 2 } },
+  {     2,    120, true,  false, false, {},          40,    { 500 } },
+  {     2,    160, true,  false, false, { -40 },     40,    { 20000 } },
+  {     2,    200, true,  false, false, { -40, 80 }, -1,    { 1000 } },
+  {     5,    220, true,  false, false, {},          80,    { 300, 300 } },
+  {     5,    240, true,  false, false, {},          -1,    { 1000, 10, 1000 } },
+  {   300,     -5, true,  false, false, { 300 },     -1,    { 10 } },
+  {     3,  32767, true,  false, false, { -32767 },  70000, { 127 } },
+};
+
+std::string
+render_with_libmatroska(uint64_t cluster_timecode,
+                        std::vector<uint64_t> &positions) {
+  auto data = mtxut::make_random_data(20000);
+
+  std::map<unsigned int, std::shared_ptr<KaxTrackEntry>> tracks;
+  for (auto &block : s_blocks) {
+    auto &track = tracks[block.track_num];
+    if (track)
+      continue;
+
+    track = std::make_shared<KaxTrackEntry>();
+    GetChild<KaxTrackNumber>(*track).SetValue(block.track_num);
+    track->SetGlobalTimecodeScale(s_timecode_scale);
+  }
+
+  KaxCluster cluster;
+  cluster.InitTimecode(cluster_timecode, s_timecode_scale);
+  GetChild<KaxClusterTimecode>(cluster).SetValue(cluster_timecode);
+
+  std::vector<EbmlElement *> elements;
+
+  for (auto &block : s_blocks) {
+    auto timecode = (static_cast<int64_t>(cluster_timecode) + block.relative_timecode) * s_timecode_scale;
+    auto &track   = *tracks[block.track_num];
+
+    std::vector<DataBuffer *> data_buffers;
+    for (auto idx = 0u; block.sizes.size() > idx; ++idx)
+      data_buffers.push_back(new DataBuffer(static_cast<binary *>(&data[idx * 10]), block.sizes[idx]));
+
+    if (!block.group) {
+      auto simple_block = new KaxSimpleBlock;
+      simple_block->SetParent(cluster);
+      for (auto data_buffer : data_buffers)
+        simple_block->AddFrame(track, timecode, *data_buffer, LACING_AUTO);
+      simple_block->SetKeyframe(block.key_frame);
+      simple_block->SetDiscardable(block.discardable);
+
+      cluster.PushElement(*simple_block);
+      elements.push_back(simple_block);
+      continue;
+    }
+
+    auto group = new KaxBlockGroup;
+    group->SetParent(cluster);
+    cluster.PushElement(*group);
+
+    // Cues refer to the Block inside the group.
+    auto &kax_block = GetChild<KaxBlock>(*group);
+    kax_block.SetParent(cluster);
+    for (auto data_buffer : data_buffers)
+      kax_block.AddFrame(track, timecode, *data_buffer, LACING_AUTO);
+    elements.push_back(&kax_block);
+
+    for (auto reference : block.references) {
+      auto kax_reference = new KaxReferenceBlock;
+      kax_reference->SetReferencedTimecode(reference);
+      group->PushElement(*kax_reference);
+    }
+
+    if (-1 != block.duration)
+      GetChild<KaxBlockDuration>(*group).SetValue(block.duration);
+  }
+
+  mm_mem_io_c out{nullptr, 0, 64 * 1024};
+  cluster.EbmlElement::Render(out, false);
+
+  for (auto element : elements)
+    positions.push_back(element->GetElementPosition() - cluster.HeadSize());
+
+  return out.get_content();
+}
+
+std::string
+render_directly(uint64_t cluster_timecode,
+                std::vector<uint64_t> &positions) {
+  auto data = mtxut::make_random_data(20000);
+
+  kax_cluster_renderer_c renderer;
+  renderer.start(cluster_timecode);
+
+  for (auto &block : s_blocks) {
+    std::vector<memory_cptr> frames;
+    kax_cluster_renderer_c::frames_t frame_ptrs;
+
+    for (auto idx = 0u; block.sizes.size() > idx; ++idx) {
+      frames.push_back(memory_cptr{new memory_c{&data[idx * 10], block.sizes[idx], false}});
+      frame_ptrs.push_back(frames.back().get());
+    }
+
+    if (!block.group)
+      positions.push_back(renderer.add_simple_block(block.track_num, block.relative_timecode, block.key_frame, block.discardable, frame_ptrs));
+    else
+      positions.push_back(renderer.add_block_group(block.track_num, block.relative_timecode, frame_ptrs, block.references, block.duration));
+  }
+
+  mm_mem_io_c out{nullptr, 0, 64 * 1024};
+  auto num_written = renderer.finish(out);
+  EXPECT_EQ(out.getFilePointer(), num_written);
+
+  return out.get_content();
+}
+
+TEST(KaxClusterRenderer, SameBytesAsLibmatroska) {
+  for (auto cluster_timecode : std::vector<uint64_t>{ 1000, 70000, 1ull << 40 }) {
+    std::vector<uint64_t> expected_positions, actual_positions;
+
+    auto expected = render_with_libmatroska(cluster_timecode, expected_positions);
+    auto actual   = render_directly(cluster_timecode, actual_positions);
+
+    EXPECT_EQ(expected.size(),    actual.size())    << "cluster timecode " << cluster_timecode;
+    EXPECT_TRUE(expected == actual)                 << "cluster timecode " << cluster_timecode;
+    EXPECT_EQ(expected_positions, actual_positions) << "cluster timecode " << cluster_timecode;
+  }
+}
+
+TEST(KaxClusterRenderer, RelativeTimecodeRange) {
+  EXPECT_TRUE(kax_cluster_renderer_c::is_relative_timecode_valid(0));
+  EXPECT_TRUE(kax_cluster_renderer_c::is_relative_timecode_valid(-32768));
+  EXPECT_TRUE(kax_cluster_renderer_c::is_relative_timecode_valid(32767));
+  EXPECT_FALSE(kax_cluster_renderer_c::is_relative_timecode_valid(-32769));
+  EXPECT_FALSE(kax_cluster_renderer_c::is_relative_timecode_valid(32768));
+  EXPECT_FALSE(kax_cluster_renderer_c::is_relative_timecode_valid(1ll << 40));
+}
+
+}
@@ -0,0 +1,86 @@
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+
+#include "common/ebml.h"
+#include "common/fs_sys_helpers.h"
+#include "common/kax_cluster_renderer.h"
+#include "common/kax_file.h"
+#include "common/mm_io_x.h"
+#include "common/mm_read_buffer_io.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string
+make_cluster(uint64_t timecode) {
+  auto data = mtxut::make_random_data(100);
+
+  kax_cluster_renderer_c renderer;
+  renderer.start(timecode);
+  renderer.add_simple_block(1, 0, true, false, memory_c{&data[0], data.size(), false});
+
+  mm_mem_io_c out{nullptr, 0, 1024};
+  renderer.finish(out);
+
+  return out.get_content();
+}
+
+void
+append(FILE *out,
+       std::string const &data) {
+  fwrite(data.c_str(), 1, data.size(), out);
+  fflush(out);
+}
+
+TEST(KaxFile, FollowsGrowingFile) {
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path()).string();
+  auto out       = fopen(file_name.c_str(), "wb");
+  ASSERT_NE(nullptr, out);
+
+  append(out, make_cluster(1000));
+
+  {
+    auto in = mm_io_cptr{new mm_read_buffer_io_c{new mm_file_io_c{file_name}}};
+    in->enable_following(500);
+
+    kax_file_c file{in};
+
+    auto cluster = std::shared_ptr<KaxCluster>(file.read_next_cluster());
+    ASSERT_NE(nullptr, cluster.get());
+    EXPECT_EQ(1000u, FindChildValue<KaxClusterTimecode>(cluster.get()));
+
+    // The next cluster arrives in two parts while the reader is
+    // already waiting for it.
+    auto second = make_cluster(2000);
+    std::thread writer{[out, &second]() {
+      sleep_millis(100);
+      append(out, second.substr(0, 10));
+      sleep_millis(100);
+      append(out, second.substr(10));
+    }};
+
+    cluster = std::shared_ptr<KaxCluster>(file.read_next_cluster());
+    writer.join();
+
+    ASSERT_NE(nullptr, cluster.get());
+    EXPECT_EQ(2000u, FindChildValue<KaxClusterTimecode>(cluster.get()));
+
+    // Nothing more is written; the end is reported after the timeout.
+    auto start = get_current_time_millis();
+    cluster    = std::shared_ptr<KaxCluster>(file.read_next_cluster());
+
+    EXPECT_EQ(nullptr, cluster.get());
+    EXPECT_LE(500, get_current_time_millis() - start);
+  }
+
+  fclose(out);
+  bfs::remove(file_name);
+}
+
+}
@@ -0,0 +1,70 @@
+#include "common/common_pch.h"
+
+#include "common/memory.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Memory, AllocWithHeadroom) {
+  auto mem = memory_c::alloc(5, 4);
+
+  EXPECT_EQ(5u, mem->get_size());
+  EXPECT_EQ(4u, mem->get_headroom());
+
+  mem->set_size(3);
+  EXPECT_EQ(3u, mem->get_size());
+  EXPECT_EQ(4u, mem->get_headroom());
+}
+
+TEST(Memory, PrependIntoHeadroom) {
+  auto mem = memory_c::alloc(5, 4);
+  memcpy(mem->get_buffer(), "Bacon", 5);
+  auto content = mem->get_buffer();
+
+  mem->prepend(reinterpret_cast<unsigned char const *>("\x00\x05"), 2);
+  ASSERT_EQ(7u, mem->get_size());
+  EXPECT_EQ(content - 2, mem->get_buffer());
+  EXPECT_EQ(2u, mem->get_headroom());
+  EXPECT_EQ(0, memcmp(mem->get_buffer(), "\x00\x05" "Bacon", 7));
+
+  mem->prepend(reinterpret_cast<unsigned char const *>("ab"), 2);
+  ASSERT_EQ(9u, mem->get_size());
+  EXPECT_EQ(content - 4, mem->get_buffer());
+  EXPECT_EQ(0u, mem->get_headroom());
+  EXPECT_EQ(0, memcmp(mem->get_buffer(), "ab\x00\x05" "Bacon", 9));
+}
+
+TEST(Memory, PrependWithoutHeadroom) {
+  auto mem = memory_c::clone("Bacon", 5);
+
+  mem->prepend(reinterpret_cast<unsigned char const *>("Crispy "), 7);
+  ASSERT_EQ(12u, mem->get_size());
+  EXPECT_EQ(0, memcmp(mem->get_buffer(), "Crispy Bacon", 12));
+
+  unsigned char borrowed[] = { 'e', 'g', 'g', 's' };
+  memory_c other(borrowed, 4, false);
+
+  other.prepend(reinterpret_cast<unsigned char const *>("ham & "), 6);
+  ASSERT_EQ(10u, other.get_size());
+  EXPECT_TRUE(other.is_free());
+  EXPECT_EQ(0, memcmp(other.get_buffer(), "ham & eggs", 10));
+  EXPECT_EQ(0, memcmp(borrowed, "eggs", 4));
+}
+
+TEST(Memory, PrependToSharedBuffer) {
+  auto mem = memory_c::alloc(5, 4);
+  memcpy(mem->get_buffer(), "Bacon", 5);
+  memory_c copy(*mem);
+
+  EXPECT_EQ(0u, mem->get_headroom());
+
+  mem->prepend(reinterpret_cast<unsigned char const *>("\x00\x05"), 2);
+  ASSERT_EQ(7u, mem->get_size());
+  EXPECT_EQ(0, memcmp(mem->get_buffer(), "\x00\x05" "Bacon", 7));
+
+  ASSERT_EQ(5u, copy.get_size());
+  EXPECT_EQ(0, memcmp(copy.get_buffer(), "Bacon", 5));
+}
+
+}
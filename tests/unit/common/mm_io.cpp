@@ -3,7 +3,10 @@
 #include "gtest/gtest.h"
 #include "tests/unit/util.h"
 
+#include "common/fs_sys_helpers.h"
 #include "common/mm_io_x.h"
+#include "common/mm_read_buffer_io.h"
+#include "common/mm_write_buffer_io.h"
 
 namespace {
 
@@ -16,4 +19,122 @@ TEST(MmIo, Slurp) {
   ASSERT_THROW(mm_file_io_c::slurp("doesnotexist"), mtx::mm_io::exception);
 }
 
+TEST(MmIo, StreamWriteTracksPositionAndRefusesSeeking) {
+  auto stream = tmpfile();
+  ASSERT_NE(nullptr, stream);
+
+  mm_stream_write_io_c out{stream, "tmp"};
+
+  EXPECT_EQ(0u, out.getFilePointer());
+  EXPECT_EQ(5u, out.write("Chunk", 5));
+  EXPECT_EQ(6u, out.write("y Baco", 6));
+  EXPECT_EQ(11u, out.getFilePointer());
+
+  EXPECT_NO_THROW(out.setFilePointer(11));
+  EXPECT_NO_THROW(out.setFilePointer(0, seek_current));
+  EXPECT_THROW(out.setFilePointer(4), mtx::mm_io::seek_x);
+  EXPECT_THROW(out.setFilePointer(0, seek_end), mtx::mm_io::seek_x);
+
+  unsigned char buffer[4];
+  EXPECT_THROW(out.read(buffer, 4), mtx::mm_io::exception);
+
+  out.write("n", 1);
+  out.flush();
+
+  std::string content(12, ' ');
+  rewind(stream);
+  ASSERT_EQ(12u, fread(&content[0], 1, 12, stream));
+  EXPECT_EQ(std::string{"Chunky Bacon"}, content);
+
+  fclose(stream);
+}
+
+TEST(MmIo, ReadBufferFollowsGrowingFile) {
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path()).string();
+  auto out       = fopen(file_name.c_str(), "wb");
+  ASSERT_NE(nullptr, out);
+
+  fwrite("Chunky ", 1, 7, out);
+  fflush(out);
+
+  {
+    mm_read_buffer_io_c in{new mm_file_io_c{file_name}, 4};
+    in.enable_following(200);
+
+    std::string buffer;
+    EXPECT_EQ(7u, in.read(buffer, 7));
+
+    fwrite("Bacon", 1, 5, out);
+    fflush(out);
+
+    EXPECT_EQ(5u, in.read(buffer, 5, 7));
+    EXPECT_EQ(std::string{"Chunky Bacon"}, buffer);
+    EXPECT_FALSE(in.eof());
+
+    auto start = get_current_time_millis();
+    EXPECT_EQ(0u, in.read(buffer, 1, 12));
+    EXPECT_LE(200, get_current_time_millis() - start);
+    EXPECT_TRUE(in.eof());
+  }
+
+  fclose(out);
+  bfs::remove(file_name);
+}
+
+TEST(MmIo, WriteBufferVectoredWrites) {
+  std::string expected, big(100, 'x');
+  mm_mem_io_c mem{nullptr, 0, 1024};
+
+  {
+    mm_write_buffer_io_c out{&mem, 16, false};
+
+    // Both pieces fit into the buffer.
+    EXPECT_EQ(9u, out.write_vectored({ { "Chunky", 6 }, { "Bac", 3 } }));
+    expected += "ChunkyBac";
+    EXPECT_EQ(0u, mem.getFilePointer());
+    EXPECT_EQ(9u, out.getFilePointer());
+
+    // The second piece bypasses the buffer.
+    EXPECT_EQ(102u, out.write_vectored({ { "on", 2 }, { big.c_str(), big.size() } }));
+    expected += "on" + big;
+    EXPECT_EQ(111u, mem.getFilePointer());
+    EXPECT_EQ(111u, out.getFilePointer());
+
+    out.write("!", 1);
+    EXPECT_EQ(103u, out.write_vectored({ { "[", 1 }, { big.c_str(), big.size() }, { "]", 1 }, { "", 0 }, { "\n", 1 } }));
+    expected += "!["  + big + "]\n";
+    EXPECT_EQ(215u, out.getFilePointer());
+  }
+
+  ASSERT_EQ(expected.size(), mem.getFilePointer());
+  EXPECT_EQ(expected, std::string(reinterpret_cast<char *>(mem.get_buffer()), expected.size()));
+}
+
+TEST(MmIo, FileVectoredWrites) {
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path()).string();
+  std::string big(200000, 'y'), expected;
+
+  {
+    mm_file_io_c out{file_name, MODE_CREATE};
+
+    out.write("Chunky ", 7);
+    EXPECT_EQ(9u, out.write_vectored({ { "Bac", 3 }, { "on ", 3 }, { "ok ", 3 }, { "", 0 } }));
+    EXPECT_EQ(200004u, out.write_vectored({ { "<", 1 }, { big.c_str(), big.size() }, { ">", 1 }, { "\n", 1 }, { "-", 1 } }));
+    EXPECT_EQ(200020u, out.getFilePointer());
+
+    out.write("end", 3);
+    EXPECT_EQ(200023u, out.getFilePointer());
+
+    out.setFilePointer(7);
+    out.write("b", 1);
+  }
+
+  expected = "Chunky bacon ok <" + big + ">\n-end";
+
+  auto content = mm_file_io_c::slurp(file_name);
+  EXPECT_EQ(*content, expected);
+
+  bfs::remove(file_name);
+}
+
 }
@@ -0,0 +1,174 @@
+#include "common/common_pch.h"
+
+#include "common/aac.h"
+#include "common/ac3.h"
+#include "common/dts.h"
+#include "common/endian.h"
+#include "common/mp3.h"
+#include "common/sync_word.h"
+#include "common/truehd.h"
+#include "tests/unit/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+int
+find_naive(std::vector<unsigned char> const &buffer,
+           size_t start,
+           unsigned int num_bytes,
+           uint32_t value,
+           uint32_t mask) {
+  for (auto pos = start; (pos + num_bytes) <= buffer.size(); ++pos) {
+    uint32_t word = 0;
+    for (auto idx = 0u; idx < num_bytes; ++idx)
+      word = (word << 8) | buffer[pos + idx];
+
+    if ((word & mask) == value)
+      return pos - start;
+  }
+
+  return -1;
+}
+
+void
+check_all_positions(std::vector<unsigned char> const &buffer,
+                    unsigned int num_bytes,
+                    uint32_t value,
+                    uint32_t mask) {
+  for (size_t start = 0; start < buffer.size(); start += 97) {
+    auto expected = find_naive(buffer, start, num_bytes, value, mask);
+    auto actual   = 2 == num_bytes ? mtx::sync_word::find_16(&buffer[start], buffer.size() - start, value, mask)
+                  :                  mtx::sync_word::find_32(&buffer[start], buffer.size() - start, value, mask);
+    ASSERT_EQ(expected, actual) << "start " << start;
+  }
+}
+
+TEST(SyncWord, Find16MatchesNaiveSearch) {
+  auto buffer = mtxut::make_random_data(64 * 1024);
+
+  check_all_positions(buffer, 2, AC3_SYNC_WORD, 0xffff); // AC3
+  check_all_positions(buffer, 2, 0xfff0,        0xfff6); // AAC ADTS
+  check_all_positions(buffer, 2, 0xffe0,        0xffe0); // MP3
+}
+
+TEST(SyncWord, Find32MatchesNaiveSearch) {
+  auto buffer = mtxut::make_random_data(256 * 1024);
+
+  // Plant a couple of sync words as random data rarely contains them.
+  for (auto pos : { 0u, 1000u, 77777u, 256u * 1024u - 4u })
+    put_uint32_be(&buffer[pos], DTS_HEADER_MAGIC);
+
+  for (auto pos : { 3u, 5002u, 100001u, 256u * 1024u - 9u })
+    put_uint32_be(&buffer[pos], TRUEHD_SYNC_WORD | (pos & 1));
+
+  check_all_positions(buffer, 4, DTS_HEADER_MAGIC, 0xffffffff);
+  check_all_positions(buffer, 4, TRUEHD_SYNC_WORD, 0xfffffffe);
+}
+
+TEST(SyncWord, SmallBuffers) {
+  unsigned char const buffer[] = { 0x0b, 0x77, 0x7f, 0xfe, 0x80, 0x01 };
+
+  EXPECT_EQ(-1, mtx::sync_word::find_16(buffer, 0, AC3_SYNC_WORD));
+  EXPECT_EQ(-1, mtx::sync_word::find_16(buffer, 1, AC3_SYNC_WORD));
+  EXPECT_EQ( 0, mtx::sync_word::find_16(buffer, 2, AC3_SYNC_WORD));
+  EXPECT_EQ(-1, mtx::sync_word::find_16(&buffer[1], 5, AC3_SYNC_WORD));
+
+  EXPECT_EQ(-1, mtx::sync_word::find_32(buffer, 5, DTS_HEADER_MAGIC));
+  EXPECT_EQ( 2, mtx::sync_word::find_32(buffer, 6, DTS_HEADER_MAGIC));
+  EXPECT_EQ(-1, mtx::sync_word::find_32(&buffer[3], 3, DTS_HEADER_MAGIC));
+}
+
+TEST(SyncWord, Mp3HeadersAndTags) {
+  auto buffer = mtxut::make_random_data(4096);
+
+  // Make sure the noise doesn't contain anything that looks like a
+  // header or a tag.
+  for (auto &byte : buffer)
+    if ((0xff == byte) || ('I' == byte) || ('T' == byte))
+      byte = 0;
+
+  EXPECT_EQ(-1, find_mp3_header(&buffer[0], buffer.size()));
+
+  // MPEG-1 layer III, 128 kbit/s, 44.1 kHz
+  put_uint32_be(&buffer[3000], 0xfffb9064);
+  EXPECT_EQ(3000, find_mp3_header(&buffer[0], buffer.size()));
+
+  memcpy(&buffer[2000], "TAG", 3);
+  EXPECT_EQ(2000, find_mp3_header(&buffer[0], buffer.size()));
+
+  memcpy(&buffer[1000], "ID3", 3);
+  EXPECT_EQ(1000, find_mp3_header(&buffer[0], buffer.size()));
+
+  // An ID3 tag header must be complete.
+  EXPECT_EQ(-1, find_mp3_header(&buffer[995], 12));
+}
+
+TEST(SyncWord, Mp3ConsecutiveHeaders) {
+  auto buffer = mtxut::make_random_data(8192);
+
+  for (auto &byte : buffer)
+    if ((0xff == byte) || ('I' == byte) || ('T' == byte))
+      byte = 0;
+
+  // A tag, a lone frame header that doesn't start a chain and five
+  // consecutive MPEG-1 layer III frames of 417 bytes each.
+  memcpy(&buffer[100], "TAG", 3);
+  put_uint32_be(&buffer[500], 0xfffb9064);
+  for (auto idx = 0u; idx < 5; ++idx)
+    put_uint32_be(&buffer[1000 + idx * 417], 0xfffb9064);
+
+  mp3_header_t header;
+  EXPECT_EQ( 500, find_consecutive_mp3_headers(&buffer[0], buffer.size(), 1, &header));
+  EXPECT_EQ( 417u, header.framesize);
+  EXPECT_EQ(1000, find_consecutive_mp3_headers(&buffer[0], buffer.size(), 5));
+  EXPECT_EQ(  -1, find_consecutive_mp3_headers(&buffer[0], buffer.size(), 6));
+}
+
+// Throughput benchmarks; run them with
+// "--gtest_also_run_disabled_tests --gtest_filter=SyncWord.DISABLED_*".
+
+TEST(SyncWord, DISABLED_ProbeThroughput) {
+  auto buffer = mtxut::make_random_data(32 * 1024 * 1024);
+  auto size   = buffer.size();
+  auto data   = &buffer[0];
+
+  // The plain searches must consume the whole buffer. Therefore the
+  // first bytes of their sync words must not occur at all.
+  auto no_sync = buffer;
+  for (auto &byte : no_sync)
+    if ((0x0b == byte) || (0x7f == byte))
+      byte = 0;
+
+  auto no_sync_data = &no_sync[0];
+
+  std::cout << "find_16 (AC3):              " << mtxut::megabytes_per_second(size, [=]() { EXPECT_EQ(-1, mtx::sync_word::find_16(no_sync_data, size, AC3_SYNC_WORD)); })    << " MB/s\n";
+  std::cout << "find_32 (DTS):              " << mtxut::megabytes_per_second(size, [=]() { EXPECT_EQ(-1, mtx::sync_word::find_32(no_sync_data, size, DTS_HEADER_MAGIC)); }) << " MB/s\n";
+  std::cout << "find_consecutive AC3:       " << mtxut::megabytes_per_second(size, [=]() { ac3::parser_c().find_consecutive_frames(data, size, 20); })     << " MB/s\n";
+  std::cout << "find_consecutive AAC:       " << mtxut::megabytes_per_second(size, [=]() { find_consecutive_aac_headers(data, size, 4); })                 << " MB/s\n";
+  std::cout << "find_consecutive MP3:       " << mtxut::megabytes_per_second(size, [=]() { find_consecutive_mp3_headers(data, size, 5); })                 << " MB/s\n";
+}
+
+TEST(SyncWord, DISABLED_ParseThroughput) {
+  auto buffer = mtxut::make_random_data(32 * 1024 * 1024);
+  auto size   = buffer.size();
+  auto data   = &buffer[0];
+
+  std::cout << "AC3 parser (resync):        " << mtxut::megabytes_per_second(size, [=]() {
+      ac3::parser_c parser;
+      for (size_t pos = 0; pos < size; pos += 64 * 1024)
+        parser.add_bytes(data + pos, std::min<size_t>(64 * 1024, size - pos));
+      parser.flush();
+    }) << " MB/s\n";
+
+  std::cout << "TrueHD parser (resync):     " << mtxut::megabytes_per_second(size, [=]() {
+      truehd_parser_c parser;
+      for (size_t pos = 0; pos < size; pos += 64 * 1024) {
+        parser.add_data(data + pos, std::min<size_t>(64 * 1024, size - pos));
+        parser.parse();
+      }
+      parser.parse(true);
+    }) << " MB/s\n";
+}
+
+}
@@ -0,0 +1,37 @@
+#include "common/common_pch.h"
+
+#include "common/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(ThreadPool, RunsAllTasks) {
+  thread_pool_c pool(4);
+
+  EXPECT_EQ(4u, pool.get_num_threads());
+
+  std::vector<std::future<int>> results;
+  for (auto idx = 0; idx < 100; ++idx)
+    results.push_back(pool.enqueue(std::function<int()>{[idx]() { return idx * 2; }}));
+
+  for (auto idx = 0; idx < 100; ++idx)
+    EXPECT_EQ(idx * 2, results[idx].get());
+}
+
+TEST(ThreadPool, PassesExceptionsOn) {
+  thread_pool_c pool(1);
+
+  auto result = pool.enqueue(std::function<int()>{[]() -> int { throw mtx::exception{}; }});
+
+  EXPECT_THROW(result.get(), mtx::exception);
+}
+
+TEST(ThreadPool, DefaultsToOneThreadPerCore) {
+  thread_pool_c pool;
+
+  EXPECT_EQ(thread_pool_c::get_num_cpu_cores(), pool.get_num_threads());
+  EXPECT_LE(1u, pool.get_num_threads());
+}
+
+}
@@ -0,0 +1,84 @@
+#include "common/common_pch.h"
+
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
+
+#include "merge/cues.h"
+#include "merge/output_control.h"
+
+#include "gtest/gtest.h"
+
+using namespace libmatroska;
+
+namespace {
+
+int64_t const s_timecode_scale = 1000000;
+
+// Values cover every width from one to eight bytes. Durations are
+// multiples of the timecode scale so that rounding doesn't matter.
+std::vector<cue_point_t> const s_points{
+  //  timecode                            duration                  cluster pos.      codec state  track       rel. pos.
+  {   0,                                  0,                        0,                0,           1,          0          },
+  {   255ull        * s_timecode_scale,   40    * s_timecode_scale, 255,              0,           2,          1          },
+  {   256ull        * s_timecode_scale,   256   * s_timecode_scale, 256,              48,          200,        255        },
+  {   70000ull      * s_timecode_scale,   0,                        1ull << 24,       0,           300,        256        },
+  {   (1ull << 24)  * s_timecode_scale,   70000 * s_timecode_scale, 1ull << 32,       1ull << 16,  70000,      1u << 24   },
+  {   (1ull << 32)  * s_timecode_scale,   2     * s_timecode_scale, 1ull << 40,       0,           3,          0          },
+  {   (1ull << 40)  * s_timecode_scale,   0,                        (1ull << 56) - 1, 1ull << 48,  4,          100000     },
+  {   (1ull << 44)  * s_timecode_scale,   0,                        1ull << 56,       0,           0xffffffff, 0xffffffff },
+};
+
+class cues_renderer_c: public cues_c {
+public:
+  std::string
+  render(cue_point_t const &point) {
+    auto size = calculate_point_size(point);
+    std::string buffer(size, '\0');
+
+    auto start = reinterpret_cast<unsigned char *>(&buffer[0]);
+    auto end   = render_point(start, point);
+    EXPECT_EQ(size, static_cast<uint64_t>(end - start));
+
+    return buffer;
+  }
+};
+
+std::string
+render_with_libmatroska(cue_point_t const &point) {
+  KaxCuePoint cue_point;
+  GetChild<KaxCueTime>(cue_point).SetValue(point.timecode / s_timecode_scale);
+
+  auto &positions = GetChild<KaxCueTrackPositions>(cue_point);
+  GetChild<KaxCueTrack>(positions).SetValue(point.track_num);
+  GetChild<KaxCueClusterPosition>(positions).SetValue(point.cluster_position);
+
+  if (point.codec_state_position)
+    GetChild<KaxCueCodecState>(positions).SetValue(point.codec_state_position);
+
+  if (point.relative_position)
+    GetChild<KaxCueRelativePosition>(positions).SetValue(point.relative_position);
+
+  if (point.duration)
+    GetChild<KaxCueDuration>(positions).SetValue(point.duration / s_timecode_scale);
+
+  mm_mem_io_c out{nullptr, 0, 1024};
+  cue_point.Render(out, false);
+
+  return out.get_content();
+}
+
+TEST(Cues, SameBytesAsLibmatroska) {
+  g_timecode_scale = s_timecode_scale;
+
+  cues_renderer_c cues;
+
+  for (auto idx = 0u; s_points.size() > idx; ++idx) {
+    auto expected = render_with_libmatroska(s_points[idx]);
+    auto actual   = cues.render(s_points[idx]);
+
+    EXPECT_EQ(expected.size(), actual.size()) << "cue point " << idx;
+    EXPECT_TRUE(expected == actual)           << "cue point " << idx;
+  }
+}
+
+}
@@ -1,6 +1,8 @@
 #include "common/common_pch.h"
 
+#include <chrono>
 #include <iostream>
+#include <random>
 
 #include <ebml/EbmlBinary.h>
 #include <ebml/EbmlDate.h>
@@ -66,6 +68,29 @@ dump(EbmlElement *element,
     dump(el, with_values, level + 1);
 }
 
+std::vector<unsigned char>
+make_random_data(size_t size,
+                 unsigned int num_values,
+                 unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::vector<unsigned char> data(size);
+
+  for (auto &byte : data)
+    byte = generator() % num_values;
+
+  return data;
+}
+
+double
+megabytes_per_second(uint64_t num_bytes,
+                     std::function<void()> const &worker) {
+  auto start = std::chrono::steady_clock::now();
+  worker();
+  auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  return num_bytes / (1024.0 * 1024.0) / std::max(duration, 0.000001);
+}
+
 //
 // ----------------------------------------------------------------------
 //
@@ -30,6 +30,13 @@ using namespace libebml;
 
 void dump(EbmlElement *element, bool with_values = false, unsigned int level = 0);
 
+// Reproducible pseudo-random bytes from the range [0, num_values).
+std::vector<unsigned char> make_random_data(size_t size, unsigned int num_values = 256, unsigned int seed = 42);
+
+// Runs 'worker' once and returns how many MB/s it processed if it
+// consumed 'num_bytes' bytes. Used by the disabled throughput tests.
+double megabytes_per_second(uint64_t num_bytes, std::function<void()> const &worker);
+
 ::testing::AssertionResult EbmlEquals(char const *a_expr, char const *b_expr, EbmlElement &a, EbmlElement &b);
 
 class ebml_equals_c {